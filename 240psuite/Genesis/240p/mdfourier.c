@@ -21,6 +21,7 @@
 
 #include "mdfourier.h"
 #include "segacdtests.h"
+#include "mdftrace.h"	// last, with MDF_TRACE it swaps the SGDK sound calls for its own
 
 u8 doZ80Lock = 0;
 
@@ -643,6 +644,7 @@ void MDFSequence(u16 framelen)
 	SendSCDCommand(Op_SeekCDMDF);
 #endif
 	
+	MDF_TRACE_START();
 	yminit();
 	PSG_init();
 	VDP_waitVSyncMDF();
@@ -691,6 +693,7 @@ void ExececuteMDF(u16 framelen)
 	SYS_enableInts();
 	
 	SilenceMDF();
+	MDF_TRACE_STOP();
 }
 
 void StartNote()
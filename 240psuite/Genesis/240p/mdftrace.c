@@ -0,0 +1,133 @@
+/* 
+ * 240p Test Suite
+ * Register write trace for the MDFourier sequence
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define MDF_TRACE_IMPL
+#include "mdftrace.h"
+#include "main.h"
+
+#ifdef MDF_TRACE
+
+mdf_trace_entry	mdf_trace[MDF_TRACE_SIZE];
+int				mdf_trace_count = 0;
+int				mdf_trace_lost = 0;
+u16				mdf_trace_frame = 0;
+static u8		mdf_trace_on = 0;
+
+void mdf_trace_start()
+{
+	mdf_trace_count = 0;
+	mdf_trace_lost = 0;
+	mdf_trace_frame = 0;
+	mdf_trace_on = 1;
+}
+
+void mdf_trace_stop()
+{
+	mdf_trace_on = 0;
+}
+
+void mdf_trace_write(u8 chip, u8 reg, u8 value)
+{
+	mdf_trace_entry *entry = NULL;
+
+	if(!mdf_trace_on)
+		return;
+	// keep the start, the sync pulses are there
+	if(mdf_trace_count == MDF_TRACE_SIZE)
+	{
+		mdf_trace_lost++;
+		return;
+	}
+	entry = &mdf_trace[mdf_trace_count++];
+	entry->frame = mdf_trace_frame;
+	entry->chip = chip;
+	entry->reg = reg;
+	entry->value = value;
+}
+
+void mdf_trace_YM2612_writeReg(const u16 part, const u8 reg, const u8 data)
+{
+	YM2612_writeReg(part, reg, data);
+	mdf_trace_write(part ? MDF_TRACE_YM2612_B : MDF_TRACE_YM2612, reg, data);
+}
+
+void mdf_trace_YM2612_disableDAC()
+{
+	YM2612_disableDAC();
+	mdf_trace_write(MDF_TRACE_YM2612, 0x2B, 0x00);
+}
+
+// The PSG bytes are the ones SGDK sends, so the trace plays back
+// with the same dividers the console got
+
+void mdf_trace_PSG_init()
+{
+	u8 i;
+
+	PSG_init();
+	for(i = 0; i < 4; i++)
+	{
+		mdf_trace_write(MDF_TRACE_PSG, 0, 0x80 | (i << 5));
+		mdf_trace_write(MDF_TRACE_PSG, 0, 0x00);
+		mdf_trace_write(MDF_TRACE_PSG, 0, 0x90 | (i << 5) | 0x0F);
+	}
+}
+
+void mdf_trace_PSG_setFrequency(u8 channel, u16 value)
+{
+	u16 data = 0;
+
+	PSG_setFrequency(channel, value);
+	if(value)
+		data = (IS_PALSYSTEM ? 3546893 : 3579545) / (value * 32);
+	mdf_trace_write(MDF_TRACE_PSG, 0, 0x80 | ((channel & 3) << 5) | (data & 0xF));
+	mdf_trace_write(MDF_TRACE_PSG, 0, (data >> 4) & 0x3F);
+}
+
+void mdf_trace_PSG_setEnvelope(u8 channel, u8 value)
+{
+	PSG_setEnvelope(channel, value);
+	mdf_trace_write(MDF_TRACE_PSG, 0, 0x90 | ((channel & 3) << 5) | (value & 0xF));
+}
+
+void mdf_trace_PSG_setNoise(u8 type, u8 frequency)
+{
+	PSG_setNoise(type, frequency);
+	mdf_trace_write(MDF_TRACE_PSG, 0, 0xE0 | type | frequency);
+}
+
+// StopPSG() is in main.c, which is built without the trace
+void mdf_trace_StopPSG()
+{
+	u8 i;
+
+	StopPSG();
+	for(i = 0; i < 4; i++)
+		mdf_trace_write(MDF_TRACE_PSG, 0, 0x90 | (i << 5) | (PSG_ENVELOPE_MIN & 0xF));
+}
+
+void mdf_trace_VDP_waitVSync()
+{
+	VDP_waitVSync();
+	mdf_trace_frame++;
+}
+
+#endif
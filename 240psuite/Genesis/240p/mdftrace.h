@@ -0,0 +1,97 @@
+/* 
+ * 240p Test Suite
+ * Register write trace for the MDFourier sequence
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MDFTRACE_H
+#define MDFTRACE_H
+
+#include "genesis.h"
+
+// Uncomment to keep every YM2612 and PSG write the MDFourier sequence
+// makes in RAM, with the number of vblanks waited before it. The SGDK
+// calls below are replaced here with ones that log the bytes that reach
+// the chips, so mdfourier.c stays as it is. Only mdfourier.c includes
+// this, the rest of the suite keeps the plain SGDK calls. tools/mdftrace
+// builds the sequence on a PC and saves the same trace as a VGM.
+
+//#define MDF_TRACE
+
+// chip numbers are the same in the X68000 trace
+#define MDF_TRACE_YM2612	0
+#define MDF_TRACE_YM2612_B	1	// part 1 registers
+#define MDF_TRACE_PSG		2	// reg is 0, value is the byte written
+#define MDF_TRACE_YM2151	3
+#define MDF_TRACE_MSM6258	4
+
+// about 3200 entries for the full sequence, 24KB of work RAM
+#ifndef MDF_TRACE_SIZE
+#define MDF_TRACE_SIZE		4096
+#endif
+
+typedef struct {
+	u16 frame;
+	u8	chip;
+	u8	reg;
+	u8	value;
+	u8	pad;
+} mdf_trace_entry;
+
+#ifdef MDF_TRACE
+
+extern mdf_trace_entry	mdf_trace[MDF_TRACE_SIZE];
+extern int				mdf_trace_count;
+extern int				mdf_trace_lost;
+extern u16				mdf_trace_frame;
+
+void mdf_trace_start();
+void mdf_trace_stop();
+void mdf_trace_write(u8 chip, u8 reg, u8 value);
+
+void mdf_trace_YM2612_writeReg(const u16 part, const u8 reg, const u8 data);
+void mdf_trace_YM2612_disableDAC();
+void mdf_trace_PSG_init();
+void mdf_trace_PSG_setFrequency(u8 channel, u16 value);
+void mdf_trace_PSG_setEnvelope(u8 channel, u8 value);
+void mdf_trace_PSG_setNoise(u8 type, u8 frequency);
+void mdf_trace_StopPSG();
+void mdf_trace_VDP_waitVSync();
+
+#define MDF_TRACE_START()	mdf_trace_start()
+#define MDF_TRACE_STOP()	mdf_trace_stop()
+
+#ifndef MDF_TRACE_IMPL
+#define YM2612_writeReg(part, reg, data)	mdf_trace_YM2612_writeReg(part, reg, data)
+#define YM2612_disableDAC()					mdf_trace_YM2612_disableDAC()
+#define PSG_init()							mdf_trace_PSG_init()
+#define PSG_setFrequency(channel, value)	mdf_trace_PSG_setFrequency(channel, value)
+#define PSG_setEnvelope(channel, value)		mdf_trace_PSG_setEnvelope(channel, value)
+#define PSG_setNoise(type, frequency)		mdf_trace_PSG_setNoise(type, frequency)
+#define StopPSG()							mdf_trace_StopPSG()
+#define VDP_waitVSync()						mdf_trace_VDP_waitVSync()
+#endif
+
+#else
+
+#define MDF_TRACE_START()
+#define MDF_TRACE_STOP()
+
+#endif
+
+#endif
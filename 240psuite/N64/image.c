@@ -271,6 +271,7 @@ image *loadImage(char *name) {
 	dfs_close(fh);
 #endif
 
+	fbPoolMakeRoom();
 	data = (image*)malloc(sizeof(image));
 	if(!data)
 		return NULL;
@@ -328,6 +329,111 @@ void freeImage(image **data) {
 	*data = NULL;
 }
 
+/* Frame Buffer pool */
+
+// Surfaces for the menu and upscaler are kept resident and handed out
+// by (format, width, height), so toggling 480 modes or opening the menu
+// doesn't go through surface_alloc and fragment RDRAM every time
+
+#define FB_POOL_SIZE	4
+
+typedef struct fbpool_st {
+	surface_t surface;
+	int inUse;
+} fbpool_entry;
+
+fbpool_entry fbPool[FB_POOL_SIZE];
+unsigned int fbPoolBytes = 0;
+unsigned int fbPoolPeak = 0;
+
+static void fbPoolFreeEntry(fbpool_entry *entry) {
+	if(!entry->surface.buffer)
+		return;
+	
+	fbPoolBytes -= entry->surface.stride * entry->surface.height;
+	surface_free(&entry->surface);
+	memset(&entry->surface, 0, sizeof(surface_t));
+	entry->inUse = 0;
+}
+
+surface_t *fbPoolGet(tex_format_t format, int width, int height) {
+	fbpool_entry *empty = NULL, *idle = NULL;
+	
+	for(unsigned int i = 0; i < FB_POOL_SIZE; i++) {
+		fbpool_entry *entry = &fbPool[i];
+		
+		if(!entry->surface.buffer) {
+			if(!empty)
+				empty = entry;
+			continue;
+		}
+		if(entry->inUse)
+			continue;
+		if(surface_get_format(&entry->surface) == format &&
+			entry->surface.width == width && entry->surface.height == height) {
+			entry->inUse = 1;
+			return &entry->surface;
+		}
+		if(!idle)
+			idle = entry;
+	}
+	
+	// Pool is full, evict an idle surface from another resolution
+	if(!empty && idle) {
+		fbPoolFreeEntry(idle);
+		empty = idle;
+	}
+	if(!empty)
+		return NULL;
+	
+	empty->surface = surface_alloc(format, width, height);
+	if(!empty->surface.buffer) {
+		fbPoolTrim();
+		empty->surface = surface_alloc(format, width, height);
+		if(!empty->surface.buffer) {
+			memset(&empty->surface, 0, sizeof(surface_t));
+			return NULL;
+		}
+	}
+	
+	empty->inUse = 1;
+	fbPoolBytes += empty->surface.stride * empty->surface.height;
+	if(fbPoolBytes > fbPoolPeak)
+		fbPoolPeak = fbPoolBytes;
+	return &empty->surface;
+}
+
+void fbPoolRelease(surface_t *surface) {
+	for(unsigned int i = 0; i < FB_POOL_SIZE; i++) {
+		if(&fbPool[i].surface == surface) {
+			fbPool[i].inUse = 0;
+			return;
+		}
+	}
+}
+
+void fbPoolTrim() {
+	for(unsigned int i = 0; i < FB_POOL_SIZE; i++) {
+		if(!fbPool[i].inUse)
+			fbPoolFreeEntry(&fbPool[i]);
+	}
+}
+
+// 4MB systems can't keep idle surfaces around while sprites, models
+// and fonts are loaded outside the pool, 8MB ones keep them resident
+void fbPoolMakeRoom() {
+	if((get_memory_size() / 0x100000) < 8)
+		fbPoolTrim();
+}
+
+unsigned int fbPoolGetUsedRAM() {
+	return fbPoolBytes;
+}
+
+unsigned int fbPoolGetPeakRAM() {
+	return fbPoolPeak;
+}
+
 /* Frame Buffer for menu */
 
 surface_t *__menu_fb = NULL;
@@ -343,25 +449,16 @@ int copyMenuFB() {
 		return 0;
 	
 	// only allow 480i in 8MB expanded systems
-	// reason is: although it works, it ends up leading to memory
-	// fragmentation even if allocated from boot since constant
-	// resolution changes deallocate and reallocate libDragon's
+	// reason is: although it works, a resident 640x480 surface
+	// is too much for the 4MB systems with libDragon's 
 	// framebuffers (safe buffer)
 	
 	if(getDispHeight() > 288 && (get_memory_size() / 0x100000) < 8)
 		return 0;
 
-	__menu_fb = (surface_t *)malloc(sizeof(surface_t));
+	__menu_fb = fbPoolGet(surface_get_format(__disp), __disp->width, __disp->height);
 	if(!__menu_fb)
 		return 0;
-	memset(__menu_fb, 0, sizeof(surface_t));
-		
-	*__menu_fb = surface_alloc(surface_get_format(__disp), __disp->width, __disp->height);
-	if(!__menu_fb->buffer) {
-		free(__menu_fb);
-		__menu_fb = NULL;
-		return 0;
-	}
 	
 	rdpq_attach(__menu_fb, NULL);
 	rdpqSetDrawMode(0);
@@ -376,9 +473,9 @@ int copyMenuFB() {
 
 void freeMenuFB() {
 	if(__menu_fb) {
-		surface_free(__menu_fb);
-		free(__menu_fb);
+		fbPoolRelease(__menu_fb);
 		__menu_fb = NULL;
+		fbPoolMakeRoom();
 	}
 
 	if(menuIgnoreUpscale)
@@ -408,58 +505,18 @@ void darkenMenuFB(int amount) {
 	if(!__menu_fb)
 		return;
 	
-	if(surface_get_format(__menu_fb) == FMT_RGBA16) {
-		uint16_t *pixels = (uint16_t*)__menu_fb->buffer;
-		unsigned int len = TEX_FORMAT_PIX2BYTES(surface_get_format(__menu_fb), __menu_fb->width * __menu_fb->height)/2;
-
-		for(unsigned int i = 0; i < len; i++) {
-			color_t color;
-				
-			color = color_from_packed16(pixels[i]);
-			
-			if(color.r > amount)
-				color.r -= amount;
-			else
-				color.r = 0;
-			if(color.g > amount)
-				color.g -= amount;
-			else
-				color.g = 0;
-			if(color.b > amount)
-				color.b -= amount;
-			else
-				color.b = 0;
-		
-			pixels[i] = graphics_convert_color(color);
-		}
-
-	}
-	
-	if(surface_get_format(__menu_fb) == FMT_RGBA32) {
-		uint32_t *pixels = (uint32_t *)__menu_fb->buffer;
-		unsigned int len = TEX_FORMAT_PIX2BYTES(surface_get_format(__menu_fb), __menu_fb->width * __menu_fb->height)/4;
-
-		for(unsigned int i = 0; i < len; i++) {
-			color_t color;
-				
-			color = color_from_packed32(pixels[i]);
-
-			if(color.r > amount)
-				color.r -= amount;
-			else
-				color.r = 0;
-			if(color.g > amount)
-				color.g -= amount;
-			else
-				color.g = 0;
-			if(color.b > amount)
-				color.b -= amount;
-			else
-				color.b = 0;
-
-			pixels[i] = graphics_convert_color(color);
-		}
-	}
+	// Subtract amount from each channel on the RDP, the combiner clamps
+	// negative results to zero. The blit is done in place since every
+	// TMEM slice is loaded before its own lines are written back.
+	rdpq_attach(__menu_fb, NULL);
+	rdpq_set_mode_standard();
+	rdpq_mode_dithering(DITHER_NONE_NONE);
+	rdpq_mode_filter(FILTER_POINT);
+	rdpq_mode_combiner(RDPQ_COMBINER1((TEX0, PRIM, ENV, ZERO), (ZERO, ZERO, ZERO, ONE)));
+	rdpq_set_prim_color(RGBA32(amount, amount, amount, 0xff));
+	rdpq_set_env_color(RGBA32(0xff, 0xff, 0xff, 0xff));
+	rdpq_tex_blit(__menu_fb, 0, 0, NULL);
+	rdpq_detach();
 }
 
 int hasMenuFB() {
@@ -482,25 +539,16 @@ int createUpscaleFB() {
 	if(__upscale_fb || !__disp)
 		return 0;
 	
-	__upscale_fb = (surface_t *)malloc(sizeof(surface_t));
+	__upscale_fb = fbPoolGet(surface_get_format(__disp), __disp->width/2, __disp->height/2);
 	if(!__upscale_fb)
 		return 0;
-	memset(__upscale_fb, 0, sizeof(surface_t));
-
-	*__upscale_fb = surface_alloc(surface_get_format(__disp), __disp->width/2, __disp->height/2);
-	if(!__upscale_fb->buffer) {
-		free(__upscale_fb);
-		__upscale_fb = NULL;
-		return 0;
-	}
 	
 	return 1;
 }
 
 void freeUpscaleFB() {
 	if(__upscale_fb) {
-		surface_free(__upscale_fb);
-		free(__upscale_fb);
+		fbPoolRelease(__upscale_fb);
 		__upscale_fb = NULL;
 	}
 	
@@ -99,6 +99,15 @@ void rdpqDrawRectangle(int tx, int ty, int bx, int by, int r, int g, int b);
 image *loadImage(char *name);
 void freeImage(image **data);
 
+/* Frame Buffer pool functions */
+
+surface_t *fbPoolGet(tex_format_t format, int width, int height);
+void fbPoolRelease(surface_t *surface);
+void fbPoolTrim();
+void fbPoolMakeRoom();
+unsigned int fbPoolGetUsedRAM();
+unsigned int fbPoolGetPeakRAM();
+
 /* Menu Frame Buffer functions */
 
 int copyMenuFB();
@@ -34,6 +34,8 @@
 #include "menu.h"
 #include "controller.h"
 #include "video.h"
+#include "image.h"
+#include "mcs.h"
 
 #define AMBIENT		135
 #define BGCOLOR		0xee
@@ -54,7 +56,7 @@
 #define FONT_B	0xFF
 
 typedef struct scenaData_st {
-	surface_t depthBuffer;
+	surface_t *depthBuffer;
 	T3DViewport viewport;
 	T3DMat4 modelMat;			// matrix for our model, this is a "normal" float matrix
 	T3DMat4FP* modelMatFP;
@@ -71,39 +73,169 @@ typedef struct scenaData_st {
 	float rotAngle;
 } SceneData;
 
-void freeSceneData(SceneData *scene) {
-	if(scene->depthBuffer.buffer)
-		surface_free(&scene->depthBuffer);
+/* Shared resources, kept resident while referenced */
+
+#define MCS_RES_MODEL		0
+#define MCS_RES_FONT_REGULAR	1
+#define MCS_RES_FONT_SMALL	2
+#define MCS_RES_DEPTH		3
+#define MCS_RES_LOADED		4
+
+typedef struct mcsResources_st {
+	T3DModel *modelMCS;
+	rdpq_font_t *fontRegular; 
+	rdpq_font_t *fontSmall; 
+	surface_t *depthBuffer;
+	int refCount;
+	int nextLoad;
+	int prefetchRef;
+} MCSResources;
+
+MCSResources mcsRes = { NULL, NULL, NULL, NULL, 0, MCS_RES_MODEL, 0 };
+
+void freeMCSResources() {
+	if(mcsRes.depthBuffer) {
+		fbPoolRelease(mcsRes.depthBuffer);
+		mcsRes.depthBuffer = NULL;
+	}
+	
+	if(mcsRes.modelMCS) {
+		t3d_model_free(mcsRes.modelMCS);
+		mcsRes.modelMCS = NULL;
+	}
+	
+	if(mcsRes.fontRegular) {
+		rdpq_text_unregister_font(MCS_FONT_REGULAR);
+		rdpq_font_free(mcsRes.fontRegular);
+		mcsRes.fontRegular = NULL;
+	}
+	
+	if(mcsRes.fontSmall) {
+		rdpq_text_unregister_font(MCS_FONT_SMALL);
+		rdpq_font_free(mcsRes.fontSmall);
+		mcsRes.fontSmall = NULL;
+	}
 	
+	mcsRes.nextLoad = MCS_RES_MODEL;
+}
+
+// Loads a single pending resource per call, so callers can spread the
+// ROM reads across frames. Returns 1 while there is more to load, 0 when 
+// everything is resident and -1 on failure
+int loadMCSResourceStep() {
+	switch(mcsRes.nextLoad) {
+		case MCS_RES_MODEL:
+			fbPoolMakeRoom();
+			// Load a model-file, this contains the geometry and some metadata
+			mcsRes.modelMCS = t3d_model_load("rom:/mcs.t3dm");
+			if(!mcsRes.modelMCS)
+				return -1;
+			break;
+		case MCS_RES_FONT_REGULAR:
+			mcsRes.fontRegular = rdpq_font_load("rom:/BebasNeue-Regular.font64");
+			if(!mcsRes.fontRegular)
+				return -1;
+			rdpq_text_register_font(MCS_FONT_REGULAR, mcsRes.fontRegular);
+			break;
+		case MCS_RES_FONT_SMALL:
+			mcsRes.fontSmall = rdpq_font_load("rom:/BebasNeue-Small.font64");
+			if(!mcsRes.fontSmall)
+				return -1;
+			rdpq_text_register_font(MCS_FONT_SMALL, mcsRes.fontSmall);
+			break;
+		case MCS_RES_DEPTH:
+			// Resolution might have changed since it was loaded
+			if(mcsRes.depthBuffer && 
+				(mcsRes.depthBuffer->width != getHardWidth() ||
+				mcsRes.depthBuffer->height != getHardHeight())) {
+				fbPoolRelease(mcsRes.depthBuffer);
+				mcsRes.depthBuffer = NULL;
+			}
+			if(!mcsRes.depthBuffer)
+				mcsRes.depthBuffer = fbPoolGet(FMT_RGBA16, getHardWidth(), getHardHeight());
+			if(!mcsRes.depthBuffer)
+				return -1;
+			break;
+		case MCS_RES_LOADED:
+		default:
+			return 0;
+	}
+	
+	mcsRes.nextLoad++;
+	return mcsRes.nextLoad == MCS_RES_LOADED ? 0 : 1;
+}
+
+int acquireMCSResources() {
+	int status = 0;
+	
+	mcsRes.refCount++;
+	
+	// Always check the depth buffer against the current resolution
+	if(mcsRes.nextLoad == MCS_RES_LOADED)
+		mcsRes.nextLoad = MCS_RES_DEPTH;
+	
+	do {
+		status = loadMCSResourceStep();
+	} while(status > 0);
+	
+	if(status < 0) {
+		releaseMCSResources();
+		return 0;
+	}
+	return 1;
+}
+
+void releaseMCSResources() {
+	if(mcsRes.refCount <= 0)
+		return;
+	
+	mcsRes.refCount--;
+	if(!mcsRes.refCount)
+		freeMCSResources();
+}
+
+void prefetchMCSScreen() {
+	if(!mcsRes.prefetchRef) {
+		mcsRes.prefetchRef = 1;
+		mcsRes.refCount++;
+	}
+	
+	if(loadMCSResourceStep() < 0)
+		releaseMCSPrefetch();
+}
+
+void releaseMCSPrefetch() {
+	if(mcsRes.prefetchRef) {
+		mcsRes.prefetchRef = 0;
+		releaseMCSResources();
+	}
+}
+
+void freeSceneData(SceneData *scene) {
 	if(scene->modelMatFP) {
 		free_uncached(scene->modelMatFP);
 		scene->modelMatFP = NULL;
 	}
 	
 	if(scene->modelMCS) {
-		t3d_model_free(scene->modelMCS);
 		scene->modelMCS = NULL;
-	}
-	
-	if(scene->fontRegular) {
-		rdpq_text_unregister_font(MCS_FONT_REGULAR);
-		rdpq_font_free(scene->fontRegular);
 		scene->fontRegular = NULL;
-	}
-	
-	if(scene->fontSmall) {
-		rdpq_text_unregister_font(MCS_FONT_SMALL);
-		rdpq_font_free(scene->fontSmall);
 		scene->fontSmall = NULL;
+		scene->depthBuffer = NULL;
+		releaseMCSResources();
 	}
 }
 
 int load3DScene(SceneData *scene, int controls) {
 	memset(scene, 0, sizeof(SceneData));
 	
-	scene->depthBuffer = surface_alloc(FMT_RGBA16, getHardWidth(), getHardHeight());
-	if(!scene->depthBuffer.buffer)
+	if(!acquireMCSResources())
 		return 0;
+	
+	scene->modelMCS = mcsRes.modelMCS;
+	scene->fontRegular = mcsRes.fontRegular;
+	scene->fontSmall = mcsRes.fontSmall;
+	scene->depthBuffer = mcsRes.depthBuffer;
 
 	scene->viewport = t3d_viewport_create();
 
@@ -141,34 +273,11 @@ int load3DScene(SceneData *scene, int controls) {
 	
 	t3d_vec3_norm(&scene->lightDirVec);
 
-	// Load a model-file, this contains the geometry and some metadata
-	scene->modelMCS = t3d_model_load("rom:/mcs.t3dm");
-	if(!scene->modelMCS) {
-		freeSceneData(scene);
-		return 0;
-	}
-	
-	scene->fontRegular = rdpq_font_load("rom:/BebasNeue-Regular.font64");
-	if(!scene->fontRegular) {
-		freeSceneData(scene);
-		return 0;
-	}
-
-	rdpq_text_register_font(MCS_FONT_REGULAR, scene->fontRegular);
-	
-	scene->fontSmall = rdpq_font_load("rom:/BebasNeue-Small.font64");
-	if(!scene->fontSmall) {
-		freeSceneData(scene);
-		return 0;
-	}
-	
 	scene->colorFont[0] = FONT_R;
 	scene->colorFont[1] = FONT_G;
 	scene->colorFont[2] = FONT_B;
 	scene->colorFont[3] = 0;
 	
-    rdpq_text_register_font(MCS_FONT_SMALL, scene->fontSmall);
-	
 	rdpq_font_style(scene->fontRegular, 0, &(rdpq_fontstyle_t){
         .color = RGBA32(scene->colorFont[0], scene->colorFont[1], scene->colorFont[2], scene->colorFont[3]),
     });
@@ -254,7 +363,7 @@ int draw3DScene(SceneData *scene, int frames, int type, int controls) {
 
 		display = display_get();
 		// ======== Draw ======== //
-		rdpq_attach(display, &scene->depthBuffer);
+		rdpq_attach(display, scene->depthBuffer);
 		t3d_frame_start();
 		t3d_viewport_attach(&scene->viewport);
 
@@ -271,7 +380,7 @@ int draw3DScene(SceneData *scene, int frames, int type, int controls) {
 		
 		if(!controls) {
 			rdpq_detach_wait();
-			rdpq_attach(display, &scene->depthBuffer);
+			rdpq_attach(display, scene->depthBuffer);
 			rdpq_font_style(scene->fontRegular, 0, &(rdpq_fontstyle_t){
 				.color = RGBA32(scene->colorFont[0], scene->colorFont[1], scene->colorFont[2], scene->colorFont[3]),
 			});
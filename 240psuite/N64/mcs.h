@@ -24,4 +24,10 @@
 
 int drawMCSScreen(int frames, int controls);
 
+/* Shared 3D scene resources */
+int acquireMCSResources();
+void releaseMCSResources();
+void prefetchMCSScreen();
+void releaseMCSPrefetch();
+
 #endif
\ No newline at end of file
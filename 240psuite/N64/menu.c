@@ -318,6 +318,9 @@ void drawCredits(int usebuffer) {
 		drawStringS(208, y, 0x0f, 0xff, 0xff, VERSION_DATE); y += 2*fh;
 
 		waitVsync();
+		
+		// Load the 3D scene one asset per frame, so C-Up has no stall
+		prefetchMCSScreen();
 
 		joypad_poll();
 		keys = controllerButtonsDown();
@@ -368,6 +371,7 @@ void drawCredits(int usebuffer) {
 	
 	freeImage(&back);
 	freeImage(&qr);
+	releaseMCSPrefetch();
 	
 	if(!hasMenuFB())
 		setClearScreen();
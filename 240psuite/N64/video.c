@@ -95,6 +95,9 @@ void drawFrameLens() {
 	
 	sprintf(str, "RAM: %dKB/%dKB", (getUsedRAM() / 1024), get_memory_size() / 1024);
 	drawStringB(10, 15, 0xff, 0xff, 0xff, str);
+	
+	sprintf(str, "FB Pool: %uKB Peak: %uKB", fbPoolGetUsedRAM() / 1024, fbPoolGetPeakRAM() / 1024);
+	drawStringB(10, 26, 0xff, 0xff, 0xff, str);
 }
 #endif
 
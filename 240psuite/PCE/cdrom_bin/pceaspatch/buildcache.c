@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "defs.h"
+#include "externs.h"
+#include "protos.h"
+#include "htab.h"
+#include "buildcache.h"
+
+/* Build cache, -cache switch.
+ *
+ * Every file the assembly reads through open_file() in input.c, the
+ * sources as well as binaries and pictures, is noted with its size,
+ * date and a 64 bit FNV-1a of its contents, next to the command line,
+ * PCE_INCLUDE and the outputs written. The list is kept in
+ * <output>.pcache. On the next run build_cache_check() looks at it
+ * before the first pass: if the outputs are still there as written and
+ * every input has the same contents, assembling again would produce the
+ * same bytes and pceas stops there. An input with a new date is hashed
+ * again, so touching a file without changing it keeps the cache valid.
+ *
+ * Banks are not reassembled one by one: any bank can use labels from
+ * any other, and their values are only known after all the passes.
+ *
+ * Hooks: main.c calls build_cache_check() after the options and
+ * build_cache_output()/build_cache_save() after writing, open_file()
+ * in input.c calls build_cache_note() for every file it opens.
+ */
+
+#define CACHE_MAGIC "pceas-cache 1"
+
+struct t_cache_file {
+	char name[256];
+	long size;
+	long mtime;
+	unsigned long long hash;
+};
+
+int build_cache_opt;
+
+static struct t_htab cache_htab;		/* inputs of this run */
+static struct t_cache_file **cache_outputs;
+static int cache_outputs_nb;
+static char cache_path[260];
+static unsigned long long cache_cmd;
+static long cache_time;				/* when the list was written */
+static int cache_noting;			/* inputs are noted once the check is done */
+
+
+/* ----
+ * cache_hash_file()
+ * ----
+ * 64 bit FNV-1a of a file, returns 0 if it can not be read
+ */
+
+static int
+cache_hash_file(FILE *fp, unsigned long long *hash)
+{
+	unsigned char buffer[4096];
+	size_t len, i;
+
+	*hash = 14695981039346656037ULL;
+	while ((len = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+		for (i = 0; i < len; i++)
+			*hash = (*hash ^ buffer[i]) * 1099511628211ULL;
+	}
+	return (!ferror(fp));
+}
+
+static unsigned long long
+cache_hash_str(unsigned long long hash, const char *str)
+{
+	while (*str)
+		hash = (hash ^ (unsigned char)*str++) * 1099511628211ULL;
+	return ((hash ^ 0xFF) * 1099511628211ULL);
+}
+
+
+/* ----
+ * cache_stat()
+ * ----
+ * fill in size, date and hash; with old set the hash is only computed
+ * again when the date or size differ from it, or when the file was
+ * written in the same second as the list (a change could hide there)
+ */
+
+static int
+cache_stat(FILE *fp, struct t_cache_file *file, struct t_cache_file *old)
+{
+	struct stat st;
+
+	if (fstat(fileno(fp), &st))
+		return (0);
+	file->size = (long)st.st_size;
+	file->mtime = (long)st.st_mtime;
+	if (old && (old->size == file->size) && (old->mtime == file->mtime) &&
+	   (old->mtime < cache_time)) {
+		file->hash = old->hash;
+		return (1);
+	}
+	return (cache_hash_file(fp, &file->hash));
+}
+
+static int
+cache_match(void *item, const void *key)
+{
+	return (strcmp(((struct t_cache_file *)item)->name, key) == 0);
+}
+
+
+/* ----
+ * build_cache_check()
+ * ----
+ * returns 1 when the outputs from the last run are still valid
+ */
+
+int
+build_cache_check(int argc, char **argv, char *out_name)
+{
+	struct t_cache_file file, old;
+	char line[600];
+	char *env;
+	FILE *fp, *in;
+	int ok = 0;
+	int i;
+
+	if (!build_cache_opt)
+		return (0);
+
+	/* the command line and include path decide what the sources mean */
+	cache_cmd = 14695981039346656037ULL;
+	for (i = 1; i < argc; i++)
+		cache_cmd = cache_hash_str(cache_cmd, argv[i]);
+	env = getenv("PCE_INCLUDE");
+	cache_cmd = cache_hash_str(cache_cmd, env ? env : "");
+
+	snprintf(cache_path, sizeof(cache_path), "%s.pcache", out_name);
+	if ((fp = fopen(cache_path, "r")) == NULL) {
+		cache_noting = 1;
+		return (0);
+	}
+
+	/* header */
+	if (!fgets(line, sizeof(line), fp) || strncmp(line, CACHE_MAGIC, strlen(CACHE_MAGIC)))
+		goto done;
+	if (!fgets(line, sizeof(line), fp) || strncmp(line, "cmd ", 4))
+		goto done;
+	if ((strtoull(line + 4, &env, 16) != cache_cmd) || (sscanf(env, "%ld", &cache_time) != 1))
+		goto done;
+
+	/* every input and output as recorded */
+	while (fgets(line, sizeof(line), fp)) {
+		int is_input = !strncmp(line, "in ", 3);
+		int skip = is_input ? 3 : 4;
+		int n = 0;
+
+		if (!is_input && strncmp(line, "out ", 4))
+			goto done;
+		line[strcspn(line, "\r\n")] = '\0';
+		if (sscanf(line + skip, "%ld %ld %llx %n", &old.size, &old.mtime, &old.hash, &n) < 3 || (n == 0))
+			goto done;
+		strncpy(old.name, line + skip + n, sizeof(old.name) - 1);
+		old.name[sizeof(old.name) - 1] = '\0';
+
+		/* inputs are searched in the include path again, outputs are where they were written */
+		in = is_input ? open_file(old.name, "rb") : fopen(old.name, "rb");
+		if (in == NULL)
+			goto done;
+		i = cache_stat(in, &file, &old);
+		fclose(in);
+		if (!i || (file.size != old.size) || (file.hash != old.hash))
+			goto done;
+	}
+	ok = 1;
+
+done:
+	fclose(fp);
+	if (ok)
+		printf("%s: no input changed since the last build, outputs kept\n", out_name);
+	else
+		cache_noting = 1;
+	return (ok);
+}
+
+
+/* ----
+ * build_cache_note()
+ * ----
+ * an input file, by the name the source uses for it; path is where
+ * open_file() found it. The check opens the recorded inputs through
+ * open_file() as well, those are not noted
+ */
+
+void
+build_cache_note(char *name, char *path)
+{
+	struct t_cache_file *file;
+	unsigned int hash;
+	FILE *fp;
+
+	if (!build_cache_opt || !cache_noting)
+		return;
+
+	/* each file once, it is read in every pass */
+	hash = htab_hash_str(name);
+	if (htab_find(&cache_htab, hash, cache_match, name))
+		return;
+
+	if ((file = (void *)calloc(1, sizeof(struct t_cache_file))) == NULL)
+		return;
+	strncpy(file->name, name, sizeof(file->name) - 1);
+	if (!htab_insert(&cache_htab, hash, file)) {
+		free(file);
+		return;
+	}
+
+	/* binary mode whatever the caller opened it with, as the check does */
+	if ((fp = fopen(path, "rb")) != NULL) {
+		cache_stat(fp, file, NULL);
+		fclose(fp);
+	}
+}
+
+
+/* ----
+ * build_cache_output()
+ * ----
+ * a file written by this run
+ */
+
+void
+build_cache_output(char *path)
+{
+	struct t_cache_file *file;
+	struct t_cache_file **list;
+	FILE *fp;
+
+	if (!build_cache_opt)
+		return;
+	if ((fp = fopen(path, "rb")) == NULL)
+		return;
+	if ((file = (void *)calloc(1, sizeof(struct t_cache_file))) == NULL) {
+		fclose(fp);
+		return;
+	}
+	strncpy(file->name, path, sizeof(file->name) - 1);
+	cache_stat(fp, file, NULL);
+	fclose(fp);
+
+	list = realloc(cache_outputs, sizeof(struct t_cache_file *) * (cache_outputs_nb + 1));
+	if (list == NULL) {
+		free(file);
+		return;
+	}
+	cache_outputs = list;
+	cache_outputs[cache_outputs_nb++] = file;
+}
+
+
+/* ----
+ * build_cache_save()
+ * ----
+ * after a successful assembly; nothing is kept after errors or if no
+ * input was noted, a cache that doesn't know the sources is useless
+ */
+
+void
+build_cache_save(void)
+{
+	struct t_cache_file *file;
+	FILE *fp;
+	int i;
+
+	if (!build_cache_opt || cache_path[0] == '\0')
+		return;
+
+	if (errcnt || (cache_htab.count == 0) || (cache_outputs_nb == 0)) {
+		remove(cache_path);
+		return;
+	}
+	if ((fp = fopen(cache_path, "w")) == NULL)
+		return;
+
+	fprintf(fp, "%s\ncmd %016llx %ld\n", CACHE_MAGIC, cache_cmd, (long)time(NULL));
+	for (i = 0; i < cache_htab.size; i++) {
+		if ((file = cache_htab.item[i]) != NULL)
+			fprintf(fp, "in %ld %ld %016llx %s\n", file->size, file->mtime, file->hash, file->name);
+	}
+	for (i = 0; i < cache_outputs_nb; i++) {
+		file = cache_outputs[i];
+		fprintf(fp, "out %ld %ld %016llx %s\n", file->size, file->mtime, file->hash, file->name);
+	}
+	fclose(fp);
+}
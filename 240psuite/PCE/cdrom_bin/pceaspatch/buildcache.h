@@ -0,0 +1,7 @@
+/* buildcache.c, see there for where main.c and input.c call in */
+extern int build_cache_opt;
+
+int  build_cache_check(int argc, char **argv, char *out_name);
+void build_cache_note(char *name, char *path);
+void build_cache_output(char *path);
+void build_cache_save(void);
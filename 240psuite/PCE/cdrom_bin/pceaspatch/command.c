@@ -5,6 +5,7 @@
 #include "defs.h"
 #include "externs.h"
 #include "protos.h"
+#include "filecache.h"
 
 /* pseudo instructions section flag */
 char pseudo_flag[] = {
@@ -698,7 +699,7 @@ do_bank(int *ip)
 void
 do_incbin(int *ip)
 {
-	FILE *fp;
+	struct t_file *file;
 	char *p;
 	char fname[128];
 	int  size;
@@ -730,36 +731,29 @@ do_incbin(int *ip)
 	if (pass == LAST_PASS)
 		loadlc(loccnt, 0);
 
-	/* open file */
-	if ((fp = open_file(fname, "rb")) == NULL) {
+	/* the size is all the first pass needs, the contents are read once */
+	if ((file = file_cache_get(fname, pass == LAST_PASS)) == NULL) {
 		fatal_error("Can not open file!");
 		return;
 	}
-
-	/* get file size */
-	fseek(fp, 0, SEEK_END);
-	size = ftell(fp);
-	fseek(fp, 0, SEEK_SET);
+	size = file->size;
 
 	/* check if it will fit in the rom */
 	if (((bank << 13) + loccnt + size) > rom_limit) {
-		fclose(fp);
 		error("ROM overflow!");
 		return;
 	}
 
 	/* load data on last pass */
 	if (pass == LAST_PASS) {
-		fread(&rom[bank][loccnt], 1, size, fp);
+		if (size)
+			memcpy(&rom[bank][loccnt], file->data, size);
 		memset(&map[bank][loccnt], section + (page << 5), size);
 
 		/* output line */
 		println();
 	}
 
-	/* close file */
-	fclose(fp);
-
 	/* update bank and location counters */
 	bank  += (loccnt + size) >> 13;
 	loccnt = (loccnt + size) & 0x1FFF;
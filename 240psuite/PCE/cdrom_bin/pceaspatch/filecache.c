@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+#include "defs.h"
+#include "externs.h"
+#include "protos.h"
+#include "htab.h"
+#include "filecache.h"
+
+/* Files read by .incbin and the PCX directives, kept for the whole
+ * assembly. An entry is found again by the name used in the source and
+ * only trusted while the file has the same size and modification time,
+ * so every pass still opens the file once to stat it but never reads
+ * or decodes it again.
+ */
+
+struct t_htab file_htab;
+
+static int
+file_match(void *item, const void *key)
+{
+	return (strcmp(((struct t_file *)item)->name, key) == 0);
+}
+
+
+/* ----
+ * file_cache_get()
+ * ----
+ * look up a file, with load set the contents are read in (or mapped)
+ * as well; returns NULL if the file can not be opened or read
+ */
+
+struct t_file *
+file_cache_get(char *name, int load)
+{
+	struct t_file *ptr;
+	struct stat st;
+	FILE *fp;
+	unsigned int hash;
+
+	/* open_file() searches the include paths, and notes the file for
+	 * the build cache */
+	if ((fp = open_file(name, "rb")) == NULL)
+		return (NULL);
+	if (fstat(fileno(fp), &st)) {
+		fclose(fp);
+		return (NULL);
+	}
+
+	/* search the cache */
+	hash = htab_hash_str(name);
+	if ((ptr = htab_find(&file_htab, hash, file_match, name)) != NULL) {
+		/* the file changed, forget what we had */
+		if ((ptr->mtime != st.st_mtime) || (ptr->size != (long)st.st_size))
+			file_cache_drop(ptr);
+	}
+
+	/* new entry */
+	else {
+		if ((ptr = (void *)calloc(1, sizeof(struct t_file))) == NULL) {
+			fclose(fp);
+			return (NULL);
+		}
+		strncpy(ptr->name, name, sizeof(ptr->name) - 1);
+		if (!htab_insert(&file_htab, hash, ptr)) {
+			free(ptr);
+			fclose(fp);
+			return (NULL);
+		}
+	}
+	ptr->mtime = st.st_mtime;
+	ptr->size = (long)st.st_size;
+
+	/* contents */
+	if (load && (ptr->data == NULL) && (ptr->size > 0)) {
+#ifndef _WIN32
+		void *map = mmap(NULL, ptr->size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+
+		if (map != MAP_FAILED) {
+			ptr->data = map;
+			ptr->mapped = 1;
+		}
+		else
+#endif
+		{
+			if ((ptr->data = malloc(ptr->size)) != NULL) {
+				if (fread(ptr->data, 1, ptr->size, fp) != (size_t)ptr->size) {
+					free(ptr->data);
+					ptr->data = NULL;
+				}
+			}
+		}
+		if (ptr->data == NULL) {
+			fclose(fp);
+			return (NULL);
+		}
+	}
+
+	fclose(fp);
+	return (ptr);
+}
+
+
+/* ----
+ * file_cache_drop()
+ * ----
+ * release the contents and decoded picture of an entry
+ */
+
+void
+file_cache_drop(struct t_file *ptr)
+{
+	if (ptr->data) {
+#ifndef _WIN32
+		if (ptr->mapped)
+			munmap(ptr->data, ptr->size);
+		else
+#endif
+			free(ptr->data);
+	}
+	if (ptr->pcx_buf)
+		free(ptr->pcx_buf);
+	ptr->data = NULL;
+	ptr->mapped = 0;
+	ptr->pcx_buf = NULL;
+}
+
+
+/* ----
+ * file_cache_flush()
+ * ----
+ * free everything, at the end of the assembly
+ */
+
+static void
+file_cache_free(void *item)
+{
+	file_cache_drop(item);
+	free(item);
+}
+
+void
+file_cache_flush(void)
+{
+	htab_foreach(&file_htab, file_cache_free);
+	htab_clear(&file_htab);
+}
@@ -0,0 +1,20 @@
+#include <time.h>
+
+/* file cache entry */
+struct t_file {
+	char   name[128];		/* as written in the source */
+	time_t mtime;
+	long   size;
+	unsigned char *data;	/* contents, NULL until asked for */
+	int    mapped;			/* data is mmap()ed */
+	/* decoded picture, kept by pcx_load() */
+	unsigned char *pcx_buf;
+	int    pcx_w, pcx_h;
+	int    pcx_nb_colors;
+	unsigned char pcx_pal[256][3];
+};
+
+/* filecache.c */
+struct t_file *file_cache_get(char *name, int load);
+void           file_cache_drop(struct t_file *ptr);
+void           file_cache_flush(void);
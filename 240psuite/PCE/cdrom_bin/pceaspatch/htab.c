@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "htab.h"
+
+/* Linear probing on a power of two table that doubles past 3/4 full.
+ * The full 32 bit hash of every item is kept next to it, so growing
+ * never calls back into the owner and most mismatches are rejected
+ * without comparing keys. Items are never removed one by one, only
+ * all together with htab_clear().
+ */
+
+#define HTAB_MIN_SIZE 256
+
+
+/* ----
+ * htab_hash()
+ * ----
+ * FNV-1a
+ */
+
+unsigned int
+htab_hash(const void *data, int len)
+{
+	const unsigned char *ptr = data;
+	unsigned int hash = 2166136261u;
+
+	while (len--)
+		hash = (hash ^ *ptr++) * 16777619u;
+	return (hash);
+}
+
+unsigned int
+htab_hash_str(const char *str)
+{
+	return (htab_hash(str, strlen(str)));
+}
+
+
+/* ----
+ * htab_find()
+ * ----
+ * first item with this hash that match() accepts, or NULL
+ */
+
+void *
+htab_find(struct t_htab *tab, unsigned int hash, int (*match)(void *item, const void *key), const void *key)
+{
+	int mask = tab->size - 1;
+	int i;
+
+	if (tab->size == 0)
+		return (NULL);
+
+	for (i = hash & mask; tab->item[i]; i = (i + 1) & mask) {
+		if ((tab->hash[i] == hash) && match(tab->item[i], key))
+			return (tab->item[i]);
+	}
+	return (NULL);
+}
+
+
+/* ----
+ * htab_grow()
+ * ----
+ */
+
+static int
+htab_grow(struct t_htab *tab)
+{
+	struct t_htab old = *tab;
+	int size = old.size ? old.size * 2 : HTAB_MIN_SIZE;
+	int mask = size - 1;
+	int i, j;
+
+	tab->hash = malloc(sizeof(unsigned int) * size);
+	tab->item = calloc(size, sizeof(void *));
+	if ((tab->hash == NULL) || (tab->item == NULL)) {
+		free(tab->hash);
+		free(tab->item);
+		*tab = old;
+		return (0);
+	}
+	tab->size = size;
+
+	/* reinsert */
+	for (i = 0; i < old.size; i++) {
+		if (old.item[i] == NULL)
+			continue;
+		for (j = old.hash[i] & mask; tab->item[j]; j = (j + 1) & mask)
+			;
+		tab->hash[j] = old.hash[i];
+		tab->item[j] = old.item[i];
+	}
+
+	free(old.hash);
+	free(old.item);
+	return (1);
+}
+
+
+/* ----
+ * htab_insert()
+ * ----
+ * returns 0 when out of memory
+ */
+
+int
+htab_insert(struct t_htab *tab, unsigned int hash, void *item)
+{
+	int mask;
+	int i;
+
+	if ((tab->count + 1) * 4 > tab->size * 3) {
+		if (!htab_grow(tab))
+			return (0);
+	}
+
+	mask = tab->size - 1;
+	for (i = hash & mask; tab->item[i]; i = (i + 1) & mask)
+		;
+	tab->hash[i] = hash;
+	tab->item[i] = item;
+	tab->count++;
+	return (1);
+}
+
+
+/* ----
+ * htab_clear()
+ * ----
+ * forget all items, the items themselves are left alone
+ */
+
+void
+htab_clear(struct t_htab *tab)
+{
+	free(tab->hash);
+	free(tab->item);
+	tab->size = 0;
+	tab->count = 0;
+	tab->hash = NULL;
+	tab->item = NULL;
+}
+
+
+/* ----
+ * htab_foreach()
+ * ----
+ */
+
+void
+htab_foreach(struct t_htab *tab, void (*func)(void *item))
+{
+	int i;
+
+	for (i = 0; i < tab->size; i++) {
+		if (tab->item[i])
+			func(tab->item[i]);
+	}
+}
@@ -0,0 +1,15 @@
+/* growable open addressing hash table, see htab.c */
+struct t_htab {
+	int size;				/* slots, a power of two, 0 until first insert */
+	int count;
+	unsigned int *hash;
+	void **item;
+};
+
+/* htab.c */
+unsigned int htab_hash(const void *data, int len);
+unsigned int htab_hash_str(const char *str);
+void *htab_find(struct t_htab *tab, unsigned int hash, int (*match)(void *item, const void *key), const void *key);
+int   htab_insert(struct t_htab *tab, unsigned int hash, void *item);
+void  htab_clear(struct t_htab *tab);
+void  htab_foreach(struct t_htab *tab, void (*func)(void *item));
@@ -802,6 +802,7 @@ pce_incmap(int *ip)
 	unsigned int tx, ty;
 	int tile, size;
 	int err = 0;
+	int big = 0;
 
 	/* define label */
 	labldef(loccnt, 1);
@@ -834,6 +835,11 @@ pce_incmap(int *ip)
 				tile = 0;
 				err++;
 			}
+			else if (tile > 0xFF) {
+				/* map entries are bytes */
+				tile = 0;
+				big++;
+			}
 
 			/* store tile index */
 			if (pass == LAST_PASS)
@@ -847,6 +853,8 @@ pce_incmap(int *ip)
 	/* error */
 	if (err)
 		error("One or more tiles didn't match!");
+	if (big)
+		error("One or more tiles are past the first 256 of the tile table!");
 
 	/* output */
 	if (pass == LAST_PASS)
@@ -6,6 +6,8 @@
 #include "defs.h"
 #include "externs.h"
 #include "protos.h"
+#include "filecache.h"
+#include "htab.h"
 
 /* globals */
 char pcx_name[128];		/* pcx file name */
@@ -17,8 +19,10 @@ unsigned char *pcx_buf;		/* pointer to the pcx buffer */
 unsigned char  pcx_pal[256][3];		/* palette */
 unsigned char  pcx_plane[128][4];	/* plane buffer */
 unsigned int     tile_offset;	/* offset in the tile reference table */
-struct t_tile    tile[256];		/* tile info table */
-struct t_tile   *tile_tbl[256];	/* tile hash table */
+struct t_tile   *tile_info;		/* tile info table, tile_info_max entries */
+int              tile_info_max;
+struct t_htab    tile_htab;		/* tile hash table */
+int              tile_size;		/* bytes per tile in the table */
 struct t_symbol *tile_lablptr;	/* tile symbol reference */
 struct PCX_HEADER {		/* pcx file header */
 	unsigned char manufacturer, version;
@@ -97,6 +101,19 @@ pcx_pack_16x16_sprite(unsigned char *buffer, int x, int y)
 }
 
 
+/* ----
+ * pcx_tile_match()
+ * ----
+ * tile table comparison, all tiles of a table have the same size
+ */
+
+static int
+pcx_tile_match(void *item, const void *key)
+{
+	return (memcmp(((struct t_tile *)item)->data, key, tile_size) == 0);
+}
+
+
 /* ----
  * pcx_set_tile()
  * ----
@@ -106,9 +123,8 @@ int
 pcx_set_tile(struct t_symbol *ref, unsigned int offset)
 {
 	int i;
-	int hash;
+	unsigned int hash;
 	int size, start;
-	unsigned int crc;
 	unsigned char *data;
 	int nb;
 
@@ -150,30 +166,52 @@ pcx_set_tile(struct t_symbol *ref, unsigned int offset)
 		goto err;
 
 	/* reset tile hash table */
-	for (i = 0; i < 256; i++)
-		tile_tbl[i] = NULL;
+	htab_clear(&tile_htab);
 
 	/* get infos */
 	nb   = ref->nb - (start / ref->size);
 	size = ref->size;
 	data = &rom[ref->bank - bank_base][ref->value & 0x1FFF] + start;
 
-	/* 256 tiles max */
-	if (nb > 256)
-		nb = 256;
+	/* grow the info table, there is no tile limit */
+	if (nb > tile_info_max) {
+		struct t_tile *info = realloc(tile_info, sizeof(struct t_tile) * nb);
+
+		if (info == NULL) {
+			tile_lablptr = NULL;
+			error("Not enough memory for the tile table!");
+			return (1);
+		}
+		tile_info = info;
+		tile_info_max = nb;
+	}
+	tile_size = size;
 
 	/* parse tiles */
 	for (i = 0; i < nb; i++) {
-		/* calculate tile crc */
-		crc  = crc_calc(data, size);
-		hash = (crc & 0xFF);
+		struct t_tile *found;
+
+		hash = htab_hash(data, size);
 
-		/* insert the tile in the tile table */
-		tile[i].next = tile_tbl[hash];
-		tile[i].index = i;
-		tile[i].data = data;
-		tile[i].crc = crc;
-		tile_tbl[hash] = &tile[i];
+		tile_info[i].next = NULL;
+		tile_info[i].index = i;
+		tile_info[i].data = data;
+		tile_info[i].crc = hash;
+
+		/* of identical tiles the last one is found, as with the old
+		 * chains, unless that would push the index past a byte
+		 */
+		if ((found = htab_find(&tile_htab, hash, pcx_tile_match, data)) != NULL) {
+			if ((i < 256) || (found->index >= 256))
+				found->index = i;
+		}
+		else {
+			if (!htab_insert(&tile_htab, hash, &tile_info[i])) {
+				tile_lablptr = NULL;
+				error("Not enough memory for the tile table!");
+				return (1);
+			}
+		}
 
 		/* next */
 		data += size;
@@ -201,7 +239,6 @@ int
 pcx_search_tile(unsigned char *data, int size)
 {
 	struct t_tile *tile;
-	unsigned int crc;
 
 	/* do nothing in first passes */
 	if (pass != LAST_PASS)
@@ -213,18 +250,10 @@ pcx_search_tile(unsigned char *data, int size)
 	if (tile_lablptr->size != size)
 		return (-1);
 
-	/* calculate tile crc */
-	crc  = crc_calc(data, size);
-	tile = tile_tbl[crc & 0xFF];
-
 	/* search tile */
-	while (tile) {
-		if (tile->crc == crc) {
-			if (memcmp(tile->data, data, size) == 0)
-				return(tile->index);
-	 	}
-		tile = tile->next;
-	}
+	tile = htab_find(&tile_htab, htab_hash(data, size), pcx_tile_match, data);
+	if (tile)
+		return (tile->index);
 
 	/* not found */
 	return (-1);
@@ -362,19 +391,33 @@ pcx_parse_args(int i, int nb, int *a, int *b, int *c, int *d, int size)
 int
 pcx_load(char *name)
 {
+	struct t_file *file;
 	FILE *f;
 
 	/* check if the file is the same as the previously loaded one;
 	 * if this is the case do not reload it
 	 */
-	if (strlen(name) && (strcasecmp(pcx_name, name) == 0))
+	if (strlen(name) && (strcasecmp(pcx_name, name) == 0) && pcx_buf)
+		return (1);
+
+	/* the buffers belong to the file cache */
+	pcx_buf = NULL;
+	pcx_name[0] = '\0';
+
+	if ((file = file_cache_get(name, 0)) == NULL) {
+		error("Can not open file!");
+		return (0);
+	}
+
+	/* decoded in this pass or an earlier one */
+	if (file->pcx_buf) {
+		pcx_buf = file->pcx_buf;
+		pcx_w = file->pcx_w;
+		pcx_h = file->pcx_h;
+		pcx_nb_colors = file->pcx_nb_colors;
+		memcpy(pcx_pal, file->pcx_pal, 768);
+		strcpy(pcx_name, name);
 		return (1);
-	else {
-		/* no it's a new file - ok let's prepare loading */
-		if (pcx_buf)
-			free(pcx_buf);
-		pcx_buf = NULL;
-		pcx_name[0] = '\0';
 	}
 
 	/* open the file */
@@ -394,17 +437,20 @@ pcx_load(char *name)
 
 	/* check size range */
 	if ((pcx_w > 1024) || (pcx_h > 768)) {
+		fclose(f);
 		error("Picture size too big, max. 1024x768!");
 		return (0);
 	}
 	if ((pcx_w < 16) || (pcx_h < 16)) {
+		fclose(f);
 		error("Picture size too small, min. 16x16!");
 		return (0);
 	}
 
 	/* malloc a buffer */
-    pcx_buf = malloc(pcx_w * pcx_h);
+	pcx_buf = malloc(pcx_w * pcx_h);
 	if (pcx_buf == NULL) {
+		fclose(f);
 		error("Can not load file, not enough memory!");
 		return (0);
 	}
@@ -415,11 +461,21 @@ pcx_load(char *name)
 	else if ((pcx.bpp == 1) && (pcx.np <= 4))
 		decode_16(f, pcx_w, pcx_h);
 	else {
+		fclose(f);
+		free(pcx_buf);
+		pcx_buf = NULL;
 		error("Unsupported or invalid PCX format!");
 		return (0);
 	}
 
 	fclose(f);
+
+	/* keep it for the following passes */
+	file->pcx_buf = pcx_buf;
+	file->pcx_w = pcx_w;
+	file->pcx_h = pcx_h;
+	file->pcx_nb_colors = pcx_nb_colors;
+	memcpy(file->pcx_pal, pcx_pal, 768);
 	strcpy(pcx_name, name);
 	return (1);
 }
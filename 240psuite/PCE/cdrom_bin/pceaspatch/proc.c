@@ -0,0 +1,1131 @@
+/* proc.c from https://github.com/pce-devel/huc with the size sorted bin
+ * packing, which upstream already has, plus what is not upstream: call
+ * graph relocation (-callgraph), the count of calls left going through
+ * the bank switch and the JSON build report (-report). main.c in this
+ * directory has the switches, symbol.c the symbol htab walked here.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "defs.h"
+#include "externs.h"
+#include "protos.h"
+#include "htab.h"
+
+struct t_htab proc_htab;
+struct t_proc *proc_ptr;
+struct t_proc *proc_first;
+struct t_proc *proc_last;
+int proc_nb;
+int call_ptr;
+int call_bank;
+int callgraph_opt;	/* relocate with proc_pack_calls(), -callgraph switch */
+char *report_fname;	/* JSON build report, -report switch, NULL for none */
+
+/* cycles a call through the do_call() trampoline costs on top of a
+ * plain jsr: tay/tma/pha/lda/tam/tya/jsr, then tay/pla/tam/tya/rts
+ */
+#define CALL_STUB_CYCLES 45
+
+/* call sites seen during the first pass */
+struct t_call {
+	struct t_proc *caller;		/* innermost proc, NULL outside procs */
+	int count;
+	char name[SBOLSZ];
+};
+struct t_htab call_htab;
+
+/* symbol.c */
+extern struct t_htab sym_htab;
+
+/* protos */
+struct t_proc *proc_look(void);
+int            proc_install(void);
+void           poke(int addr, int data);
+void           proc_sortlist(void);
+void           proc_call_record(int *ip);
+int            proc_pack_calls(int *bankleft, int *minbanks);
+void           proc_call_report(void);
+void           proc_report(int *bankleft, int first, int last);
+
+
+/* ----
+ * do_call()
+ * ----
+ * call pseudo
+ */
+
+void
+do_call(int *ip)
+{
+	struct t_proc *ptr;
+	int value;
+
+	/* define label */
+	labldef(loccnt, 1);
+
+	/* update location counter */
+	data_loccnt = loccnt;
+	loccnt += 3;
+
+	/* generate code */
+	if (pass == LAST_PASS) {
+		/* skip spaces */
+		while (isspace(prlnbuf[*ip]))
+			(*ip)++;
+
+		/* extract name */
+		if (!colsym(ip)) {
+			if (symbol[0] == 0)
+				fatal_error("Syntax error!");
+			return;
+		}
+
+		/* check end of line */
+		check_eol(ip);
+
+		/* lookup proc table */
+		if((ptr = proc_look())) {
+			/* check banks */
+			if (bank == ptr->bank)
+				value = ptr->org + 0xA000;
+			else {
+				/* different */
+				if (ptr->call)
+					value = ptr->call;
+				else {
+					/* new call */
+					value = call_ptr + 0x8000;
+					ptr->call = value;
+
+					/* init */
+					if (call_ptr == 0) {
+						call_bank = ++max_bank;
+					}
+
+					/* install */
+					poke(call_ptr++, 0xA8);			// tay
+					poke(call_ptr++, 0x43);			// tma #5
+					poke(call_ptr++, 0x20);
+					poke(call_ptr++, 0x48);			// pha
+					poke(call_ptr++, 0xA9);			// lda #...
+					poke(call_ptr++, ptr->bank+bank_base);
+					poke(call_ptr++, 0x53);			// tam #5
+					poke(call_ptr++, 0x20);
+					poke(call_ptr++, 0x98);			// tya
+					poke(call_ptr++, 0x20);			// jsr ...
+					poke(call_ptr++, (ptr->org & 0xFF));
+					poke(call_ptr++, (ptr->org >> 8) + 0xA0);
+					poke(call_ptr++, 0xA8);			// tay
+					poke(call_ptr++, 0x68);			// pla
+					poke(call_ptr++, 0x53);			// tam #5
+					poke(call_ptr++, 0x20);
+					poke(call_ptr++, 0x98);			// tya
+					poke(call_ptr++, 0x60);			// rts
+				}
+			}
+		}
+		else {
+			/* lookup symbol table */
+			if ((lablptr = stlook(0)) == NULL) {
+				fatal_error("Undefined destination!");
+				return;
+			}
+
+			/* get symbol value */
+			value = lablptr->value;
+		}
+
+		/* opcode */
+		putbyte(data_loccnt, 0x20);
+		putword(data_loccnt+1, value);
+
+		/* output line */
+		println();
+	}
+	else
+		proc_call_record(ip);
+}
+
+
+/* ----
+ * do_proc()
+ * ----
+ * .proc pseudo
+ */
+
+void
+do_proc(int *ip)
+{
+	struct t_proc *ptr;
+
+	/* check if nesting procs/groups */
+	if (proc_ptr) {
+		if (optype == P_PGROUP) {
+			fatal_error("Can not declare a group inside a proc/group!");
+			return;
+		}
+		else {
+			if (proc_ptr->type == P_PROC) {
+				fatal_error("Can not nest procs!");
+				return;
+			}
+		}
+	}
+
+	/* get proc name */
+	if (lablptr) {
+		strcpy(&symbol[1], &lablptr->name[1]);
+		symbol[0] = strlen(&symbol[1]);
+	}
+	else {
+		/* skip spaces */
+		while (isspace(prlnbuf[*ip]))
+			(*ip)++;
+
+		/* extract name */
+		if (!colsym(ip)) {
+			if (symbol[0])
+				return;
+			if (optype == P_PROC) {
+				fatal_error("Proc name is missing!");
+				return;
+			}
+
+			/* default name */
+			sprintf(&symbol[1], "__group_%i__", proc_nb + 1);
+			symbol[0] = strlen(&symbol[1]);
+		}
+
+		/* lookup symbol table */
+		if ((lablptr = stlook(1)) == NULL)
+			return;
+	}
+
+	/* check symbol */
+	if (symbol[1] == '.') {
+		fatal_error("Proc/group name can not be local!");
+		return;
+	}
+
+	/* check end of line */
+	if (!check_eol(ip))
+		return;
+
+	/* search (or create new) proc */
+	if((ptr = proc_look()))
+		proc_ptr = ptr;
+	else {
+		if (!proc_install())
+			return;
+	}
+	if (proc_ptr->refcnt) {
+		fatal_error("Proc/group multiply defined!");
+		return;
+	}
+
+	/* incrememte proc ref counter */
+	proc_ptr->refcnt++;
+
+	/* backup current bank infos */
+	bank_glabl[section][bank]  = glablptr;
+	bank_loccnt[section][bank] = loccnt;
+	bank_page[section][bank]   = page;
+	proc_ptr->old_bank = bank;
+	proc_nb++;
+
+	/* set new bank infos */
+	bank     = proc_ptr->bank;
+	page     = 5;
+	loccnt   = proc_ptr->org;
+	glablptr = lablptr;
+
+	/* define label */
+	labldef(loccnt, 1);
+
+	/* output */
+	if (pass == LAST_PASS) {
+		loadlc((page << 13) + loccnt, 0);
+		println();
+	}
+}
+
+
+/* ----
+ * do_endp()
+ * ----
+ * .endp pseudo
+ */
+
+void
+do_endp(int *ip)
+{
+	if (proc_ptr == NULL) {
+		fatal_error("Unexpected ENDP/ENDPROCGROUP!");
+		return;
+	}
+	if (optype != proc_ptr->type) {
+		fatal_error("Unexpected ENDP/ENDPROCGROUP!");
+		return;
+	}
+
+	/* check end of line */
+	if (!check_eol(ip))
+		return;
+
+	/* record proc size */
+	bank = proc_ptr->old_bank;
+	proc_ptr->size = loccnt - proc_ptr->base;
+	proc_ptr = proc_ptr->group;
+
+	/* restore previous bank settings */
+	if (proc_ptr == NULL) {
+		page     = bank_page[section][bank];
+		loccnt   = bank_loccnt[section][bank];
+		glablptr = bank_glabl[section][bank];
+	}
+
+	/* output */
+	if (pass == LAST_PASS)
+		println();
+}
+
+
+/* ----
+ * proc_reloc()
+ * ----
+ *
+ */
+
+static void
+proc_reloc_sym(void *item)
+{
+	struct t_symbol *sym = item;
+	struct t_symbol *local;
+	struct t_proc   *ptr;
+
+	/* remap addr */
+	if (sym->proc) {
+		ptr = sym->proc;
+		sym->bank   =  ptr->bank;
+		sym->value += (ptr->org - ptr->base);
+
+		/* local symbols */
+		local = sym->local;
+
+		while (local) {
+			ptr = local->proc;
+
+			/* remap addr */
+			if (local->proc) {
+				local->bank   =  ptr->bank;
+				local->value += (ptr->org - ptr->base);
+			}
+
+			/* next */
+			local = local->next;
+		}
+	}
+}
+
+void
+proc_reloc(void)
+{
+	struct t_proc   *group;
+	int i;
+	int *bankleft = NULL;
+	int bank_base = 0;
+	int minbanks = 0;
+	int totalsize = 0;
+	struct t_proc *list = proc_first;
+
+	if (proc_nb == 0)
+		return;
+
+	/* init */
+	proc_ptr = proc_first;
+	bank = max_bank + 1;
+	bank_base = bank;
+
+	while(list)
+	{
+		totalsize += list->size;
+		list = list->link;
+	}
+
+	minbanks = totalsize / 0x2000 + bank_base;
+
+	if(minbanks > bank_limit)
+	{
+		printf("Bank need excceed Bank limit, aborting\n");
+		return;
+	}
+
+	/* Bin packing, descending order sort */
+	proc_sortlist();
+
+	bankleft = (int*)malloc(sizeof(int)*bank_limit);
+	if(!bankleft)
+	{
+		fatal_error("Not enough RAM to allocate banks!");
+		return;
+	}
+
+	for(i = 0; i < bank_limit; i++)
+	{
+		if(i >= bank_base)
+			bankleft[i] = 0x2000;
+		else
+			bankleft[i] = 0;
+	}
+
+	/* the call graph mode places procs and groups itself */
+	if (callgraph_opt) {
+		if (!proc_pack_calls(bankleft, &minbanks)) {
+			free(bankleft);
+			return;
+		}
+		proc_ptr = NULL;
+	}
+	else
+		proc_ptr = proc_first;
+
+	/* alloc memory */
+	while (proc_ptr) {
+		/* proc */
+		if (proc_ptr->group == NULL) {
+			int check = 0;
+			int unusedspace = 0x2000;
+			int proposedbank = -1;
+
+			while(proposedbank == -1)
+			{
+				for(check = 0; check < minbanks; check++)
+				{
+					if(bankleft[check] > proc_ptr->size)
+					{
+						if(unusedspace > bankleft[check] - proc_ptr->size)
+						{
+							unusedspace = bankleft[check] - proc_ptr->size;
+							proposedbank = check;
+						}
+					}
+				}
+
+				if(proposedbank == -1)
+				{
+					/* bank change */
+					minbanks++;
+					if (minbanks > bank_limit) 
+					{
+						int total = 0;
+		
+						fatal_error("Not enough ROM space for procs!");
+		
+						for(i = bank_base; i < bank; i++)
+						{
+							printf("Bank %d: %d free\n", i, bankleft[i]);
+							total += bankleft[i];
+						}
+						printf("Total free space in all banks %d\n", total);
+		
+						total = 0;
+						proc_ptr = proc_first;
+						while (proc_ptr) {
+							printf("Proc: %s Bank: 0x%X Size: %d\n", proc_ptr->name, proc_ptr->bank == 241 ? 0 : proc_ptr->bank, proc_ptr->size);
+							if(proc_ptr->bank == 241)
+								total += proc_ptr->size;
+							proc_ptr = proc_ptr->link;
+						}
+						printf("Total bytes that didn't fit in ROM %d\n", total);
+						errcnt++;
+						return;
+					}
+					proposedbank = minbanks - 1;
+				}
+			}
+			
+			
+			proc_ptr->bank = proposedbank;
+			proc_ptr->org = 0x2000 - bankleft[proposedbank];
+
+			bankleft[proposedbank] -= proc_ptr->size;
+		}
+
+		/* group */
+		else {
+			/* reloc proc */
+			group = proc_ptr->group;
+			proc_ptr->bank = bank;
+			proc_ptr->org += (group->org - group->base);
+		}
+
+		/* next */
+		bank = minbanks-1;
+		max_bank = bank;
+		proc_ptr->refcnt = 0;
+		proc_ptr = proc_ptr->link;
+	}
+
+	/* layout and call costs, before the call graph is gone */
+	if (report_fname)
+		proc_report(bankleft, bank_base, minbanks);
+
+	free(bankleft);
+	bankleft = NULL;
+
+	/* how many calls still go through the bank switch */
+	proc_call_report();
+
+	/* remap proc symbols */
+	htab_foreach(&sym_htab, proc_reloc_sym);
+
+	/* reserve call bank */
+	lablset("_call_bank", bank_base + max_bank + 1);
+
+	/* reset */
+	proc_ptr = NULL;
+	proc_nb = 0;
+}
+
+
+/* ----
+ * proc_look()
+ * ----
+ *
+ */
+
+static int
+proc_match(void *item, const void *key)
+{
+	return (strcmp(((struct t_proc *)item)->name, key) == 0);
+}
+
+struct t_proc *
+proc_look(void)
+{
+	/* search the procedure in the hash table */
+	return (htab_find(&proc_htab, htab_hash_str(&symbol[1]), proc_match, &symbol[1]));
+}
+
+
+/* ----
+ * proc_install()
+ * ----
+ * install a procedure in the hash table
+ *
+ */
+
+int
+proc_install(void)
+{
+	struct t_proc *ptr;
+
+	/* allocate a new proc struct */
+	if ((ptr = (void *)malloc(sizeof(struct t_proc))) == NULL) {
+		error("Out of memory!");
+		return (0);
+	}
+
+	/* initialize it */
+	strcpy(ptr->name, &symbol[1]);
+	if (!htab_insert(&proc_htab, htab_hash_str(ptr->name), ptr)) {
+		free(ptr);
+		error("Out of memory!");
+		return (0);
+	}
+	ptr->bank = (optype == P_PGROUP)  ? GROUP_BANK : PROC_BANK;
+	ptr->base = proc_ptr ? loccnt : 0;
+	ptr->org = ptr->base;
+	ptr->size = 0;
+	ptr->call = 0;
+	ptr->refcnt = 0;
+	ptr->link = NULL;
+	ptr->next = NULL;
+	ptr->group = proc_ptr;
+	ptr->type = optype;
+	proc_ptr = ptr;
+
+	/* link it */
+	if (proc_first == NULL) {
+		proc_first = proc_ptr;
+		proc_last  = proc_ptr;
+	}
+	else {
+		proc_last->link = proc_ptr;
+		proc_last = proc_ptr;
+	}
+
+	/* ok */
+	return (1);
+}
+
+
+/* ----
+ * poke()
+ * ----
+ *
+ */
+
+void
+poke(int addr, int data)
+{
+	rom[call_bank][addr] = data;
+	map[call_bank][addr] = S_CODE + (4 << 5);
+}
+
+/* ----
+ * proc_sortlist()
+ * ----
+ * largest procs first, procs of the same size stay in source order
+ */
+
+struct t_proc_order {
+	struct t_proc *proc;
+	int index;
+};
+
+static int
+proc_cmp_size(const void *a, const void *b)
+{
+	const struct t_proc_order *pa = a;
+	const struct t_proc_order *pb = b;
+
+	if (pa->proc->size != pb->proc->size)
+		return (pb->proc->size - pa->proc->size);
+	return (pa->index - pb->index);
+}
+
+void
+proc_sortlist(void)
+{
+	struct t_proc_order *list;
+	int count = 0;
+	int i;
+
+	for (proc_ptr = proc_first; proc_ptr; proc_ptr = proc_ptr->link)
+		count++;
+	if (count < 2)
+		return;
+
+	if ((list = (struct t_proc_order *)malloc(sizeof(struct t_proc_order) * count)) == NULL) {
+		fatal_error("Not enough RAM to sort procs!");
+		return;
+	}
+
+	for (i = 0, proc_ptr = proc_first; proc_ptr; proc_ptr = proc_ptr->link, i++) {
+		list[i].proc = proc_ptr;
+		list[i].index = i;
+	}
+	qsort(list, count, sizeof(struct t_proc_order), proc_cmp_size);
+
+	for (i = 0; i < count - 1; i++)
+		list[i].proc->link = list[i + 1].proc;
+	list[count - 1].proc->link = NULL;
+	proc_first = list[0].proc;
+	proc_last = list[count - 1].proc;
+	free(list);
+}
+
+
+/* ----
+ * proc_call_record()
+ * ----
+ * first pass of a call, counts caller -> callee; errors are left to the last pass
+ */
+
+static int
+proc_call_match(void *item, const void *key)
+{
+	struct t_call *call = item;
+
+	return ((call->caller == proc_ptr) && !strcmp(call->name, key));
+}
+
+void
+proc_call_record(int *ip)
+{
+	struct t_call *ptr;
+	unsigned int hash;
+
+	while (isspace(prlnbuf[*ip]))
+		(*ip)++;
+	if (!colsym(ip) || (symbol[0] == 0))
+		return;
+
+	hash = htab_hash_str(&symbol[1]) ^ (unsigned int)(size_t)proc_ptr;
+	if ((ptr = htab_find(&call_htab, hash, proc_call_match, &symbol[1])) != NULL) {
+		ptr->count++;
+		return;
+	}
+
+	if ((ptr = (void *)malloc(sizeof(struct t_call))) == NULL)
+		return;
+	strcpy(ptr->name, &symbol[1]);
+	ptr->caller = proc_ptr;
+	ptr->count = 1;
+	if (!htab_insert(&call_htab, hash, ptr))
+		free(ptr);
+}
+
+
+/* ----
+ * proc_call_target()
+ * ----
+ * the proc a recorded call goes to, or NULL for plain labels
+ */
+
+static struct t_proc *
+proc_call_target(struct t_call *call)
+{
+	strcpy(&symbol[1], call->name);
+	symbol[0] = strlen(call->name);
+	return (proc_look());
+}
+
+
+/* ----
+ * proc_pack_calls()
+ * ----
+ * Call graph relocation. The top level procs and groups that call each
+ * other most are merged into clusters while they still fit in a bank
+ * (heaviest edges first), the clusters then go largest first into the
+ * bank they have the most calls with, best fit among equals. Weights
+ * are call sites, each one that ends up in the same bank as its target
+ * is a plain jsr instead of the tma/tam trampoline.
+ */
+
+struct t_edge {
+	int a;
+	int b;
+	int weight;
+};
+
+static struct t_proc **pack_unit;
+static int pack_units;
+static int *pack_size;
+
+static int
+pack_cmp_ptr(const void *a, const void *b)
+{
+	struct t_proc *pa = *(struct t_proc **)a;
+	struct t_proc *pb = *(struct t_proc **)b;
+
+	return ((pa > pb) - (pa < pb));
+}
+
+/* index of the top level proc or group containing ptr */
+static int
+pack_unit_index(struct t_proc *ptr)
+{
+	struct t_proc **found;
+
+	while (ptr->group)
+		ptr = ptr->group;
+	found = bsearch(&ptr, pack_unit, pack_units, sizeof(struct t_proc *), pack_cmp_ptr);
+	return (found ? (int)(found - pack_unit) : -1);
+}
+
+static int
+pack_cmp_pair(const void *a, const void *b)
+{
+	const struct t_edge *ea = a;
+	const struct t_edge *eb = b;
+
+	if (ea->a != eb->a)
+		return (ea->a - eb->a);
+	return (ea->b - eb->b);
+}
+
+static int
+pack_cmp_weight(const void *a, const void *b)
+{
+	const struct t_edge *ea = a;
+	const struct t_edge *eb = b;
+
+	if (ea->weight != eb->weight)
+		return (eb->weight - ea->weight);
+	return (pack_cmp_pair(a, b));
+}
+
+static int
+pack_cmp_cluster(const void *a, const void *b)
+{
+	int ia = *(const int *)a;
+	int ib = *(const int *)b;
+
+	if (pack_size[ia] != pack_size[ib])
+		return (pack_size[ib] - pack_size[ia]);
+	return (ia - ib);
+}
+
+static int
+pack_find(int *parent, int i)
+{
+	while (parent[i] != i)
+		i = parent[i] = parent[parent[i]];
+	return (i);
+}
+
+int
+proc_pack_calls(int *bankleft, int *minbanks)
+{
+	struct t_call *call;
+	struct t_proc *ptr;
+	struct t_edge *edge = NULL;
+	int *parent = NULL, *size = NULL, *unit_bank = NULL, *order = NULL, *affinity = NULL;
+	int edges = 0, calls = 0;
+	int result = 0;
+	int i, j, c;
+
+	/* units, sorted by address for the lookups */
+	pack_units = 0;
+	for (ptr = proc_first; ptr; ptr = ptr->link)
+		if (ptr->group == NULL)
+			pack_units++;
+	calls = call_htab.count;
+
+	pack_unit = malloc(sizeof(struct t_proc *) * (pack_units + 1));
+	edge = malloc(sizeof(struct t_edge) * (calls + 1));
+	parent = malloc(sizeof(int) * (pack_units + 1));
+	size = malloc(sizeof(int) * (pack_units + 1));
+	unit_bank = malloc(sizeof(int) * (pack_units + 1));
+	order = malloc(sizeof(int) * (pack_units + 1));
+	affinity = malloc(sizeof(int) * bank_limit);
+	if (!pack_unit || !edge || !parent || !size || !unit_bank || !order || !affinity) {
+		fatal_error("Not enough RAM for the call graph!");
+		goto done;
+	}
+
+	for (i = 0, ptr = proc_first; ptr; ptr = ptr->link)
+		if (ptr->group == NULL)
+			pack_unit[i++] = ptr;
+	qsort(pack_unit, pack_units, sizeof(struct t_proc *), pack_cmp_ptr);
+	for (i = 0; i < pack_units; i++) {
+		parent[i] = i;
+		size[i] = pack_unit[i]->size;
+		unit_bank[i] = -1;
+	}
+
+	/* undirected edges between units, calls inside a unit don't matter */
+	for (i = 0; i < call_htab.size; i++) {
+		int a, b;
+
+		if ((call = call_htab.item[i]) == NULL)
+			continue;
+		if ((call->caller == NULL) || ((ptr = proc_call_target(call)) == NULL))
+			continue;
+		a = pack_unit_index(call->caller);
+		b = pack_unit_index(ptr);
+		if ((a < 0) || (b < 0) || (a == b))
+			continue;
+		edge[edges].a = (a < b) ? a : b;
+		edge[edges].b = (a < b) ? b : a;
+		edge[edges].weight = call->count;
+		edges++;
+	}
+	if (edges) {
+		qsort(edge, edges, sizeof(struct t_edge), pack_cmp_pair);
+		for (i = 0, j = 1; j < edges; j++) {
+			if ((edge[j].a == edge[i].a) && (edge[j].b == edge[i].b))
+				edge[i].weight += edge[j].weight;
+			else
+				edge[++i] = edge[j];
+		}
+		edges = i + 1;
+		qsort(edge, edges, sizeof(struct t_edge), pack_cmp_weight);
+	}
+
+	/* merge clusters along the heaviest edges while they fit a bank */
+	for (i = 0; i < edges; i++) {
+		int ca = pack_find(parent, edge[i].a);
+		int cb = pack_find(parent, edge[i].b);
+
+		if ((ca != cb) && (size[ca] + size[cb] < 0x2000)) {
+			parent[cb] = ca;
+			size[ca] += size[cb];
+		}
+	}
+
+	/* clusters largest first, the lowest unit stands for its cluster */
+	for (i = 0, c = 0; i < pack_units; i++)
+		if (pack_find(parent, i) == i)
+			order[c++] = i;
+	pack_size = size;
+	qsort(order, c, sizeof(int), pack_cmp_cluster);
+
+	for (i = 0; i < c; i++) {
+		int root = order[i];
+		int proposedbank = -1;
+		int unusedspace = 0x2000;
+		int best = -1;
+		int check;
+
+		/* calls between this cluster and the banks filled so far */
+		memset(affinity, 0, sizeof(int) * bank_limit);
+		for (j = 0; j < edges; j++) {
+			int ra = pack_find(parent, edge[j].a);
+			int rb = pack_find(parent, edge[j].b);
+
+			if ((ra == root) && (rb != root) && (unit_bank[edge[j].b] >= 0))
+				affinity[unit_bank[edge[j].b]] += edge[j].weight;
+			else if ((rb == root) && (ra != root) && (unit_bank[edge[j].a] >= 0))
+				affinity[unit_bank[edge[j].a]] += edge[j].weight;
+		}
+
+		for (check = 0; check < *minbanks; check++) {
+			if (bankleft[check] > size[root]) {
+				if ((affinity[check] > best) ||
+					((affinity[check] == best) && (unusedspace > bankleft[check] - size[root]))) {
+					best = affinity[check];
+					unusedspace = bankleft[check] - size[root];
+					proposedbank = check;
+				}
+			}
+		}
+
+		if (proposedbank == -1) {
+			/* bank change */
+			(*minbanks)++;
+			if (*minbanks > bank_limit) {
+				fatal_error("Not enough ROM space for procs!");
+				errcnt++;
+				goto done;
+			}
+			proposedbank = *minbanks - 1;
+		}
+
+		/* the members go in one after another */
+		for (j = 0; j < pack_units; j++) {
+			if (pack_find(parent, j) != root)
+				continue;
+			ptr = pack_unit[j];
+			ptr->bank = proposedbank;
+			ptr->org = 0x2000 - bankleft[proposedbank];
+			bankleft[proposedbank] -= ptr->size;
+			unit_bank[j] = proposedbank;
+		}
+	}
+
+	/* procs inside groups follow their group */
+	for (ptr = proc_first; ptr; ptr = ptr->link) {
+		if (ptr->group) {
+			ptr->bank = ptr->group->bank;
+			ptr->org += (ptr->group->org - ptr->group->base);
+		}
+		ptr->refcnt = 0;
+	}
+
+	bank = *minbanks - 1;
+	max_bank = bank;
+	result = 1;
+
+done:
+	free(pack_unit);
+	free(edge);
+	free(parent);
+	free(size);
+	free(unit_bank);
+	free(order);
+	free(affinity);
+	pack_unit = NULL;
+	pack_size = NULL;
+	return (result);
+}
+
+
+/* ----
+ * proc_call_report()
+ * ----
+ * call sites that still need a trampoline, then forget the call graph
+ */
+
+void
+proc_call_report(void)
+{
+	struct t_call *call;
+	struct t_proc *ptr;
+	int sites = 0;
+	int far = 0;
+	int outside = 0;
+	int i;
+
+	for (i = 0; i < call_htab.size; i++) {
+		if ((call = call_htab.item[i]) == NULL)
+			continue;
+		if ((ptr = proc_call_target(call)) == NULL)
+			continue;
+		sites += call->count;
+		if (call->caller == NULL)
+			outside += call->count;
+		else if (call->caller->bank != ptr->bank)
+			far += call->count;
+	}
+
+	if (sites)
+		printf("Proc calls: %d, %d through the bank switch trampoline (%d from outside procs)\n",
+			sites, far + outside, outside);
+
+	htab_foreach(&call_htab, free);
+	htab_clear(&call_htab);
+}
+
+
+/* ----
+ * proc_report()
+ * ----
+ * JSON build report, for following code size and call overhead across
+ * releases: fill of the proc banks, bank, address and size of every
+ * proc, its call sites and how many of them go through the trampoline.
+ * Stub cycles are what its own trampolined call sites cost, each taken
+ * once; path cycles follow the costliest chain of calls from the proc,
+ * and the worst chain of all is written out as the hot path. Static
+ * figures, but they move when a change puts a hot callee in another bank.
+ */
+
+struct t_report {
+	struct t_proc *proc;
+	int sites;			/* call sites in the proc */
+	int far;			/* ... through the trampoline */
+	int called;			/* call sites to the proc */
+	int called_far;
+	int state;			/* 0 new, 1 being followed, 2 done, 3 on the hot path */
+	int cycles;			/* costliest chain from here */
+	struct t_report *next;	/* first callee on it */
+};
+
+static struct t_report *report;
+static int report_nb;
+
+static int
+report_cmp(const void *a, const void *b)
+{
+	return (pack_cmp_ptr(&((const struct t_report *)a)->proc, &((const struct t_report *)b)->proc));
+}
+
+static struct t_report *
+report_find(struct t_proc *ptr)
+{
+	struct t_report key;
+
+	key.proc = ptr;
+	return (bsearch(&key, report, report_nb, sizeof(struct t_report), report_cmp));
+}
+
+/* costliest chain of stubs from a proc, recursion is cut where it loops back */
+static int
+report_path(struct t_report *rep)
+{
+	struct t_call *call;
+	struct t_proc *ptr;
+	struct t_report *callee;
+	int cycles;
+	int i;
+
+	if (rep->state)
+		return ((rep->state == 2) ? rep->cycles : 0);
+	rep->state = 1;
+
+	for (i = 0; i < call_htab.size; i++) {
+		if (((call = call_htab.item[i]) == NULL) || (call->caller != rep->proc))
+			continue;
+		if (((ptr = proc_call_target(call)) == NULL) || ((callee = report_find(ptr)) == NULL))
+			continue;
+		cycles = report_path(callee);
+		if (ptr->bank != rep->proc->bank)
+			cycles += CALL_STUB_CYCLES;
+		if (cycles > rep->cycles) {
+			rep->cycles = cycles;
+			rep->next = callee;
+		}
+	}
+
+	rep->state = 2;
+	return (rep->cycles);
+}
+
+void
+proc_report(int *bankleft, int first, int last)
+{
+	struct t_call *call;
+	struct t_proc *ptr;
+	struct t_report *rep;
+	struct t_report *hot = NULL;
+	struct t_report outside;
+	FILE *fp;
+	int i;
+
+	if ((report = calloc(proc_nb + 1, sizeof(struct t_report))) == NULL) {
+		fatal_error("Not enough RAM for the build report!");
+		return;
+	}
+	for (report_nb = 0, ptr = proc_first; ptr; ptr = ptr->link)
+		report[report_nb++].proc = ptr;
+	qsort(report, report_nb, sizeof(struct t_report), report_cmp);
+
+	/* call sites */
+	memset(&outside, 0, sizeof(outside));
+	for (i = 0; i < call_htab.size; i++) {
+		int far;
+
+		if ((call = call_htab.item[i]) == NULL)
+			continue;
+		if ((ptr = proc_call_target(call)) == NULL)
+			continue;
+		far = (call->caller == NULL) || (call->caller->bank != ptr->bank);
+		rep = call->caller ? report_find(call->caller) : &outside;
+		if (rep) {
+			rep->sites += call->count;
+			rep->far += far ? call->count : 0;
+		}
+		if ((rep = report_find(ptr)) != NULL) {
+			rep->called += call->count;
+			rep->called_far += far ? call->count : 0;
+		}
+	}
+
+	if ((fp = fopen(report_fname, "w")) == NULL) {
+		printf("Can not open build report '%s'!\n", report_fname);
+		free(report);
+		report = NULL;
+		return;
+	}
+
+	fprintf(fp, "{\n  \"cycles_per_stub\": %d,\n  \"banks\": [", CALL_STUB_CYCLES);
+	for (i = first; i < last; i++)
+		fprintf(fp, "%s\n    { \"bank\": %d, \"used\": %d, \"free\": %d }",
+			(i == first) ? "" : ",", i, 0x2000 - bankleft[i], bankleft[i]);
+
+	fprintf(fp, "\n  ],\n  \"procs\": [");
+	for (i = 0, ptr = proc_first; ptr; ptr = ptr->link, i++) {
+		rep = report_find(ptr);
+		fprintf(fp, "%s\n    { \"name\": \"%s\", \"bank\": %d, \"org\": %d, \"size\": %d, ",
+			i ? "," : "", ptr->name, ptr->bank, ptr->org + 0xA000, ptr->size);
+		if (ptr->group)
+			fprintf(fp, "\"group\": \"%s\", ", ptr->group->name);
+		fprintf(fp, "\"calls\": %d, \"calls_far\": %d, \"called\": %d, \"called_far\": %d, ",
+			rep->sites, rep->far, rep->called, rep->called_far);
+		fprintf(fp, "\"stub_cycles\": %d, \"path_cycles\": %d }",
+			rep->far * CALL_STUB_CYCLES, report_path(rep));
+		if ((hot == NULL) || (rep->cycles > hot->cycles))
+			hot = rep;
+	}
+
+	fprintf(fp, "\n  ],\n  \"outside\": { \"calls\": %d, \"calls_far\": %d, \"stub_cycles\": %d },\n",
+		outside.sites, outside.far, outside.far * CALL_STUB_CYCLES);
+
+	/* the worst chain, until it comes back to a proc already on it */
+	fprintf(fp, "  \"hot_path\": { \"cycles\": %d, \"procs\": [", hot ? hot->cycles : 0);
+	for (i = 0, rep = hot; rep && (rep->state != 3); rep = rep->next, i++) {
+		fprintf(fp, "%s\"%s\"", i ? ", " : "", rep->proc->name);
+		rep->state = 3;
+	}
+	fprintf(fp, "] }\n}\n");
+	fclose(fp);
+
+	free(report);
+	report = NULL;
+	report_nb = 0;
+}
@@ -38,6 +38,8 @@
 #include "ire.h"
 #include "video_vdp2.h"
 #include "background.h"
+#include "profile.h"
+#include "video_scroll.h"
 
 #include "pattern_100ire.h"
 #include "pattern_colorbars.h"
@@ -82,6 +84,7 @@ int global_frame_count;
 static void suite_vblank_out_handler(void *work __unused)
 {
     global_frame_count++;
+    video_scroll_table_vblank_out();
     
     if (0==video_is_inited())
         return;
@@ -143,16 +146,20 @@ int main(void)
 
 	//register vblank handler
 	vdp_sync_vblank_out_set(suite_vblank_out_handler, NULL);
+	PROFILE_INIT();
 
 	while(true)
 	{
 		vdp2_tvmd_vblank_out_wait();
+		PROFILE_FRAME();
 		smpc_peripheral_process();
 		get_digital_keypress_anywhere(&controller);
 
 		if(redrawBG)
 		{
+			PROFILE_BEGIN(PROFILE_SECTION_BG_EXPANSION);
 			draw_bg_with_expansion(screenMode,true);
+			PROFILE_END(PROFILE_SECTION_BG_EXPANSION);
 			redrawBG = false;
 		}
 
@@ -3,6 +3,7 @@
 #include <stdbool.h>
 #include <yaul.h>
 #include "background.h"
+#include "background_codec.h"
 #include "font.h"
 #include "video_vdp2.h"
 
@@ -41,6 +42,60 @@ void background_fade_to_black()
     }
 }
 
+//.BG layout: 2048-byte header sector, then the codec tag, the compressed
+//size and the stream, then the 24-bit palette on the next sector boundary
+static int background_asset_compressed_size(const uint8_t *ptr)
+{
+    const int * p32 = (const int *)(&ptr[2048]);
+    int compressed_size = p32[1];
+    assert(compressed_size > 0);
+    assert(compressed_size < 0x1000000);
+    return compressed_size;
+}
+
+static uint32_t background_asset_codec(const uint8_t *ptr)
+{
+    return ((uint32_t)ptr[2048] << 24) | ((uint32_t)ptr[2048+1] << 16) | ((uint32_t)ptr[2048+2] << 8) | ptr[2048+3];
+}
+
+bool background_asset_supported(const uint8_t *ptr)
+{
+    switch (background_asset_codec(ptr))
+    {
+        case BACKGROUND_CODEC_LZ77:
+        case BACKGROUND_CODEC_LZ4:
+        case BACKGROUND_CODEC_RLE:
+            return true;
+    }
+    return false;
+}
+
+//decodes the asset straight into dst (VDP1/VDP2 VRAM is fine), adding
+//color_shift to every non-transparent pixel, see background_codec.h.
+//returns the number of bytes written
+int background_asset_decompress(const uint8_t *ptr, void *dst, uint8_t color_shift)
+{
+    return background_codec_decode(background_asset_codec(ptr), &ptr[2048+8],
+                                   background_asset_compressed_size(ptr), (uint8_t *)dst, color_shift);
+}
+
+//loads count colors of the asset's 24-bit palette into CRAM palette number,
+//starting from color first, with a single CRAM update
+void background_asset_set_palette(const uint8_t *ptr, int number, int first, int count)
+{
+    int compressed_size_sectors = ((background_asset_compressed_size(ptr)-1)/2048)+1;
+    const uint8_t *palette = &ptr[2048*compressed_size_sectors+2048];
+    rgb888_t colors[256];
+    for (int i = 0; i<count; i++)
+    {
+        colors[i].cc = 0;
+        colors[i].r = palette[i*3+0];
+        colors[i].g = palette[i*3+1];
+        colors[i].b = palette[i*3+2];
+    }
+    video_vdp2_set_palette_part(number, colors, first, first+count-1);
+}
+
 void 
 background_set_from_assets(uint8_t *ptr, int size, int *names_ptr, int *data_ptr)
 {
@@ -56,17 +111,10 @@ background_set_from_assets(uint8_t *ptr, int size, int *names_ptr, int *data_ptr
     //clear background palette to hide loading
     video_vdp2_clear_palette(1);
 
-    //reading 2nd block to check if compressed
-    if ( (ptr[2048] == 'L') && (ptr[2048+1] == 'Z') && (ptr[2048+2] == '7') && (ptr[2048+3] == '7') )
+    //reading 2nd block to check the codec
+    if (background_asset_supported(ptr))
     {
         //compressed, decompressing
-        //getting size
-        int * p32 = (int *)(&ptr[2048]);
-        int compressed_size = p32[1];
-        assert(compressed_size > 0);
-        assert(compressed_size < 0x1000000);
-        int compressed_size_sectors = ((compressed_size-1)/2048)+1;
-    
         //writing pattern names for nbg0
         int *_pointer32 = (int *)names_ptr;
         int vram_offset = (int)data_ptr - VDP2_VRAM_ADDR(0,0);
@@ -88,18 +136,10 @@ background_set_from_assets(uint8_t *ptr, int size, int *names_ptr, int *data_ptr
         }
         
         //decompress
-        bcl_lz_decompress(&(ptr[2048+8]),(char*)data_ptr,compressed_size);
+        background_asset_decompress(ptr,data_ptr,0);
 
         //set palette, using palette 1 for VDP2 backgrounds
-        //palette in file is 24-bit, setting it color-by-color
-        rgb888_t _color  = {0,0,0,0};
-        for (int i = 0; i<256; i++)
-        {
-            _color.r = ptr[2048*compressed_size_sectors+2048+i*3+0];//palette[i*3+0];
-            _color.g = ptr[2048*compressed_size_sectors+2048+i*3+1];//palette[i*3+1];
-            _color.b = ptr[2048*compressed_size_sectors+2048+i*3+2];//palette[i*3+2];
-            video_vdp2_set_palette_part(1, &_color, i, i);
-        }
+        background_asset_set_palette(ptr,1,0,256);
     }
     else
     {
@@ -280,16 +320,13 @@ void draw_bg_with_expansion(video_screen_mode_t screenmode, bool bMascot)
 		mascot_y = ( (VIDEO_SCANMODE_480I == screenmode.scanmode) || (VIDEO_SCANMODE_480P == screenmode.scanmode) ) ? (mascot_y+9)*2 : mascot_y;
 		//copy mascot patterns, adding 128 to each color
 		//decompress
-		int * p32 = (int *)(&asset_mascot_bg[2048]);
-		int compressed_size = p32[1];
-		int compressed_size_sectors = ((compressed_size-1)/2048)+1;
 		if (is_screenmode_special(screenmode))
 		{
-			bcl_lz_decompress(&(asset_mascot_bg[2048+8]),(char*)(VIDEO_VDP2_NBG0_SPECIAL_CHPNDR_START+0x12C00),compressed_size);
-			bcl_lz_decompress(&(asset_mascot_bg[2048+8]),(char*)(VIDEO_VDP2_NBG1_SPECIAL_CHPNDR_START+0x12C00),compressed_size);
+			background_asset_decompress(asset_mascot_bg,(void*)(VIDEO_VDP2_NBG0_SPECIAL_CHPNDR_START+0x12C00),0);
+			background_asset_decompress(asset_mascot_bg,(void*)(VIDEO_VDP2_NBG1_SPECIAL_CHPNDR_START+0x12C00),0);
 		}
 		else
-			bcl_lz_decompress(&(asset_mascot_bg[2048+8]),(char*)(VIDEO_VDP2_NBG0_CHPNDR_START+0x12C00),compressed_size);
+			background_asset_decompress(asset_mascot_bg,(void*)(VIDEO_VDP2_NBG0_CHPNDR_START+0x12C00),0);
 		//fill mascot pattern names 
 		int size_x = 7;
 		for (int copy = 0; copy < copies; copy++)
@@ -310,15 +347,7 @@ void draw_bg_with_expansion(video_screen_mode_t screenmode, bool bMascot)
 			}
 		}
 		//set palette, using palette 3 for mascot
-		//palette in file is 24-bit, setting it color-by-color
-		rgb888_t _color  = {0,0,0,0};
-		for (int i = 0; i<256; i++)
-		{
-			_color.r = asset_mascot_bg[2048*compressed_size_sectors+2048+i*3+0];//palette[i*3+0];
-			_color.g = asset_mascot_bg[2048*compressed_size_sectors+2048+i*3+1];//palette[i*3+1];
-			_color.b = asset_mascot_bg[2048*compressed_size_sectors+2048+i*3+2];//palette[i*3+2];
-			video_vdp2_set_palette_part(3, &_color, i, i);
-		}
+		background_asset_set_palette(asset_mascot_bg,3,0,256);
 	}
 
     video_vdp2_set_cycle_patterns_nbg(screenmode);
@@ -5,6 +5,9 @@
 
 void background_fade_to_black_step();
 void background_fade_to_black();
+bool background_asset_supported(const uint8_t *ptr);
+int background_asset_decompress(const uint8_t *ptr, void *dst, uint8_t color_shift);
+void background_asset_set_palette(const uint8_t *ptr, int number, int first, int count);
 void background_set_from_assets(uint8_t *ptr, int size, int *names_ptr, int *data_ptr);
 void draw_bg_with_expansion(video_screen_mode_t screenmode, bool bMascot);
 void draw_bg_donna(video_screen_mode_t screenmode);
@@ -0,0 +1,190 @@
+#include <string.h>
+#include "background_codec.h"
+
+//No yaul dependencies here, tools/bgconv builds this file for the host.
+
+static inline uint8_t codec_shift(uint8_t pixel, uint8_t color_shift)
+{
+    return pixel ? pixel + color_shift : pixel;
+}
+
+//---------------------------------------------- LZ77 -----------------------------------------------------
+//first byte is the marker, marker 0 is an escaped marker literal, otherwise
+//marker is followed by length and offset as big-endian 7-bit groups
+static unsigned int codec_lz77_read_var_size(const uint8_t **in)
+{
+    unsigned int value = 0;
+    uint8_t b;
+    do
+    {
+        b = *(*in)++;
+        value = (value << 7) | (b & 0x7F);
+    }
+    while (b & 0x80);
+    return value;
+}
+
+static uint8_t *codec_lz77_decode(const uint8_t *in, const uint8_t *in_end, uint8_t *out, uint8_t color_shift)
+{
+    uint8_t marker = *in++;
+    while (in < in_end)
+    {
+        uint8_t symbol = *in++;
+        if ( (symbol == marker) && (*in != 0) )
+        {
+            unsigned int length = codec_lz77_read_var_size(&in);
+            unsigned int offset = codec_lz77_read_var_size(&in);
+            const uint8_t *from = out - offset;
+            while (length--)
+                *out++ = *from++;
+        }
+        else
+        {
+            if (symbol == marker)
+                in++; //escaped marker literal
+            *out++ = codec_shift(symbol, color_shift);
+        }
+    }
+    return out;
+}
+
+//---------------------------------------------- LZ4 ------------------------------------------------------
+//token high nibble is the literal count, low nibble the match length - 4,
+//15 means more length bytes follow, each 255 continuing the count. the
+//offset is 16-bit little-endian. the last sequence has no match
+static unsigned int codec_lz4_read_length(const uint8_t **in, unsigned int length)
+{
+    if (length == 15)
+    {
+        uint8_t b;
+        do
+        {
+            b = *(*in)++;
+            length += b;
+        }
+        while (b == 255);
+    }
+    return length;
+}
+
+static uint8_t *codec_lz4_decode(const uint8_t *in, const uint8_t *in_end, uint8_t *out, uint8_t color_shift)
+{
+    while (in < in_end)
+    {
+        uint8_t token = *in++;
+        unsigned int literals = codec_lz4_read_length(&in, token >> 4);
+        if (color_shift)
+        {
+            for (unsigned int i = 0; i < literals; i++)
+                out[i] = codec_shift(in[i], color_shift);
+        }
+        else
+            memcpy(out, in, literals);
+        out += literals;
+        in += literals;
+        if (in >= in_end)
+            break;
+
+        unsigned int offset = in[0] | (in[1] << 8);
+        in += 2;
+        unsigned int length = codec_lz4_read_length(&in, token & 0x0F) + 4;
+        const uint8_t *from = out - offset;
+        if (offset >= length)
+        {
+            memcpy(out, from, length);
+            out += length;
+        }
+        else
+        {
+            while (length--)
+                *out++ = *from++;
+        }
+    }
+    return out;
+}
+
+//---------------------------------------------- RLE ------------------------------------------------------
+//PackBits: n < 128 is followed by n+1 literal bytes, n > 128 repeats the next byte 257-n times
+size_t background_codec_rle_encode(const uint8_t *src, size_t size, uint8_t *dst, size_t literal_tail)
+{
+    size_t limit = (size > literal_tail) ? size - literal_tail : 0;
+    size_t in = 0, out = 0;
+    while (in < size)
+    {
+        size_t run = 1;
+        while ( (in + run < limit) && (run < 128) && (src[in + run] == src[in]) )
+            run++;
+        if ( (run > 1) && (in < limit) )
+        {
+            if (dst)
+            {
+                dst[out] = 257 - run;
+                dst[out+1] = src[in];
+            }
+            out += 2;
+            in += run;
+        }
+        else
+        {
+            size_t literal = 1;
+            while ( (in + literal < size) && (literal < 128) &&
+                    ( (in + literal + 1 >= limit) || (src[in + literal] != src[in + literal + 1]) ) )
+                literal++;
+            if (dst)
+            {
+                dst[out] = literal - 1;
+                memcpy(&dst[out+1], &src[in], literal);
+            }
+            out += literal + 1;
+            in += literal;
+        }
+    }
+    return out;
+}
+
+static uint8_t *codec_rle_decode(const uint8_t *in, const uint8_t *in_end, uint8_t *out, uint8_t color_shift)
+{
+    while (in < in_end)
+    {
+        uint8_t n = *in++;
+        if (n < 128)
+        {
+            if (color_shift)
+            {
+                for (int i = 0; i <= n; i++)
+                    out[i] = codec_shift(in[i], color_shift);
+            }
+            else
+                memcpy(out, in, n + 1);
+            out += n + 1;
+            in += n + 1;
+        }
+        else if (n > 128)
+        {
+            memset(out, codec_shift(*in++, color_shift), 257 - n);
+            out += 257 - n;
+        }
+    }
+    return out;
+}
+
+int background_codec_decode(uint32_t codec, const uint8_t *src, size_t size, uint8_t *dst, uint8_t color_shift)
+{
+    const uint8_t *src_end = src + size;
+    uint8_t *end;
+    switch (codec)
+    {
+        case BACKGROUND_CODEC_LZ77:
+            end = codec_lz77_decode(src, src_end, dst, color_shift);
+            break;
+        case BACKGROUND_CODEC_LZ4:
+            end = codec_lz4_decode(src, src_end, dst, color_shift);
+            break;
+        case BACKGROUND_CODEC_RLE:
+            end = codec_rle_decode(src, src_end, dst, color_shift);
+            break;
+        default:
+            return -1;
+    }
+    return (int)(end - dst);
+}
@@ -0,0 +1,24 @@
+#ifndef BACKGROUND_CODEC_H
+#define BACKGROUND_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//codec tag stored big-endian at byte 2048 of a .BG file, the compressed
+//size follows it and the stream starts at byte 2056
+#define BACKGROUND_CODEC_LZ77 0x4C5A3737 //"LZ77" BCL LZ77, best ratio
+#define BACKGROUND_CODEC_LZ4  0x4C5A3442 //"LZ4B" LZ4 block, byte aligned tokens, fastest on SH-2
+#define BACKGROUND_CODEC_RLE  0x524C4538 //"RLE8" PackBits, for flat images
+
+// Decodes size bytes of compressed stream into dst, which may be VRAM.
+// color_shift is added to every non-zero pixel as it is written; back
+// references copy output that is already shifted. Returns the number of
+// bytes written, or -1 for an unknown codec.
+int background_codec_decode(uint32_t codec, const uint8_t *src, size_t size, uint8_t *dst, uint8_t color_shift);
+
+// PackBits encoder behind BACKGROUND_CODEC_RLE, also used by the raster4
+// cache. The last literal_tail bytes are stored as literals. With a NULL
+// dst only the packed size is returned.
+size_t background_codec_rle_encode(const uint8_t *src, size_t size, uint8_t *dst, size_t literal_tail);
+
+#endif /* !BACKGROUND_CODEC_H */
@@ -22,6 +22,7 @@
 #include <yaul.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "font.h"
 #include "video_vdp2.h"
@@ -80,77 +81,146 @@ void SetFontPalette()
 		*(pFont++) = SuiteFont[i];*/
 }
 
-void ClearText(int left, int top, int width, int height)
+//glyphs expanded to 8bpp on first use, one 8 pixel row as two words with
+//the leftmost pixel in the top byte
+static uint32_t _font_atlas[96][8][2];
+static uint8_t *_font_texture = NULL;
+
+//the VDP1 partitions are set once by video_vdp1_init() and never move
+static void font_prepare()
 {
-	uint8_t *p8_vram;
-	vdp1_vram_partitions_t vdp1_vram_partitions;
-    vdp1_vram_partitions_get(&vdp1_vram_partitions);
-	
-	//drawing in low res for now
-	for (int _y = top; ( (_y < FONT_QUAD_HEIGHT) && (_y < top+height) ) ; _y++)
+	if (_font_texture)
+		return;
+	for (int c = 0; c < 96; c++)
 	{
-		p8_vram = (uint8_t *)(vdp1_vram_partitions.texture_base + _y*FONT_QUAD_WIDTH);
-		for (int _x = left; ( (_x < FONT_QUAD_WIDTH) && (_x < left+width) ) ; _x++)
+		for (int _y = 0; _y < 8; _y++)
 		{
-			p8_vram[_x] = 0;
+			const uint8_t *p8_char = &(SuiteFont[c*32+_y*4]);
+			for (int w = 0; w < 2; w++)
+			{
+				uint32_t row = 0;
+				for (int _x = 0; _x < 2; _x++)
+				{
+					uint8_t pair = p8_char[w*2+_x];
+					row = (row << 16) | (((pair>>4)&0x3) << 8) | (pair&0x3);
+				}
+				_font_atlas[c][_y][w] = row;
+			}
 		}
 	}
+	vdp1_vram_partitions_t vdp1_vram_partitions;
+	vdp1_vram_partitions_get(&vdp1_vram_partitions);
+	_font_texture = (uint8_t *)(vdp1_vram_partitions.texture_base);
 }
 
-void ClearTextLayer()
+//replaces the bytes of *dst selected by mask, fully transparent words are not touched
+static inline void font_blend(uint32_t *dst, uint32_t value, uint32_t mask)
 {
-	ClearText(0,0,FONT_QUAD_WIDTH,FONT_QUAD_HEIGHT);
+	if (mask)
+		*dst = (*dst & ~mask) | value;
 }
 
-/* Draw a char as VDP1 sprite at desired location*/
-void DrawChar(unsigned int x, unsigned int y, char c, unsigned int palette, bool transparent) 
+//one glyph row at any byte alignment, the shifts are constant per case
+static inline void font_blit_row(uint8_t *p8_vram, uint32_t v0, uint32_t v1, uint32_t m0, uint32_t m1)
 {
-	vdp1_vram_partitions_t vdp1_vram_partitions;
-    vdp1_vram_partitions_get(&vdp1_vram_partitions);
+	uint32_t *p32_vram = (uint32_t *)((uintptr_t)p8_vram & ~3);
+	switch ((uintptr_t)p8_vram & 3)
+	{
+		case 0:
+			font_blend(&p32_vram[0], v0, m0);
+			font_blend(&p32_vram[1], v1, m1);
+			break;
+		case 1:
+			font_blend(&p32_vram[0], v0 >> 8, m0 >> 8);
+			font_blend(&p32_vram[1], (v0 << 24) | (v1 >> 8), (m0 << 24) | (m1 >> 8));
+			font_blend(&p32_vram[2], v1 << 24, m1 << 24);
+			break;
+		case 2:
+			font_blend(&p32_vram[0], v0 >> 16, m0 >> 16);
+			font_blend(&p32_vram[1], (v0 << 16) | (v1 >> 16), (m0 << 16) | (m1 >> 16));
+			font_blend(&p32_vram[2], v1 << 16, m1 << 16);
+			break;
+		case 3:
+			font_blend(&p32_vram[0], v0 >> 24, m0 >> 24);
+			font_blend(&p32_vram[1], (v0 << 8) | (v1 >> 24), (m0 << 8) | (m1 >> 24));
+			font_blend(&p32_vram[2], v1 << 8, m1 << 8);
+			break;
+	}
+}
 
-	//drawing in low res for now
-	uint8_t *p8_vram;
-	uint8_t *p8_char;
-	uint8_t tmp;
+//pixels are 0-3, every non-zero byte becomes 0xFF
+static inline uint32_t font_mask(uint32_t row)
+{
+	return ((row | (row >> 1)) & 0x01010101) * 0xFF;
+}
+
+static void font_draw_glyph(unsigned int x, unsigned int y, char c, unsigned int palette)
+{
+	unsigned int index = (unsigned char)(c-32);
+	const uint32_t (*glyph)[2] = _font_atlas[(index < 96) ? index : 0];
+	uint32_t color = palette*4*0x01010101;
+	uint8_t *p8_vram = _font_texture + x + y*FONT_QUAD_WIDTH;
 	for (int _y = 0; _y < 8; _y++)
 	{
-		p8_vram = (uint8_t *)(vdp1_vram_partitions.texture_base + x + (_y+y)*FONT_QUAD_WIDTH);
-		p8_char =  &(SuiteFont[(c-32)*32+_y*4]);
-		for (int _x = 0; _x < 4; _x++)
-		{
-			tmp = p8_char[_x]&0x3;
-			if (tmp) p8_vram[_x*2+1] = tmp | palette*4;
-			tmp = (p8_char[_x]>>4)&0x3;
-			if (tmp) p8_vram[_x*2] = tmp | palette*4;
-		}
+		uint32_t m0 = font_mask(glyph[_y][0]);
+		uint32_t m1 = font_mask(glyph[_y][1]);
+		font_blit_row(p8_vram, glyph[_y][0] | (color & m0), glyph[_y][1] | (color & m1), m0, m1);
+		p8_vram += FONT_QUAD_WIDTH;
 	}
 }
 
+void ClearText(int left, int top, int width, int height)
+{
+	font_prepare();
+	if (left+width > FONT_QUAD_WIDTH)
+		width = FONT_QUAD_WIDTH - left;
+	if (width <= 0)
+		return;
+	
+	//drawing in low res for now
+	for (int _y = top; ( (_y < FONT_QUAD_HEIGHT) && (_y < top+height) ) ; _y++)
+		memset(_font_texture + _y*FONT_QUAD_WIDTH + left, 0, width);
+}
+
+void ClearTextLayer()
+{
+	ClearText(0,0,FONT_QUAD_WIDTH,FONT_QUAD_HEIGHT);
+}
+
+/* Draw a char as VDP1 sprite at desired location*/
+void DrawChar(unsigned int x, unsigned int y, char c, unsigned int palette, bool transparent) 
+{
+	font_prepare();
+	font_draw_glyph(x, y, c, palette);
+}
+
 /* Print a string at x, y using single VDP1 sprite*/
 void DrawString(char *str, unsigned int x, unsigned int y, unsigned int palette)
 {
 	int orig_x = x;
 	int orig_pal = palette;
-	unsigned int i;
 	int highlight = 0;
 
-	for(i = 0; i < strlen(str); i++)
+	font_prepare();
+	for (const char *p = str; *p; p++)
 	{
-		if(str[i] == '\n')
+		if(*p == '\n')
 		{
 			x = orig_x;
 			y += _fh;
-			i++;
+			if (!*++p)
+				break;
 		}
 
-		if(str[i] == '#')
+		if(*p == '#')
 		{
 			highlight = !highlight;
-			i++;
+			if (!*++p)
+				break;
 			
 			if(highlight)
 			{
-				switch(str[i])
+				switch(*p)
 				{
 					case 'R':
 						palette = FONT_RED;
@@ -171,36 +241,22 @@ void DrawString(char *str, unsigned int x, unsigned int y, unsigned int palette)
 			}
 			else
 				palette = orig_pal;
-			i++;
+			if (!*++p)
+				break;
 		}
 
-		DrawChar(x, y, str[i], palette, true);
+		font_draw_glyph(x, y, *p, palette);
 		x += _fw;
 	}
 }
 
 void DrawStringWithBackground(char *str, unsigned int x, unsigned int y, unsigned int palette, unsigned int bg_palette)
 {
-	int orig_x = x;
-	int orig_pal = palette;
-	unsigned int i;
-	int highlight = 0;
-	int _x,_y;
-	uint8_t *p8_vram;
-	uint8_t *p8_char;
-	uint8_t tmp;
-	vdp1_vram_partitions_t vdp1_vram_partitions;
-    vdp1_vram_partitions_get(&vdp1_vram_partitions);
+	int width = _fw*(strlen(str)+1)/2*2;
+	font_prepare();
 	
-	for (_y = 0; _y < _fh; _y++)
-	{
-		p8_vram = (uint8_t *)(vdp1_vram_partitions.texture_base + x + (_y+y-1)*FONT_QUAD_WIDTH);
-		for (_x = 0; _x < _fw*(strlen(str)+1)/2; _x++)
-		{
-			p8_vram[_x*2+1] = 0x1 | bg_palette*4;
-			p8_vram[_x*2] = 0x1 | bg_palette*4;
-		}
-	}
+	for (int _y = 0; _y < _fh; _y++)
+		memset(_font_texture + x + (_y+y-1)*FONT_QUAD_WIDTH, 0x1 | bg_palette*4, width);
 
 	DrawString(str,x,y,palette);
 }
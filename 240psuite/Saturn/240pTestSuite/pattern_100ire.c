@@ -49,8 +49,8 @@ void draw_100ire(video_screen_mode_t screenmode, int ire_level)
 	{
 		for (int j=0; j<16; j++)
 		{
-			_pointer32[copy][16+j] = 0x01010101;
-			_pointer32[copy][32+j] = 0x02020202;
+			VIDEO_VDP2_WRITE32(&_pointer32[copy][16+j], 0x01010101);
+			VIDEO_VDP2_WRITE32(&_pointer32[copy][32+j], 0x02020202);
 		}
 	}
 	//fill everything with our black tile
@@ -67,7 +67,7 @@ void draw_100ire(video_screen_mode_t screenmode, int ire_level)
 	{
     	for (unsigned int i = 0; i < VIDEO_VDP2_NBG0_PNDR_SIZE / sizeof(int); i++)
     	{
-    	    _pointer32[copy][i] = 0x00200004 + vram_offset[copy]/32; //palette 2
+    	    VIDEO_VDP2_WRITE32(&_pointer32[copy][i], 0x00200004 + vram_offset[copy]/32); //palette 2
     	}
 	}
 	//fill center with white tile
@@ -82,7 +82,7 @@ void draw_100ire(video_screen_mode_t screenmode, int ire_level)
 		{
 			for (int j=y_start; j<y_start*3; j++)
 			{
-				_pointer32[copy][64*j + i] = 0x00200002 + vram_offset[copy]/32; //palette 2
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*j + i], 0x00200002 + vram_offset[copy]/32); //palette 2
 			}
 		}
 	}
@@ -53,7 +53,7 @@ void draw_colorbars(video_screen_mode_t screenmode)
 	for (int copy = 0; copy < copies; copy++)
 		for (int i=1; i<129; i++)
 			for (int j=0; j<16; j++)
-				_pointer32[copy][i*16+j] = 0x01010101*i;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][i*16+j], 0x01010101u*i);
 	//fill everything with pitch-black
     _pointer32[0] = (int *)VIDEO_VDP2_NBG0_PNDR_START;
 	vram_offset[0] = VIDEO_VDP2_NBG0_CHPNDR_START - VDP2_VRAM_ADDR(0,0);
@@ -68,7 +68,7 @@ void draw_colorbars(video_screen_mode_t screenmode)
 	{
 		for (unsigned int i = 0; i < VIDEO_VDP2_NBG0_PNDR_SIZE / sizeof(int); i++)
 		{
-			_pointer32[copy][i] = 0x00200002 + vram_offset[copy]/32; //palette 2, transparency on, black color from red gradient
+			VIDEO_VDP2_WRITE32(&_pointer32[copy][i], 0x00200002 + vram_offset[copy]/32); //palette 2, transparency on, black color from red gradient
 		}
 	}
 	//draw bars depending on screen mode
@@ -85,17 +85,17 @@ void draw_colorbars(video_screen_mode_t screenmode)
 				{
 					if (offset+i < 64)
 					{
-						_pointer32[copy][64*(3+j) + offset + i] = 0x00200000 + (i/2+1)*2 + vram_offset[copy]/32; //palette 2, red
-						_pointer32[copy][64*(3+5*y_ratio+j) + offset + i] = 0x00200000 + (i/2+33)*2 + vram_offset[copy]/32; //palette 2, green
-						_pointer32[copy][64*(3+10*y_ratio+j) + offset + i] = 0x00200000 + (i/2+65)*2 + vram_offset[copy]/32; //palette 2, blue
-						_pointer32[copy][64*(3+15*y_ratio+j) + offset + i] = 0x00200000 + (i/2+97)*2 + vram_offset[copy]/32; //palette 2, black
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+j) + offset + i], 0x00200000 + (i/2+1)*2 + vram_offset[copy]/32); //palette 2, red
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+5*y_ratio+j) + offset + i], 0x00200000 + (i/2+33)*2 + vram_offset[copy]/32); //palette 2, green
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+10*y_ratio+j) + offset + i], 0x00200000 + (i/2+65)*2 + vram_offset[copy]/32); //palette 2, blue
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+15*y_ratio+j) + offset + i], 0x00200000 + (i/2+97)*2 + vram_offset[copy]/32); //palette 2, black
 					}
 					else
 					{
-						_pointer32[copy][64*63+64*(3+j) + offset + i] = 0x00200000 + (i/2+1)*2 + vram_offset[copy]/32; //palette 2, red
-						_pointer32[copy][64*63+64*(3+5*y_ratio+j) + offset + i] = 0x00200000 + (i/2+33)*2 + vram_offset[copy]/32; //palette 2, green
-						_pointer32[copy][64*63+64*(3+10*y_ratio+j) + offset + i] = 0x00200000 + (i/2+65)*2 + vram_offset[copy]/32; //palette 2, blue
-						_pointer32[copy][64*63+64*(3+15*y_ratio+j) + offset + i] = 0x00200000 + (i/2+97)*2 + vram_offset[copy]/32; //palette 2, black
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*63+64*(3+j) + offset + i], 0x00200000 + (i/2+1)*2 + vram_offset[copy]/32); //palette 2, red
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*63+64*(3+5*y_ratio+j) + offset + i], 0x00200000 + (i/2+33)*2 + vram_offset[copy]/32); //palette 2, green
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*63+64*(3+10*y_ratio+j) + offset + i], 0x00200000 + (i/2+65)*2 + vram_offset[copy]/32); //palette 2, blue
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*63+64*(3+15*y_ratio+j) + offset + i], 0x00200000 + (i/2+97)*2 + vram_offset[copy]/32); //palette 2, black
 					}
 				}
 			}	
@@ -107,10 +107,10 @@ void draw_colorbars(video_screen_mode_t screenmode)
 			{
 				for (int j=0;j<4*y_ratio;j++)
 				{
-					_pointer32[copy][64*(3+j) + offset + i] = 0x00200000 + (i+1)*2 + vram_offset[copy]/32; //palette 2, red
-					_pointer32[copy][64*(3+5*y_ratio+j) + offset + i] = 0x00200000 + (i+33)*2 + vram_offset[copy]/32; //palette 2, green
-					_pointer32[copy][64*(3+10*y_ratio+j) + offset + i] = 0x00200000 + (i+65)*2 + vram_offset[copy]/32; //palette 2, blue
-					_pointer32[copy][64*(3+15*y_ratio+j) + offset + i] = 0x00200000 + (i+97)*2 + vram_offset[copy]/32; //palette 2, black
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+j) + offset + i], 0x00200000 + (i+1)*2 + vram_offset[copy]/32); //palette 2, red
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+5*y_ratio+j) + offset + i], 0x00200000 + (i+33)*2 + vram_offset[copy]/32); //palette 2, green
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+10*y_ratio+j) + offset + i], 0x00200000 + (i+65)*2 + vram_offset[copy]/32); //palette 2, blue
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+15*y_ratio+j) + offset + i], 0x00200000 + (i+97)*2 + vram_offset[copy]/32); //palette 2, black
 				}
 			}	
 		}
@@ -62,7 +62,7 @@ void draw_colorbars_grayscale(video_screen_mode_t screenmode, bool bIRE100)
 			_pointer32 = (uint32_t *)&(_pointer8[copy][y*512]);
 			for (int x=0;x<_size_x/4;x++)
 			{
-				_pointer32[x] = 0x11111111;
+				VIDEO_VDP2_WRITE32(&_pointer32[x], 0x11111111);
 			}
 		}
 	}
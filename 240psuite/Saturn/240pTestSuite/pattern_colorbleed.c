@@ -49,21 +49,21 @@ void draw_colorbleed(video_screen_mode_t screenmode, bool checkered)
 			for (int i=1; i<5; i++)
 				for (int j=0; j<16; j+=4)
 				{
-					_pointer32[copy][i*16+j] = 0x01000100*i;
-					_pointer32[copy][i*16+j+1] = 0x01000100*i;
-					_pointer32[copy][i*16+j+2] = 0x00010001*i;
-					_pointer32[copy][i*16+j+3] = 0x00010001*i;
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][i*16+j], 0x01000100*i);
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][i*16+j+1], 0x01000100*i);
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][i*16+j+2], 0x00010001*i);
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][i*16+j+3], 0x00010001*i);
 				}
 		}
 		else
 		{
 			for (int i=1; i<5; i++)
 				for (int j=0; j<16; j++)
-					_pointer32[copy][i*16+j] = 0x01000100*i;
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][i*16+j], 0x01000100*i);
 		}
 		//black tile
 		for (int j=0; j<16; j++)
-			_pointer32[copy][j] = 0x0;
+			VIDEO_VDP2_WRITE32(&_pointer32[copy][j], 0x0);
 	}
 	//fill everything with pitch-black
     _pointer32[0] = (int *)VIDEO_VDP2_NBG0_PNDR_START;
@@ -79,7 +79,7 @@ void draw_colorbleed(video_screen_mode_t screenmode, bool checkered)
 	{
 		for (unsigned int i = 0; i < VIDEO_VDP2_NBG0_PNDR_SIZE / sizeof(int); i++)
 		{
-			_pointer32[copy][i] = 0x00200000 + vram_offset[copy]/32; //palette 2, transparency on, black
+			VIDEO_VDP2_WRITE32(&_pointer32[copy][i], 0x00200000 + vram_offset[copy]/32); //palette 2, transparency on, black
 		}
 	}
 	//draw bars depending on screen mode
@@ -96,17 +96,17 @@ void draw_colorbleed(video_screen_mode_t screenmode, bool checkered)
 				{
 					if (offset+i < 64)
 					{
-						_pointer32[copy][64*(3+j) + offset + i] = 0x00200000 + 2 + vram_offset[copy]/32; //palette 2, red
-						_pointer32[copy][64*(3+5*y_ratio+j) + offset + i] = 0x00200000 + 4 + vram_offset[copy]/32; //palette 2, green
-						_pointer32[copy][64*(3+10*y_ratio+j) + offset + i] = 0x00200000 + 6 + vram_offset[copy]/32; //palette 2, blue
-						_pointer32[copy][64*(3+15*y_ratio+j) + offset + i] = 0x00200000 + 8 + vram_offset[copy]/32; //palette 2, white
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+j) + offset + i], 0x00200000 + 2 + vram_offset[copy]/32); //palette 2, red
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+5*y_ratio+j) + offset + i], 0x00200000 + 4 + vram_offset[copy]/32); //palette 2, green
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+10*y_ratio+j) + offset + i], 0x00200000 + 6 + vram_offset[copy]/32); //palette 2, blue
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+15*y_ratio+j) + offset + i], 0x00200000 + 8 + vram_offset[copy]/32); //palette 2, white
 					}
 					else
 					{
-						_pointer32[copy][64*63+64*(3+j) + offset + i] = 0x00200000 + 2 + vram_offset[copy]/32; //palette 2, red
-						_pointer32[copy][64*63+64*(3+5*y_ratio+j) + offset + i] = 0x00200000 + 4 + vram_offset[copy]/32; //palette 2, green
-						_pointer32[copy][64*63+64*(3+10*y_ratio+j) + offset + i] = 0x00200000 + 6 + vram_offset[copy]/32; //palette 2, blue
-						_pointer32[copy][64*63+64*(3+15*y_ratio+j) + offset + i] = 0x00200000 + 8 + vram_offset[copy]/32; //palette 2, white
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*63+64*(3+j) + offset + i], 0x00200000 + 2 + vram_offset[copy]/32); //palette 2, red
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*63+64*(3+5*y_ratio+j) + offset + i], 0x00200000 + 4 + vram_offset[copy]/32); //palette 2, green
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*63+64*(3+10*y_ratio+j) + offset + i], 0x00200000 + 6 + vram_offset[copy]/32); //palette 2, blue
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*63+64*(3+15*y_ratio+j) + offset + i], 0x00200000 + 8 + vram_offset[copy]/32); //palette 2, white
 					}
 				}
 			}	
@@ -118,10 +118,10 @@ void draw_colorbleed(video_screen_mode_t screenmode, bool checkered)
 			{
 				for (int j=0;j<4*y_ratio;j++)
 				{
-					_pointer32[copy][64*(3+j) + offset + i] = 0x00200000 + 2 + vram_offset[copy]/32; //palette 2, red
-					_pointer32[copy][64*(3+5*y_ratio+j) + offset + i] = 0x00200000 + 4 + vram_offset[copy]/32; //palette 2, green
-					_pointer32[copy][64*(3+10*y_ratio+j) + offset + i] = 0x00200000 + 6 + vram_offset[copy]/32; //palette 2, blue
-					_pointer32[copy][64*(3+15*y_ratio+j) + offset + i] = 0x00200000 + 8 + vram_offset[copy]/32; //palette 2, black
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+j) + offset + i], 0x00200000 + 2 + vram_offset[copy]/32); //palette 2, red
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+5*y_ratio+j) + offset + i], 0x00200000 + 4 + vram_offset[copy]/32); //palette 2, green
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+10*y_ratio+j) + offset + i], 0x00200000 + 6 + vram_offset[copy]/32); //palette 2, blue
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+15*y_ratio+j) + offset + i], 0x00200000 + 8 + vram_offset[copy]/32); //palette 2, black
 				}
 			}	
 		}
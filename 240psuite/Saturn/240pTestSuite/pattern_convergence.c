@@ -65,7 +65,7 @@ void draw_convergence(video_screen_mode_t screenmode, int iPattern)
 			int line_start = y*128;
 			for (x=0;x<_size_x/4;x++)
 			{
-				_pointer32[copy][line_start+x] = 0x22222222;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][line_start+x], 0x22222222);
 			}
 		}
 	}
@@ -81,7 +81,7 @@ void draw_convergence(video_screen_mode_t screenmode, int iPattern)
 				{
 					int line_start = y*128;
 					for (x=0;x<_size_x/8;x++)
-						_pointer32[copy][line_start+x] = 0x11111111;
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][line_start+x], 0x11111111);
 				}
 				//vertical lines
 				for (y=0;y<_size_y;y++)
@@ -135,11 +135,15 @@ void draw_convergence(video_screen_mode_t screenmode, int iPattern)
 						if ((y/64)%2) color -= 2;
 						if (color < 3) color +=4;
 						color = color*0x11;
+						//quads are centered on the grid, clip them to the bitmap
 						for (int _y=0;_y<64;_y++)
 						{
+							if (y+_y-32 < 0 || y+_y-32 >= _size_y)
+								continue;
 							int line_start = (y+_y-32)*512;
 							for (int _x=0;_x<32;_x++)
-								_pointer8[copy][line_start+x+_x-16] = color;
+								if (x+_x-16 >= 0 && x+_x-16 < _size_x/2)
+									_pointer8[copy][line_start+x+_x-16] = color;
 						}
 					}
 			}
@@ -155,11 +159,15 @@ void draw_convergence(video_screen_mode_t screenmode, int iPattern)
 						if ((y/64)%2) color -= 2;
 						if (color < 3) color +=4;
 						color = color*0x11;
+						//quads are centered on the grid, clip them to the bitmap
 						for (int _y=0;_y<64;_y++)
 						{
+							if (y+_y-32 < 0 || y+_y-32 >= _size_y)
+								continue;
 							int line_start = (y+_y-32)*512;
 							for (int _x=0;_x<32;_x++)
-								_pointer8[copy][line_start+x+_x-16] = color;
+								if (x+_x-16 >= 0 && x+_x-16 < _size_x/2)
+									_pointer8[copy][line_start+x+_x-16] = color;
 						}
 					}
 				for (y=32;y<_size_y;y+=64)
@@ -8,6 +8,7 @@
 #include "control.h"
 #include "ire.h"
 #include "input.h"
+#include "pattern_table.h"
 
 void draw_ebu(video_screen_mode_t screenmode, bool bIRE100)
 {
@@ -42,45 +43,8 @@ void draw_ebu(video_screen_mode_t screenmode, bool bIRE100)
 	Color.b = IRE_bot;
 	video_vdp2_set_palette_part(2,&Color,8,8); //palette 2 color 8 = IRE black
 
-	int _size_x = get_screenmode_resolution_x(screenmode);
-	int _size_y = get_screenmode_resolution_y(screenmode);
-
-	int copies = 1;
-	uint8_t *_pointer8[2];
-	_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
-	if (is_screenmode_special(screenmode))
-	{
-		copies = 2;
-		_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
-		_pointer8[1] = (uint8_t *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START;
-	}
-
-	//draw bars
-	for (int copy = 0; copy < copies; copy++)
-	{
-		for (int i=0;i<8;i++)
-		{
-			uint8_t color = i+1;
-			for (int y=0;y<_size_y;y++)
-			{
-				int line_start = y*512;
-				for (int x=(_size_x*i)/8;x<(_size_x*(i+1))/8;x++)
-				{
-					if (x%2)
-					{
-						_pointer8[copy][line_start+x/2] &= 0xF0;
-						_pointer8[copy][line_start+x/2] |= color;
-					}
-					else
-					{
-						_pointer8[copy][line_start+x/2] &= 0x0F;
-						_pointer8[copy][line_start+x/2] |= color<<4;
-
-					}
-				}
-			}
-		}
-	}
+	//bars compiled by patc from patterns/ebu.pat
+	pattern_table_draw(pattern_table_ebu,screenmode,8);
 
 	video_vdp2_set_cycle_patterns_nbg_bmp(screenmode);
 }
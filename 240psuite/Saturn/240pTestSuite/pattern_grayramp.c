@@ -41,7 +41,7 @@ void draw_grayramp(video_screen_mode_t screenmode)
 	for (int copy = 0; copy < copies; copy++)
 		for (int i=1; i<33; i++)
 			for (int j=0; j<16; j++)
-				_pointer32[copy][i*16+j] = 0x01010101*i;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][i*16+j], 0x01010101*i);
 	//fill everything with pitch-black
     _pointer32[0] = (int *)VIDEO_VDP2_NBG0_PNDR_START;
 	vram_offset[0] = VIDEO_VDP2_NBG0_CHPNDR_START - VDP2_VRAM_ADDR(0,0);
@@ -54,7 +54,7 @@ void draw_grayramp(video_screen_mode_t screenmode)
 	}
     for (int copy = 0; copy < copies; copy++)
 		for (unsigned int i = 0; i < VIDEO_VDP2_NBG0_PNDR_SIZE / sizeof(int); i++)
-			_pointer32[copy][i] = 0x00200002 + vram_offset[copy]/32; //palette 2, transparency on, black from white gradient
+			VIDEO_VDP2_WRITE32(&_pointer32[copy][i], 0x00200002 + vram_offset[copy]/32); //palette 2, transparency on, black from white gradient
 
 	//draw bars depending on screen mode
 	int offset = (VIDEO_X_RESOLUTION_320 == screenmode.x_res) ? 6 : 10;
@@ -70,22 +70,22 @@ void draw_grayramp(video_screen_mode_t screenmode)
 				{
 					if (offset+i < 64)
 					{
-						_pointer32[copy][64*(3+j) + offset + i] = 0x00200000 + (i/2+1)*2 + vram_offset[copy]/32; //palette 2
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+j) + offset + i], 0x00200000 + (i/2+1)*2 + vram_offset[copy]/32); //palette 2
 					}
 					else
 					{
-						_pointer32[copy][64*63+64*(3+j) + offset + i] = 0x00200000 + (i/2+1)*2 + vram_offset[copy]/32; //palette 2
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*63+64*(3+j) + offset + i], 0x00200000 + (i/2+1)*2 + vram_offset[copy]/32); //palette 2
 					}
 				}
 				for (int j=12*y_ratio;j<24*y_ratio;j++)
 				{
 					if (offset+i < 64)
 					{
-						_pointer32[copy][64*(3+j) + offset + i] = 0x00200000 + (32-i/2)*2 + vram_offset[copy]/32; //palette 2
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+j) + offset + i], 0x00200000 + (32-i/2)*2 + vram_offset[copy]/32); //palette 2
 					}
 					else
 					{
-						_pointer32[copy][64*63+64*(3+j) + offset + i] = 0x00200000 + (32-i/2)*2 + vram_offset[copy]/32; //palette 2
+						VIDEO_VDP2_WRITE32(&_pointer32[copy][64*63+64*(3+j) + offset + i], 0x00200000 + (32-i/2)*2 + vram_offset[copy]/32); //palette 2
 					}
 				}
 			}	
@@ -97,11 +97,11 @@ void draw_grayramp(video_screen_mode_t screenmode)
 			{
 				for (int j=0;j<12*y_ratio;j++)
 				{
-					_pointer32[copy][64*(3+j) + offset + i] = 0x00200000 + (i+1)*2 + vram_offset[copy]/32; //palette 2
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+j) + offset + i], 0x00200000 + (i+1)*2 + vram_offset[copy]/32); //palette 2
 				}
 				for (int j=12*y_ratio;j<24*y_ratio;j++)
 				{
-					_pointer32[copy][64*(3+j) + offset + i] = 0x00200000 + (32-i)*2 + vram_offset[copy]/32; //palette 2
+					VIDEO_VDP2_WRITE32(&_pointer32[copy][64*(3+j) + offset + i], 0x00200000 + (32-i)*2 + vram_offset[copy]/32); //palette 2
 				}
 			}	
 		}
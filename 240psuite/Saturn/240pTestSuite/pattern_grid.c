@@ -110,14 +110,14 @@ void draw_grid(video_screen_mode_t screenmode)
 		{
 			for (unsigned int x = 0; x < 32; x++)
 			{
-				_pointer32[copy][y*128+x*2] = 0x00200008 + vram_offset[copy]/32; 
-				_pointer32[copy][y*128+x*2+1] = 0x0020000A + vram_offset[copy]/32;
-				_pointer32[copy][y*128+64+x*2] = 0x0020000C + vram_offset[copy]/32; 
-				_pointer32[copy][y*128+64+x*2+1] = 0x0020000E + vram_offset[copy]/32;
-				_pointer32[copy][64*64+y*128+x*2] = 0x00200008 + vram_offset[copy]/32; 
-				_pointer32[copy][64*64+y*128+x*2+1] = 0x0020000A + vram_offset[copy]/32;
-				_pointer32[copy][64*64+y*128+64+x*2] = 0x0020000C + vram_offset[copy]/32; 
-				_pointer32[copy][64*64+y*128+64+x*2+1] = 0x0020000E + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+x*2], 0x00200008 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+x*2+1], 0x0020000A + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+64+x*2], 0x0020000C + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+64+x*2+1], 0x0020000E + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+y*128+x*2], 0x00200008 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+y*128+x*2+1], 0x0020000A + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+y*128+64+x*2], 0x0020000C + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+y*128+64+x*2+1], 0x0020000E + vram_offset[copy]/32);
 			}
 		}
 	}
@@ -132,45 +132,45 @@ void draw_grid(video_screen_mode_t screenmode)
 			for (int x=0; x<32; x++)
 			{
 				//top
-				_pointer32[copy][x*2] = 0x00200000 + vram_offset[copy]/32; 
-				_pointer32[copy][x*2+1] = 0x00200002 + vram_offset[copy]/32;
-				_pointer32[copy][x*2+64] = 0x00200004 + vram_offset[copy]/32; 
-				_pointer32[copy][x*2+64+1] = 0x00200006 + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][x*2], 0x00200000 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][x*2+1], 0x00200002 + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][x*2+64], 0x00200004 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][x*2+64+1], 0x00200006 + vram_offset[copy]/32);
 				//bottom
-				_pointer32[copy][128*_size_y-128+x*2] = 0x00200000 + vram_offset[copy]/32; 
-				_pointer32[copy][128*_size_y-128+x*2+1] = 0x00200002 + vram_offset[copy]/32;
-				_pointer32[copy][128*_size_y-128+x*2+64] = 0x00200004 + vram_offset[copy]/32; 
-				_pointer32[copy][128*_size_y-128+x*2+64+1] = 0x00200006 + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][128*_size_y-128+x*2], 0x00200000 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][128*_size_y-128+x*2+1], 0x00200002 + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][128*_size_y-128+x*2+64], 0x00200004 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][128*_size_y-128+x*2+64+1], 0x00200006 + vram_offset[copy]/32);
 			}
 			for (int y=0; y<_size_y; y++)
 			{
 				//left
-				_pointer32[copy][y*128] = 0x00200000 + vram_offset[copy]/32; 
-				_pointer32[copy][y*128+1] = 0x00200002 + vram_offset[copy]/32;
-				_pointer32[copy][y*128+64] = 0x00200004 + vram_offset[copy]/32; 
-				_pointer32[copy][y*128+64+1] = 0x00200006 + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128], 0x00200000 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+1], 0x00200002 + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+64], 0x00200004 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+64+1], 0x00200006 + vram_offset[copy]/32);
 			}
 			//plane1
 			for (int x=0; x<(_size_x*2-32); x++)
 			{
 				//top
-				_pointer32[copy][64*64+x*2] = 0x00200000 + vram_offset[copy]/32; 
-				_pointer32[copy][64*64+x*2+1] = 0x00200002 + vram_offset[copy]/32;
-				_pointer32[copy][64*64+x*2+64] = 0x00200004 + vram_offset[copy]/32; 
-				_pointer32[copy][64*64+x*2+64+1] = 0x00200006 + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+x*2], 0x00200000 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+x*2+1], 0x00200002 + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+x*2+64], 0x00200004 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+x*2+64+1], 0x00200006 + vram_offset[copy]/32);
 				//bottom
-				_pointer32[copy][64*64+128*_size_y-128+x*2] = 0x00200000 + vram_offset[copy]/32; 
-				_pointer32[copy][64*64+128*_size_y-128+x*2+1] = 0x00200002 + vram_offset[copy]/32;
-				_pointer32[copy][64*64+128*_size_y-128+x*2+64] = 0x00200004 + vram_offset[copy]/32; 
-				_pointer32[copy][64*64+128*_size_y-128+x*2+64+1] = 0x00200006 + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+128*_size_y-128+x*2], 0x00200000 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+128*_size_y-128+x*2+1], 0x00200002 + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+128*_size_y-128+x*2+64], 0x00200004 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+128*_size_y-128+x*2+64+1], 0x00200006 + vram_offset[copy]/32);
 			}
 			for (int y=0; y<_size_y; y++)
 			{
 				//right
-				_pointer32[copy][64*64+y*128+(_size_x*4-64)-2] = 0x00200000 + vram_offset[copy]/32; 
-				_pointer32[copy][64*64+y*128+(_size_x*4-64)-1] = 0x00200002 + vram_offset[copy]/32;
-				_pointer32[copy][64*64+y*128+(_size_x*4-64)-2+64] = 0x00200004 + vram_offset[copy]/32; 
-				_pointer32[copy][64*64+y*128+(_size_x*4-64)-1+64] = 0x00200006 + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+y*128+(_size_x*4-64)-2], 0x00200000 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+y*128+(_size_x*4-64)-1], 0x00200002 + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+y*128+(_size_x*4-64)-2+64], 0x00200004 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][64*64+y*128+(_size_x*4-64)-1+64], 0x00200006 + vram_offset[copy]/32);
 			}
 		}
 		else
@@ -179,28 +179,28 @@ void draw_grid(video_screen_mode_t screenmode)
 			for (int x=0; x<_size_x; x++)
 			{
 				//top
-				_pointer32[copy][x*2] = 0x00200000 + vram_offset[copy]/32; 
-				_pointer32[copy][x*2+1] = 0x00200002 + vram_offset[copy]/32;
-				_pointer32[copy][x*2+64] = 0x00200004 + vram_offset[copy]/32; 
-				_pointer32[copy][x*2+64+1] = 0x00200006 + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][x*2], 0x00200000 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][x*2+1], 0x00200002 + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][x*2+64], 0x00200004 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][x*2+64+1], 0x00200006 + vram_offset[copy]/32);
 				//bottom
-				_pointer32[copy][128*_size_y-128+x*2] = 0x00200000 + vram_offset[copy]/32; 
-				_pointer32[copy][128*_size_y-128+x*2+1] = 0x00200002 + vram_offset[copy]/32;
-				_pointer32[copy][128*_size_y-128+x*2+64] = 0x00200004 + vram_offset[copy]/32; 
-				_pointer32[copy][128*_size_y-128+x*2+64+1] = 0x00200006 + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][128*_size_y-128+x*2], 0x00200000 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][128*_size_y-128+x*2+1], 0x00200002 + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][128*_size_y-128+x*2+64], 0x00200004 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][128*_size_y-128+x*2+64+1], 0x00200006 + vram_offset[copy]/32);
 			}
 			for (int y=0; y<_size_y; y++)
 			{
 				//left
-				_pointer32[copy][y*128] = 0x00200000 + vram_offset[copy]/32; 
-				_pointer32[copy][y*128+1] = 0x00200002 + vram_offset[copy]/32;
-				_pointer32[copy][y*128+64] = 0x00200004 + vram_offset[copy]/32; 
-				_pointer32[copy][y*128+64+1] = 0x00200006 + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128], 0x00200000 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+1], 0x00200002 + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+64], 0x00200004 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+64+1], 0x00200006 + vram_offset[copy]/32);
 				//right
-				_pointer32[copy][y*128+_size_x*2-2] = 0x00200000 + vram_offset[copy]/32; 
-				_pointer32[copy][y*128+_size_x*2-1] = 0x00200002 + vram_offset[copy]/32;
-				_pointer32[copy][y*128+_size_x*2-2+64] = 0x00200004 + vram_offset[copy]/32; 
-				_pointer32[copy][y*128+_size_x*2-1+64] = 0x00200006 + vram_offset[copy]/32;
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+_size_x*2-2], 0x00200000 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+_size_x*2-1], 0x00200002 + vram_offset[copy]/32);
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+_size_x*2-2+64], 0x00200004 + vram_offset[copy]/32); 
+				VIDEO_VDP2_WRITE32(&_pointer32[copy][y*128+_size_x*2-1+64], 0x00200006 + vram_offset[copy]/32);
 			}
 		}
 	}
@@ -8,6 +8,7 @@
 #include "control.h"
 #include "ire.h"
 #include "input.h"
+#include "video_raster4.h"
 
 #define COLOR_WHITE 1
 #define COLOR_RED 2
@@ -19,181 +20,47 @@ static video_screen_mode_t curr_screenmode;
 
 void draw_point(int x, int y, int color)
 {
-	int copies = 1;
-	uint8_t *_pointer8[2];
-	_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
-	if (is_screenmode_special(curr_screenmode))
-	{
-		copies = 2;
-		_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
-		_pointer8[1] = (uint8_t *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START;
-	}
-	for (int copy = 0; copy < copies; copy++)
-	{
-		if (x%2==1)
-		{
-			_pointer8[copy][y*512+x/2] |= 0x01*color;
-		}
-		else
-		{
-			_pointer8[copy][y*512+x/2] |= 0x10*color;
-		}
-	}
+	video_raster4_or_pixel(x,y,color);
 }
 
 void draw_dotted_line(int x1, int x2, int y, int color)
 {
-	int copies = 1;
-	uint8_t *_pointer8[2];
-	_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
-	if (is_screenmode_special(curr_screenmode))
+	//a dot on the even pixel and a gap on the odd one, starting from the byte holding x1
+	for (int _x = x1; _x < x2; _x += 2)
 	{
-		copies = 2;
-		_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
-		_pointer8[1] = (uint8_t *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START;
-	}
-	for (int copy = 0; copy < copies; copy++)
-	{
-		int _x = x1;
-		while (_x<((x2/2)*2))
-		{
-			_pointer8[copy][y*512+_x/2] &= 0xF0;
-			_pointer8[copy][y*512+_x/2] |= 0x10*color;
-			_x+=2;
-		}
-		if (_x<x2)
-		{
-			_pointer8[copy][y*512+_x/2] &= 0xF0;
-			_pointer8[copy][y*512+_x/2] |= 0x10*color;
-			_pointer8[copy][y*512+_x/2] |= 0x10*color;
-		}
+		video_raster4_or_pixel((_x/2)*2,y,color);
+		video_raster4_set_pixel((_x/2)*2+1,y,0);
 	}
 }
 
 void draw_rectangle(int x1, int y1, int x2, int y2, int color)
 {
-	int copies = 1;
-	uint8_t *_pointer8[2];
-	_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
-	if (is_screenmode_special(curr_screenmode))
-	{
-		copies = 2;
-		_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
-		_pointer8[1] = (uint8_t *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START;
-	}
-	for (int copy = 0; copy < copies; copy++)
+	video_raster4_or_span(x1,x2,y1,color);
+	video_raster4_or_span(x1,x2,y2,color);
+	for (int _y=y1;_y<=y2;_y++)
 	{
-		int _x = x1;
-		if (_x%2==1)
-		{
-			_pointer8[copy][y1*512+_x/2] |= 0x01*color;
-			_pointer8[copy][y2*512+_x/2] |= 0x01*color;
-			_x++;
-		}
-		while (_x<((x2/2)*2))
-		{
-			_pointer8[copy][y1*512+_x/2] |= 0x11*color;
-			_pointer8[copy][y2*512+_x/2] |= 0x11*color;
-			_x+=2;
-		}
-		if (_x<x2)
-		{
-			_pointer8[copy][y1*512+_x/2] |= 0x10*color;
-			_pointer8[copy][y2*512+_x/2] |= 0x10*color;
-		}
-		for (int _y=y1;_y<=y2;_y++)
-		{
-			if (x1%2==0)
-				_pointer8[copy][_y*512+x1/2] |= 0x10*color;
-			else
-				_pointer8[copy][_y*512+x1/2] |= 0x01*color;
-
-			if (x2%2==0)
-				_pointer8[copy][_y*512+x2/2] |= 0x10*color;
-			else
-				_pointer8[copy][_y*512+x2/2] |= 0x01*color;
-		}
+		video_raster4_or_pixel(x1,_y,color);
+		video_raster4_or_pixel(x2,_y,color);
 	}
 }
 
 void clear_rectangle(int x1, int y1, int x2, int y2)
 {
-	int copies = 1;
-	uint8_t *_pointer8[2];
-	_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
-	if (is_screenmode_special(curr_screenmode))
-	{
-		copies = 2;
-		_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
-		_pointer8[1] = (uint8_t *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START;
-	}
-	for (int copy = 0; copy < copies; copy++)
+	//for an odd x2 the horizontal edges stop at x2-2, x2 itself is cleared below
+	int _x2 = (x2%2) ? x2-2 : x2;
+	video_raster4_set_span(x1,_x2,y1,0);
+	video_raster4_set_span(x1,_x2,y2,0);
+	for (int _y=y1;_y<=y2;_y++)
 	{
-		int _x = x1;
-		if (_x%2==1)
-		{
-			_pointer8[copy][y1*512+_x/2] &= ~0x0F;
-			_pointer8[copy][y2*512+_x/2] &= ~0x0F;
-			_x++;
-		}
-		while (_x<((x2/2)*2))
-		{
-			_pointer8[copy][y1*512+_x/2] &= 0;
-			_pointer8[copy][y2*512+_x/2] &= 0;
-			_x+=2;
-		}
-		if (0==(x2%2))
-		{
-			_pointer8[copy][y1*512+_x/2] &= ~0xF0;
-			_pointer8[copy][y2*512+_x/2] &= ~0xF0;
-		}
-		for (int _y=y1;_y<=y2;_y++)
-		{
-			if (x1%2==0)
-				_pointer8[copy][_y*512+x1/2] &= ~0xF0;
-			else
-				_pointer8[copy][_y*512+x1/2] &= ~0x0F;
-
-			if (x2%2==0)
-				_pointer8[copy][_y*512+x2/2] &= ~0xF0;
-			else
-				_pointer8[copy][_y*512+x2/2] &= ~0x0F;
-		}
+		video_raster4_set_pixel(x1,_y,0);
+		video_raster4_set_pixel(x2,_y,0);
 	}
 }
 
 void clear_filled(int x1, int y1, int x2, int y2)
 {
-	int copies = 1;
-	uint8_t *_pointer8[2];
-	_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
-	if (is_screenmode_special(curr_screenmode))
-	{
-		copies = 2;
-		_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
-		_pointer8[1] = (uint8_t *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START;
-	}
-	for (int copy = 0; copy < copies; copy++)
-	{
-		for (int _y=y1;_y<=y2;_y++)
-		{
-			int _x = x1;
-			if (_x%2==1)
-			{
-				_pointer8[copy][_y*512+_x/2] &= ~0x0F;
-				_x++;
-			}
-			while (_x<x2)
-			{
-				_pointer8[copy][_y*512+_x/2] &= 0;
-				_x+=2;
-			}
-			if (0==(x2%2))
-			{
-				_pointer8[copy][_y*512+x2/2] &= ~0xF0;
-			}
-		}
-	}
+	for (int _y=y1;_y<=y2;_y++)
+		video_raster4_set_span(x1,x2,_y,0);
 }
 
 
@@ -308,18 +175,13 @@ void draw_monoscope(video_screen_mode_t screenmode, bool bIRE100)
 	int _size_x = get_screenmode_resolution_x(screenmode);
 	int _size_y = get_screenmode_resolution_y(screenmode);
 
-	//fill everything with black
-	int copies = 1;
-	uint8_t *_pointer8[2];
-	_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
-	if (is_screenmode_special(curr_screenmode))
+	//fill everything with black, or bring back the finished bitmap for this mode
+	if (video_raster4_begin_cached(screenmode,0,VIDEO_RASTER4_CACHE_MONOSCOPE))
 	{
-		copies = 2;
-		_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
-		_pointer8[1] = (uint8_t *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START;
+		video_raster4_end();
+		video_vdp2_set_cycle_patterns_nbg_bmp(screenmode);
+		return;
 	}
-	for (int copy = 0; copy < copies; copy++)
-		memset(_pointer8[copy],0x00,512*_size_y);
 
 	int cell_x=16;
 	int cell_y=16;
@@ -487,6 +349,7 @@ void draw_monoscope(video_screen_mode_t screenmode, bool bIRE100)
 	draw_dotted_line(_size_x/2+11,_size_x/2+rect_x/2+2,_size_y/2-4,COLOR_WHITE);
 	draw_dotted_line(_size_x/2+11,_size_x/2+rect_x/2+2,_size_y/2+3,COLOR_WHITE);
 
+	video_raster4_end();
 	video_vdp2_set_cycle_patterns_nbg_bmp(screenmode);
 }
 
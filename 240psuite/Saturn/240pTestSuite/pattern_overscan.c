@@ -65,7 +65,9 @@ void redraw_overscan(video_screen_mode_t screenmode, int top, int bottom, int le
 			memset(&(_pointer8[copy][y*512]), 0x11, 512);
 
 	//draw bot
-	for (int y=_size_y-bottom;y<_size_y;y++) memset(&(_pointer8[y*512]), 0x11, 512);
+	for (int copy = 0; copy < copies; copy++)
+		for (int y=_size_y-bottom;y<_size_y;y++)
+			memset(&(_pointer8[copy][y*512]), 0x11, 512);
 
 	//draw left
 	for (int copy = 0; copy < copies; copy++)
@@ -84,7 +86,7 @@ void redraw_overscan(video_screen_mode_t screenmode, int top, int bottom, int le
 	for (int copy = 0; copy < copies; copy++)
 	{
 		for (int y=0;y<_size_y;y++)
-			memset(&(_pointer8[y*512+_size_x/2-right/2]), 0x11, right/2);
+			memset(&(_pointer8[copy][y*512+_size_x/2-right/2]), 0x11, right/2);
 		if (right%2 == 1)
 			for (int y=0;y<_size_y;y++)
 			{
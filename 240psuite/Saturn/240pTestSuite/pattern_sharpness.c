@@ -8,6 +8,7 @@
 #include "control.h"
 #include "ire.h"
 #include "input.h"
+#include "video_raster4.h"
 
 uint8_t BrickPattern[64] = {
 	3,3,2,2,2,2,2,2,
@@ -24,28 +25,7 @@ static video_screen_mode_t curr_screenmode;
 
 void draw_pixel(int x, int y, int color)
 {
-	int copies = 1;
-	uint8_t *_pointer8[2];
-	_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
-	if (is_screenmode_special(curr_screenmode))
-	{
-		copies = 2;
-		_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
-		_pointer8[1] = (uint8_t *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START;
-	}
-	for (int copy = 0; copy < copies; copy++)
-	{
-		if (x%2)
-		{
-			_pointer8[copy][y*512+x/2] &= 0xF0;
-			_pointer8[copy][y*512+x/2] |= color;
-		}
-		else
-		{
-			_pointer8[copy][y*512+x/2] &= 0x0F;
-			_pointer8[copy][y*512+x/2] |= color<<4;
-		}
-	}
+	video_raster4_set_pixel(x,y,color);
 }
 
 void draw_sharpness(video_screen_mode_t screenmode, bool bIRE100)
@@ -75,29 +55,20 @@ void draw_sharpness(video_screen_mode_t screenmode, bool bIRE100)
 	int _size_x = get_screenmode_resolution_x(screenmode);
 	int _size_y = get_screenmode_resolution_y(screenmode);
 
-	int copies = 1;
-	uint8_t *_pointer8[2];
-	_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
-	if (is_screenmode_special(screenmode))
+	//fill with gray, or bring back the finished bitmap for this mode
+	if (video_raster4_begin_cached(screenmode,2,VIDEO_RASTER4_CACHE_SHARPNESS))
 	{
-		copies = 2;
-		_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
-		_pointer8[1] = (uint8_t *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START;
+		video_raster4_end();
+		video_vdp2_set_cycle_patterns_nbg_bmp(screenmode);
+		return;
 	}
 
-	//fill with gray
-	for (int copy = 0; copy < copies; copy++)
-		memset(_pointer8[copy], 0x22, _size_y*512);
-
 	//center horizontal bars
 	for (int i=0;i<5;i++)
 	{
 		for (y=(_size_y*(i+8)/20)-(i+1)/2;y<(_size_y*(i+8)/20)+(i+2)/2;y++)
 		{
-			for (x=(_size_x*7)/20;x<(_size_x*13)/20;x++)
-			{
-				draw_pixel(x,y,3);//using black color
-			}
+			video_raster4_set_span((_size_x*7)/20,(_size_x*13)/20-1,y,3);//using black color
 		}
 	}
 
@@ -183,15 +154,16 @@ void draw_sharpness(video_screen_mode_t screenmode, bool bIRE100)
 	}
 
 	//white borders
-	for (x=_size_x/29;x<_size_x-_size_x/29;x++) draw_pixel(x,_size_y/29,1);
-	for (x=_size_x/29;x<_size_x-_size_x/29;x++) draw_pixel(x,_size_y-_size_y/29,1);
+	video_raster4_set_span(_size_x/29,_size_x-_size_x/29-1,_size_y/29,1);
+	video_raster4_set_span(_size_x/29,_size_x-_size_x/29-1,_size_y-_size_y/29,1);
 	for (y=_size_y/29;y<_size_y-_size_y/29;y++) draw_pixel(_size_x/29,y,1);
 	for (y=_size_y/29;y<_size_y-_size_y/29;y++) draw_pixel(_size_x-_size_x/29,y,1);
-	for (x=_size_x/13;x<_size_x-_size_x/13;x++) draw_pixel(x,_size_y/13,1);
-	for (x=_size_x/13;x<_size_x-_size_x/13;x++) draw_pixel(x,_size_y-_size_y/13,1);
+	video_raster4_set_span(_size_x/13,_size_x-_size_x/13-1,_size_y/13,1);
+	video_raster4_set_span(_size_x/13,_size_x-_size_x/13-1,_size_y-_size_y/13,1);
 	for (y=_size_y/13;y<_size_y-_size_y/13;y++) draw_pixel(_size_x/13,y,1);
 	for (y=_size_y/13;y<_size_y-_size_y/13;y++) draw_pixel(_size_x-_size_x/13,y,1);
 
+	video_raster4_end();
 	video_vdp2_set_cycle_patterns_nbg_bmp(screenmode);
 }
 
@@ -229,6 +201,7 @@ void draw_sharpness_pattern2(video_screen_mode_t screenmode)
 		_pointer32[1] = (int *)VIDEO_VDP2_NBG1_SPECIAL_CHPNDR_START;
 	}
 	int *BrickPattern32 = (int *)BrickPattern;
+	//plain copy of a byte array, lands in VRAM in the same order either way
 	for (int copy = 0; copy < copies; copy++)
 		for (unsigned int i = 0; i < 16; i++)
 			_pointer32[copy][i] = BrickPattern32[i];
@@ -245,7 +218,7 @@ void draw_sharpness_pattern2(video_screen_mode_t screenmode)
 	}
 	for (int copy = 0; copy < copies; copy++)
     	for (unsigned int i = 0; i < VIDEO_VDP2_NBG0_PNDR_SIZE / sizeof(int); i++)
-        	_pointer32[copy][i] = 0x00200000 + vram_offset[copy]/32; //palette 2
+        	VIDEO_VDP2_WRITE32(&_pointer32[copy][i], 0x00200000 + vram_offset[copy]/32); //palette 2
 	video_vdp2_set_cycle_patterns_nbg(screenmode);
 }
 
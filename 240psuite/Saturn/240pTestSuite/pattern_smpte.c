@@ -8,6 +8,7 @@
 #include "control.h"
 #include "ire.h"
 #include "input.h"
+#include "pattern_table.h"
 
 void draw_smpte(video_screen_mode_t screenmode, bool bIRE100)
 {
@@ -62,148 +63,8 @@ void draw_smpte(video_screen_mode_t screenmode, bool bIRE100)
 	Color.b = Get_IRE_Level(11.5);	
 	video_vdp2_set_palette_part(2,&Color,13,13); //palette 2 color 13 = black+4
 
-	int _size_x = get_screenmode_resolution_x(screenmode);
-	int _size_y = get_screenmode_resolution_y(screenmode);
-
-	int copies = 1;
-	uint8_t *_pointer8[2];
-	_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
-	if (is_screenmode_special(screenmode))
-	{
-		copies = 2;
-		_pointer8[0] = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
-		_pointer8[1] = (uint8_t *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START;
-	}
-
-	//draw top bars
-	for (int copy = 0; copy < copies; copy++)
-		for (int i=0;i<7;i++)
-		{
-			uint8_t color = i+1;
-			for (int y=0;y<(_size_y*67)/100;y++)
-			{
-				int line_start = y*512;
-				for (int x=(_size_x*i)/7;x<(_size_x*(i+1))/7;x++)
-				{
-					if (x%2)
-					{
-						_pointer8[copy][line_start+x/2] &= 0xF0;
-						_pointer8[copy][line_start+x/2] |= color;
-					}
-					else
-					{
-						_pointer8[copy][line_start+x/2] &= 0x0F;
-						_pointer8[copy][line_start+x/2] |= color<<4;
-
-					}
-				}
-			}
-		}
-	//draw mid bars
-	for (int copy = 0; copy < copies; copy++)
-		for (int i=0;i<7;i++)
-		{
-			uint8_t icolor = (i%2) ? 8 : 7-i;
-			for (int y=(_size_y*67)/100;y<(_size_y*75)/100;y++)
-			{
-				int line_start = y*512;
-				for (int x=(_size_x*i)/7;x<(_size_x*(i+1))/7;x++)
-				{
-					if (x%2)
-					{
-						_pointer8[copy][line_start+x/2] &= 0xF0;
-						_pointer8[copy][line_start+x/2] |= icolor;
-					}
-					else
-					{
-						_pointer8[copy][line_start+x/2] &= 0x0F;
-						_pointer8[copy][line_start+x/2] |= icolor<<4;
-
-					}
-				}
-			}
-		}
-	//draw 3 left bottom bars
-	for (int copy = 0; copy < copies; copy++)
-		for (int i=0;i<3;i++)
-		{
-			uint8_t icolor = i+9;
-			for (int y=(_size_y*75)/100;y<_size_y;y++)
-			{
-				int line_start = y*512;
-				for (int x=(_size_x*i*5)/28;x<(_size_x*(i+1)*5)/28;x++)
-				{
-					if (x%2)
-					{
-						_pointer8[copy][line_start+x/2] &= 0xF0;
-						_pointer8[copy][line_start+x/2] |= icolor;
-					}
-					else
-					{
-						_pointer8[copy][line_start+x/2] &= 0x0F;
-						_pointer8[copy][line_start+x/2] |= icolor<<4;
-
-					}
-				}
-			}
-		}
-	//draw bottom black
-	for (int copy = 0; copy < copies; copy++)
-		for (int y=(_size_y*75)/100;y<_size_y;y++)
-		{
-			int line_start = y*512;
-			for (int x=(_size_x*15)/28;x<_size_x;x++)
-			{
-				if (x%2)
-				{
-					_pointer8[copy][line_start+x/2] &= 0xF0;
-					_pointer8[copy][line_start+x/2] |= 8;
-				}
-				else
-				{
-					_pointer8[copy][line_start+x/2] &= 0x0F;
-					_pointer8[copy][line_start+x/2] |= 8<<4;
-				}
-			}
-		}
-	//draw bottom black - 4
-	for (int copy = 0; copy < copies; copy++)
-		for (int y=(_size_y*75)/100;y<_size_y;y++)
-		{
-			int line_start = y*512;
-			for (int x=(_size_x*5)/7;x<(_size_x*16)/21;x++)
-			{
-				if (x%2)
-				{
-					_pointer8[copy][line_start+x/2] &= 0xF0;
-					_pointer8[copy][line_start+x/2] |= 12;
-				}
-				else
-				{
-					_pointer8[copy][line_start+x/2] &= 0x0F;
-					_pointer8[copy][line_start+x/2] |= 12<<4;
-				}
-			}
-		}
-	//draw bottom black + 4
-	for (int copy = 0; copy < copies; copy++)
-		for (int y=(_size_y*75)/100;y<_size_y;y++)
-		{
-			int line_start = y*512;
-			for (int x=(_size_x*17)/21;x<(_size_x*6)/7;x++)
-			{
-				if (x%2)
-				{
-					_pointer8[copy][line_start+x/2] &= 0xF0;
-					_pointer8[copy][line_start+x/2] |= 13;
-				}
-				else
-				{
-					_pointer8[copy][line_start+x/2] &= 0x0F;
-					_pointer8[copy][line_start+x/2] |= 13<<4;
-				}
-			}
-		}
+	//bars compiled by patc from patterns/smpte.pat
+	pattern_table_draw(pattern_table_smpte,screenmode,8);
 
 	video_vdp2_set_cycle_patterns_nbg_bmp(screenmode);
 }
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <yaul.h>
+#include "font.h"
+#include "video.h"
+#include "video_raster4.h"
+#include "pattern_table.h"
+
+static int table_coord(const pattern_table_coord_t *coord, int size_x, int size_y)
+{
+	switch (coord->size)
+	{
+		case PATTERN_TABLE_SIZE_W:
+			return (size_x*coord->num)/coord->den + coord->add;
+		case PATTERN_TABLE_SIZE_H:
+			return (size_y*coord->num)/coord->den + coord->add;
+	}
+	return coord->add;
+}
+
+//same steps as patc_gradient_color() in tools/patc, the tile targets are rendered with that
+static int table_gradient_color(const pattern_table_op_t *op, int position, int length)
+{
+	int steps = abs(op->color2 - op->color) + 1;
+	int index = (length > 0) ? (position*steps)/length : 0;
+	if (index >= steps)
+		index = steps - 1;
+	return (op->color2 >= op->color) ? op->color + index : op->color - index;
+}
+
+static void table_line(int x0, int y0, int x1, int y1, int color)
+{
+	int dx = abs(x1 - x0), sx = (x0 < x1) ? 1 : -1;
+	int dy = -abs(y1 - y0), sy = (y0 < y1) ? 1 : -1;
+	int err = dx + dy;
+	for (;;)
+	{
+		video_raster4_set_pixel(x0,y0,color);
+		if ( (x0 == x1) && (y0 == y1) )
+			break;
+		int e2 = 2*err;
+		if (e2 >= dy)
+		{
+			err += dy;
+			x0 += sx;
+		}
+		if (e2 <= dx)
+		{
+			err += dx;
+			y0 += sy;
+		}
+	}
+}
+
+void pattern_table_draw(const pattern_table_op_t *ops, video_screen_mode_t screenmode, int background)
+{
+	int _size_x = get_screenmode_resolution_x(screenmode);
+	int _size_y = get_screenmode_resolution_y(screenmode);
+	const pattern_table_op_t *op;
+
+	video_raster4_begin(screenmode,background);
+
+	for (op = ops; op->type != PATTERN_TABLE_END; op++)
+	{
+		int x0 = table_coord(&op->x0,_size_x,_size_y);
+		int y0 = table_coord(&op->y0,_size_x,_size_y);
+		int x1 = table_coord(&op->x1,_size_x,_size_y);
+		int y1 = table_coord(&op->y1,_size_x,_size_y);
+
+		switch (op->type)
+		{
+			case PATTERN_TABLE_RECT:
+				for (int y=y0;y<y1;y++)
+					video_raster4_set_span(x0,x1-1,y,op->color);
+				break;
+			case PATTERN_TABLE_DOTS:
+				for (int y=y0;y<y1;y+=op->step_y)
+					for (int x=x0;x<x1;x+=op->step_x)
+						video_raster4_set_pixel(x,y,op->color);
+				break;
+			case PATTERN_TABLE_GRADIENT:
+				if (op->flags & 1)
+				{
+					for (int y=y0;y<y1;y++)
+						video_raster4_set_span(x0,x1-1,y,table_gradient_color(op,y-y0,y1-y0));
+				}
+				else
+				{
+					//one span per color band, repeated on every line
+					for (int x=x0;x<x1;)
+					{
+						int color = table_gradient_color(op,x-x0,x1-x0);
+						int end = x + 1;
+						while ( (end < x1) && (table_gradient_color(op,end-x0,x1-x0) == color) )
+							end++;
+						for (int y=y0;y<y1;y++)
+							video_raster4_set_span(x,end-1,y,color);
+						x = end;
+					}
+				}
+				break;
+			case PATTERN_TABLE_LINE:
+				table_line(x0,y0,x1,y1,op->color);
+				break;
+			case PATTERN_TABLE_TEXT:
+				//goes to the text layer, above the bitmap
+				DrawString((char *)op->text,x0,y0,op->color);
+				break;
+		}
+	}
+
+	video_raster4_end();
+}
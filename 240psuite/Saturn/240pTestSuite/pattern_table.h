@@ -0,0 +1,45 @@
+#ifndef PATTERN_TABLE_H
+#define PATTERN_TABLE_H
+
+#include "video.h"
+
+// Patterns compiled by tools/patc from the .pat sources. Coordinates are
+// kept symbolic, size*num/den+add, so one table covers every screen mode.
+#define PATTERN_TABLE_END 0
+#define PATTERN_TABLE_RECT 1      //x0 <= x < x1, y0 <= y < y1
+#define PATTERN_TABLE_LINE 2      //both ends included
+#define PATTERN_TABLE_DOTS 3      //every step_x/step_y pixel of the rect
+#define PATTERN_TABLE_GRADIENT 4  //color to color2, vertical if flags & 1
+#define PATTERN_TABLE_TEXT 5      //text at x0,y0 in palette color
+
+#define PATTERN_TABLE_SIZE_PIXELS 0
+#define PATTERN_TABLE_SIZE_W 1
+#define PATTERN_TABLE_SIZE_H 2
+
+typedef struct {
+	uint8_t size;
+	int16_t num;
+	int16_t den;
+	int16_t add;
+} pattern_table_coord_t;
+
+typedef struct {
+	uint8_t type;
+	uint8_t color;
+	uint8_t color2;
+	uint8_t step_x;
+	uint8_t step_y;
+	uint8_t flags;
+	pattern_table_coord_t x0, y0, x1, y1;
+	const char *text;
+} pattern_table_op_t;
+
+// Draws into the NBG0 bitmap (and NBG1 for special modes) through
+// video_raster4, starting from a screen filled with background.
+void pattern_table_draw(const pattern_table_op_t *ops, video_screen_mode_t screenmode, int background);
+
+// pattern_table_data.c, generated from tools/patc/patterns
+extern const pattern_table_op_t pattern_table_ebu[];
+extern const pattern_table_op_t pattern_table_smpte[];
+
+#endif /* !PATTERN_TABLE_H */
@@ -0,0 +1,44 @@
+// generated by patc from patterns/ebu.pat patterns/smpte.pat, do not edit
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <yaul.h>
+#include "video.h"
+#include "pattern_table.h"
+
+const pattern_table_op_t pattern_table_ebu[] = {
+	{ PATTERN_TABLE_RECT, 1, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,0,8,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,1,8,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 2, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,1,8,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,2,8,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 3, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,2,8,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,3,8,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 4, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,3,8,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,4,8,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 5, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,4,8,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,5,8,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 6, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,5,8,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,6,8,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 7, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,6,8,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,7,8,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 8, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,7,8,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,8,8,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_END },
+};
+
+const pattern_table_op_t pattern_table_smpte[] = {
+	{ PATTERN_TABLE_RECT, 1, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,0,7,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,1,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 2, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,1,7,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,2,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 3, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,2,7,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,3,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 4, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,3,7,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,4,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 5, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,4,7,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,5,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 6, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,5,7,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,6,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 7, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,6,7,0}, {PATTERN_TABLE_SIZE_PIXELS,0,1,0}, {PATTERN_TABLE_SIZE_W,7,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 7, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,0,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, {PATTERN_TABLE_SIZE_W,1,7,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 8, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,1,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, {PATTERN_TABLE_SIZE_W,2,7,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 5, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,2,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, {PATTERN_TABLE_SIZE_W,3,7,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 8, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,3,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, {PATTERN_TABLE_SIZE_W,4,7,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 3, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,4,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, {PATTERN_TABLE_SIZE_W,5,7,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 8, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,5,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, {PATTERN_TABLE_SIZE_W,6,7,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 1, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,6,7,0}, {PATTERN_TABLE_SIZE_H,67,100,0}, {PATTERN_TABLE_SIZE_W,7,7,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, NULL },
+	{ PATTERN_TABLE_RECT, 9, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,0,28,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, {PATTERN_TABLE_SIZE_W,5,28,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 10, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,5,28,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, {PATTERN_TABLE_SIZE_W,10,28,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 11, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,10,28,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, {PATTERN_TABLE_SIZE_W,15,28,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 8, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,15,28,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, {PATTERN_TABLE_SIZE_W,1,1,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 12, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,5,7,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, {PATTERN_TABLE_SIZE_W,16,21,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_RECT, 13, 0, 0, 0, 0, {PATTERN_TABLE_SIZE_W,17,21,0}, {PATTERN_TABLE_SIZE_H,75,100,0}, {PATTERN_TABLE_SIZE_W,6,7,0}, {PATTERN_TABLE_SIZE_H,1,1,0}, NULL },
+	{ PATTERN_TABLE_END },
+};
+
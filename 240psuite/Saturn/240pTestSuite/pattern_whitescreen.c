@@ -61,7 +61,7 @@ void draw_whitescreen(video_screen_mode_t screenmode, int color)
 	}
 	for (int copy = 0; copy < copies; copy++)
 		for (int j=0; j<16; j++)
-			_pointer32[copy][16+j] = 0x01010101;
+			VIDEO_VDP2_WRITE32(&_pointer32[copy][16+j], 0x01010101);
 	//fill everything with our tile
 	_pointer32[0] = (int *)VIDEO_VDP2_NBG0_PNDR_START;
 	vram_offset[0] = VIDEO_VDP2_NBG0_CHPNDR_START - VDP2_VRAM_ADDR(0,0);
@@ -74,7 +74,7 @@ void draw_whitescreen(video_screen_mode_t screenmode, int color)
 	}
 	for (int copy = 0; copy < copies; copy++)
     	for (unsigned int i = 0; i < VIDEO_VDP2_NBG0_PNDR_SIZE / sizeof(int); i++)
-			_pointer32[copy][i] = 0x00200002 + vram_offset[copy]/32; //palette 2, transparency on, black
+			VIDEO_VDP2_WRITE32(&_pointer32[copy][i], 0x00200002 + vram_offset[copy]/32); //palette 2, transparency on, black
 	video_vdp2_set_cycle_patterns_nbg(screenmode);
 }
 
@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <yaul.h>
+#include "profile.h"
+#include "font.h"
+
+#ifdef PROFILE
+
+#define PROFILE_OVERLAY_PERIOD 30
+#define PROFILE_OVERLAY_Y 186
+
+extern int global_frame_count;
+
+static const char *profile_section_names[PROFILE_SECTION_COUNT] = {
+	"BG EXPANSION",
+	"SCROLL H",
+	"SCROLL V",
+	"LAG",
+};
+
+typedef struct {
+	uint16_t begin;
+	uint16_t last;
+	uint16_t max;
+	uint16_t line;
+	int count;
+} profile_section_stats_t;
+
+static profile_record_t _ring[PROFILE_RING_SIZE];
+static int _ring_head = 0;
+static int _ring_count = 0;
+static profile_section_stats_t _stats[PROFILE_SECTION_COUNT];
+
+static int _last_frame_count = -1;
+static int _missed_total = 0;
+static uint8_t _missed_pending = 0;
+static uint16_t _frame_start = 0;
+static uint16_t _frame_ticks = 0;
+static bool _overlay = true;
+static int _overlay_counter = 0;
+
+static uint16_t profile_line_get()
+{
+	//reading TVSTAT first latches the HV counters
+	volatile uint16_t *tvstat = (volatile uint16_t *)(VDP2_IOREG_BASE+TVSTAT);
+	volatile uint16_t *vcnt = (volatile uint16_t *)(VDP2_IOREG_BASE+VCNT);
+	(void)*tvstat;
+	return (*vcnt) & 0x3FF;
+}
+
+void profile_init()
+{
+	cpu_frt_init(CPU_FRT_CLOCK_DIV_128);
+	dbgio_dev_default_init(DBGIO_DEV_USB_CART);
+	memset(_stats, 0x00, sizeof(_stats));
+	_ring_head = 0;
+	_ring_count = 0;
+	_last_frame_count = -1;
+	_missed_total = 0;
+	_missed_pending = 0;
+}
+
+static void profile_overlay_draw()
+{
+	char buf[48];
+	int y = PROFILE_OVERLAY_Y;
+	//a budget of 0 means no whole frame was seen yet
+	int budget = _frame_ticks ? _frame_ticks : 1;
+	for (int i = 0; i < PROFILE_SECTION_COUNT; i++)
+	{
+		if (0 == _stats[i].count)
+			continue;
+		sprintf(buf, "%-12s %5d %5d %3d%% L%3d", profile_section_names[i],
+				_stats[i].last, _stats[i].max, _stats[i].last*100/budget, _stats[i].line);
+		DrawStringWithBackground(buf, 10, y, FONT_WHITE, FONT_BLACK);
+		y += _fh;
+	}
+	sprintf(buf, "FRAME %5d MISSED %d", _frame_ticks, _missed_total);
+	DrawStringWithBackground(buf, 10, y, _missed_total ? FONT_RED : FONT_WHITE, FONT_BLACK);
+}
+
+//called once per loop iteration, right after the loop's vblank wait
+void profile_frame()
+{
+	uint16_t now = cpu_frt_count_get();
+	int frame_count = global_frame_count;
+	if (_last_frame_count >= 0)
+	{
+		int frames = frame_count - _last_frame_count;
+		if (1 == frames)
+			_frame_ticks = now - _frame_start;
+		else if (frames > 1)
+		{
+			_missed_total += frames - 1;
+			_missed_pending = (frames - 1 > 255) ? 255 : frames - 1;
+		}
+	}
+	_last_frame_count = frame_count;
+	_frame_start = now;
+
+	if (_overlay && (++_overlay_counter >= PROFILE_OVERLAY_PERIOD))
+	{
+		_overlay_counter = 0;
+		profile_overlay_draw();
+	}
+}
+
+void profile_begin(profile_section_t section)
+{
+	_stats[section].begin = cpu_frt_count_get();
+}
+
+void profile_end(profile_section_t section)
+{
+	uint16_t end = cpu_frt_count_get();
+	uint16_t line = profile_line_get();
+	profile_section_stats_t *stats = &_stats[section];
+	uint16_t ticks = end - stats->begin;
+
+	stats->last = ticks;
+	if (ticks > stats->max)
+		stats->max = ticks;
+	stats->line = line;
+	stats->count++;
+
+	profile_record_t *record = &_ring[_ring_head];
+	record->frame = global_frame_count;
+	record->section = section;
+	record->missed = _missed_pending;
+	record->begin = stats->begin;
+	record->end = end;
+	record->line = line;
+	record->frame_ticks = _frame_ticks;
+	_missed_pending = 0;
+
+	_ring_head = (_ring_head + 1) % PROFILE_RING_SIZE;
+	if (_ring_count < PROFILE_RING_SIZE)
+		_ring_count++;
+}
+
+void profile_overlay_set(bool enabled)
+{
+	_overlay = enabled;
+	_overlay_counter = 0;
+}
+
+//sends the ring buffer over the USB cartridge as CSV, oldest record first
+void profile_dump()
+{
+	int index = (_ring_head - _ring_count + PROFILE_RING_SIZE) % PROFILE_RING_SIZE;
+	dbgio_printf("frame,section,ticks,begin,end,line,frame_ticks,missed\n");
+	for (int i = 0; i < _ring_count; i++)
+	{
+		profile_record_t *record = &_ring[index];
+		dbgio_printf("%u,%s,%u,%u,%u,%u,%u,%u\n", record->frame, profile_section_names[record->section],
+					 (uint16_t)(record->end - record->begin), record->begin, record->end, record->line,
+					 record->frame_ticks, record->missed);
+		index = (index + 1) % PROFILE_RING_SIZE;
+	}
+	dbgio_printf("missed,%d\n", _missed_total);
+	dbgio_flush();
+}
+
+#endif /* PROFILE */
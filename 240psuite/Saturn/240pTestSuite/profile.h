@@ -0,0 +1,54 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+// Frame budget profiler. Sections are timed with the CPU free running
+// timer at 1/128 of the CPU clock (about 4.8us a tick, wraps after
+// about 310ms) and the VDP2 line counter at the end of the section.
+// Everything compiles away unless the suite is built with PROFILE=1.
+
+typedef enum {
+	PROFILE_SECTION_BG_EXPANSION = 0,
+	PROFILE_SECTION_SCROLL_HORIZONTAL,
+	PROFILE_SECTION_SCROLL_VERTICAL,
+	PROFILE_SECTION_LAG,
+	PROFILE_SECTION_COUNT
+} profile_section_t;
+
+#define PROFILE_RING_SIZE 512
+
+typedef struct {
+	uint16_t frame;		//global_frame_count at the end, low bits
+	uint8_t section;
+	uint8_t missed;		//frames missed by the loop before this one
+	uint16_t begin;		//FRT ticks
+	uint16_t end;
+	uint16_t line;		//VDP2 line counter at the end
+	uint16_t frame_ticks;	//FRT ticks of the last whole frame
+} profile_record_t;
+
+#ifdef PROFILE
+
+void profile_init();
+void profile_frame();
+void profile_begin(profile_section_t section);
+void profile_end(profile_section_t section);
+void profile_overlay_set(bool enabled);
+void profile_dump();
+
+#define PROFILE_INIT()			profile_init()
+#define PROFILE_FRAME()			profile_frame()
+#define PROFILE_BEGIN(section)	profile_begin(section)
+#define PROFILE_END(section)	profile_end(section)
+#define PROFILE_DUMP()			profile_dump()
+
+#else
+
+#define PROFILE_INIT()
+#define PROFILE_FRAME()
+#define PROFILE_BEGIN(section)
+#define PROFILE_END(section)
+#define PROFILE_DUMP()
+
+#endif /* PROFILE */
+
+#endif /* !PROFILE_H */
@@ -0,0 +1,510 @@
+/*
+ * 240p Test Suite for the Sega Saturn
+ * .BG asset compiler
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * Converts 8-bit indexed PNGs to the .BG files background.c loads, and
+ * back. The pixel stream is either 8x8 cells in row order, as VDP2 cell
+ * backgrounds use it, or plain lines for bitmaps and VDP1 sprites.
+ *
+ *	bgconv [-c codec] [-l layout] [-n name] in.png out.BG
+ *	bgconv -x [-l layout] in.BG out.png
+ *	bgconv -b [-l layout] file.png|file.BG ...
+ *
+ * codec is lz77 (default, best ratio), lz4 (byte aligned, fastest to
+ * decode) or rle (PackBits, for flat images); layout is cells (default)
+ * or linear. -b compresses each file with every codec and times the
+ * background_codec.c decoders on the host, as a guide to the size/speed
+ * tradeoff on the SH-2.
+ *
+ * File layout: sector 0 holds the big-endian width and height at 4, the
+ * name at 10 and "VDP2" at 2044, "VDP1" for the linear layout. Sector 1 starts with the codec tag and
+ * the stream size, the stream follows at 2056. The 24-bit palette is on
+ * the sector after the stream.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <png.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BGCONV_HAVE_TSC 1
+#endif
+#include "bgconv.h"
+
+typedef struct {
+	int width;
+	int height;
+	uint8_t *pixels;	//row order, one byte per pixel
+	uint8_t palette[256*3];
+} bgconv_image_t;
+
+typedef enum {
+	LAYOUT_CELLS,
+	LAYOUT_LINEAR
+} bgconv_layout_t;
+
+static const struct {
+	const char *name;
+	uint32_t codec;
+} codecs[] = {
+	{ "lz77", BACKGROUND_CODEC_LZ77 },
+	{ "lz4", BACKGROUND_CODEC_LZ4 },
+	{ "rle", BACKGROUND_CODEC_RLE },
+};
+#define CODEC_COUNT (sizeof(codecs)/sizeof(codecs[0]))
+
+static const char *codec_name(uint32_t codec)
+{
+	for (size_t i = 0; i < CODEC_COUNT; i++)
+		if (codecs[i].codec == codec)
+			return codecs[i].name;
+	return "?";
+}
+
+static uint32_t read_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void write_be32(uint8_t *p, uint32_t v)
+{
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >> 8;
+	p[3] = v;
+}
+
+//---------------------------------------------- layout ---------------------------------------------------
+static size_t layout_index(bgconv_layout_t layout, int width, int x, int y)
+{
+	if (layout == LAYOUT_LINEAR)
+		return (size_t)y*width + x;
+	return ((size_t)(y/8)*(width/8) + x/8)*64 + (y%8)*8 + x%8;
+}
+
+static void image_to_stream(const bgconv_image_t *image, bgconv_layout_t layout, uint8_t *stream)
+{
+	for (int y = 0; y < image->height; y++)
+		for (int x = 0; x < image->width; x++)
+			stream[layout_index(layout, image->width, x, y)] = image->pixels[y*image->width + x];
+}
+
+static void stream_to_image(const uint8_t *stream, bgconv_layout_t layout, bgconv_image_t *image)
+{
+	for (int y = 0; y < image->height; y++)
+		for (int x = 0; x < image->width; x++)
+			image->pixels[y*image->width + x] = stream[layout_index(layout, image->width, x, y)];
+}
+
+//---------------------------------------------- PNG ------------------------------------------------------
+static int png_load(const char *path, bgconv_image_t *image)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f)
+	{
+		fprintf(stderr, "Could not open %s\n", path);
+		return -1;
+	}
+	png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	png_infop info = png_create_info_struct(png);
+	png_bytep *rows = NULL;
+	if (setjmp(png_jmpbuf(png)))
+	{
+		fprintf(stderr, "%s: not a readable PNG\n", path);
+		png_destroy_read_struct(&png, &info, NULL);
+		free(rows);
+		fclose(f);
+		return -1;
+	}
+	png_init_io(png, f);
+	png_read_info(png, info);
+	if (png_get_color_type(png, info) != PNG_COLOR_TYPE_PALETTE)
+	{
+		fprintf(stderr, "%s: only indexed color PNGs can be converted\n", path);
+		png_destroy_read_struct(&png, &info, NULL);
+		fclose(f);
+		return -1;
+	}
+	if (png_get_bit_depth(png, info) < 8)
+		png_set_packing(png);
+	png_read_update_info(png, info);
+
+	image->width = png_get_image_width(png, info);
+	image->height = png_get_image_height(png, info);
+	image->pixels = malloc((size_t)image->width*image->height);
+	rows = malloc(image->height*sizeof(png_bytep));
+	for (int y = 0; y < image->height; y++)
+		rows[y] = &image->pixels[y*image->width];
+	png_read_image(png, rows);
+
+	png_colorp palette;
+	int colors = 0;
+	memset(image->palette, 0, sizeof(image->palette));
+	if (png_get_PLTE(png, info, &palette, &colors))
+	{
+		for (int i = 0; i < colors && i < 256; i++)
+		{
+			image->palette[i*3+0] = palette[i].red;
+			image->palette[i*3+1] = palette[i].green;
+			image->palette[i*3+2] = palette[i].blue;
+		}
+	}
+	free(rows);
+	png_destroy_read_struct(&png, &info, NULL);
+	fclose(f);
+	return 0;
+}
+
+static int png_save(const char *path, const bgconv_image_t *image)
+{
+	FILE *f = fopen(path, "wb");
+	if (!f)
+	{
+		fprintf(stderr, "Could not write %s\n", path);
+		return -1;
+	}
+	png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	png_infop info = png_create_info_struct(png);
+	if (setjmp(png_jmpbuf(png)))
+	{
+		fprintf(stderr, "Could not write %s\n", path);
+		png_destroy_write_struct(&png, &info);
+		fclose(f);
+		return -1;
+	}
+	png_init_io(png, f);
+	png_set_IHDR(png, info, image->width, image->height, 8, PNG_COLOR_TYPE_PALETTE,
+				 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_color palette[256];
+	for (int i = 0; i < 256; i++)
+	{
+		palette[i].red = image->palette[i*3+0];
+		palette[i].green = image->palette[i*3+1];
+		palette[i].blue = image->palette[i*3+2];
+	}
+	png_set_PLTE(png, info, palette, 256);
+	png_write_info(png, info);
+	for (int y = 0; y < image->height; y++)
+		png_write_row(png, &image->pixels[y*image->width]);
+	png_write_end(png, NULL);
+	png_destroy_write_struct(&png, &info);
+	fclose(f);
+	return 0;
+}
+
+//---------------------------------------------- .BG ------------------------------------------------------
+//background.c finds the palette at sector (stream size-1)/2048 + 2, so the
+//stream plus its 8-byte header must not spill into that sector
+static int stream_size_fits(size_t size)
+{
+	size_t tail = size % BGCONV_SECTOR;
+	return (tail != 0) && (tail <= BGCONV_SECTOR - 8);
+}
+
+static size_t encode_stream(uint32_t codec, const uint8_t *stream, size_t n, uint8_t *packed)
+{
+	for (size_t literal_tail = 0; literal_tail <= n; literal_tail++)
+	{
+		size_t size = bgconv_encode(codec, stream, n, packed, literal_tail);
+		if (stream_size_fits(size))
+			return size;
+	}
+	return 0;
+}
+
+static int bg_save(const char *path, const bgconv_image_t *image, bgconv_layout_t layout, uint32_t codec, const char *name)
+{
+	size_t n = (size_t)image->width*image->height;
+	uint8_t *stream = malloc(n);
+	uint8_t *packed = malloc(BGCONV_MAX_ENCODED(n));
+	uint8_t *check = malloc(n + 64);
+	image_to_stream(image, layout, stream);
+
+	size_t size = encode_stream(codec, stream, n, packed);
+	if ( (size == 0) || (background_codec_decode(codec, packed, size, check, 0) != (int)n) || memcmp(check, stream, n) )
+	{
+		fprintf(stderr, "%s: %s stream does not decode back to the image\n", path, codec_name(codec));
+		free(stream); free(packed); free(check);
+		return -1;
+	}
+
+	size_t sectors = (size - 1)/BGCONV_SECTOR + 1;
+	size_t file_size = BGCONV_SECTOR*(sectors + 2);
+	uint8_t *file = calloc(1, file_size);
+	file[4] = image->width >> 8;
+	file[5] = image->width;
+	file[6] = image->height >> 8;
+	file[7] = image->height;
+	file[9] = 1;
+	memcpy(&file[10], name, strnlen(name, 63));
+	memcpy(&file[2044], (layout == LAYOUT_CELLS) ? "VDP2" : "VDP1", 4);
+	write_be32(&file[2048], codec);
+	write_be32(&file[2052], size);
+	memcpy(&file[2056], packed, size);
+	memcpy(&file[BGCONV_SECTOR*(sectors + 1)], image->palette, sizeof(image->palette));
+
+	int result = 0;
+	FILE *f = fopen(path, "wb");
+	if (!f || fwrite(file, 1, file_size, f) != file_size)
+	{
+		fprintf(stderr, "Could not write %s\n", path);
+		result = -1;
+	}
+	else
+		printf("%s: %dx%d %s, %zu bytes packed to %zu\n", path, image->width, image->height, codec_name(codec), n, size);
+	if (f)
+		fclose(f);
+	free(file); free(stream); free(packed); free(check);
+	return result;
+}
+
+//fills image and the raw pixel stream of a .BG file
+static int bg_load(const char *path, bgconv_image_t *image, bgconv_layout_t layout, uint8_t **stream_out)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f)
+	{
+		fprintf(stderr, "Could not open %s\n", path);
+		return -1;
+	}
+	fseek(f, 0, SEEK_END);
+	long file_size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	uint8_t *file = malloc(file_size);
+	size_t got = fread(file, 1, file_size, f);
+	fclose(f);
+	uint32_t codec = (got >= 2*BGCONV_SECTOR) ? read_be32(&file[2048]) : 0;
+	if ( (got != (size_t)file_size) || !strcmp(codec_name(codec), "?") )
+	{
+		fprintf(stderr, "%s: not a .BG file\n", path);
+		free(file);
+		return -1;
+	}
+	size_t size = read_be32(&file[2052]);
+	size_t palette = BGCONV_SECTOR*((size - 1)/BGCONV_SECTOR + 2);
+	if ( (size == 0) || (palette + sizeof(image->palette) > (size_t)file_size) )
+	{
+		fprintf(stderr, "%s: truncated\n", path);
+		free(file);
+		return -1;
+	}
+	image->width = (file[4] << 8) | file[5];
+	image->height = (file[6] << 8) | file[7];
+	size_t n = (size_t)image->width*image->height;
+	//the decoders do not bound the output, leave room for a broken stream
+	uint8_t *stream = malloc(n + 0x10000);
+	int decoded = background_codec_decode(codec, &file[2056], size, stream, 0);
+	if (decoded != (int)n)
+	{
+		fprintf(stderr, "%s: %s stream decodes to %d bytes, expected %zu\n", path, codec_name(codec), decoded, n);
+		free(stream);
+		free(file);
+		return -1;
+	}
+	image->pixels = malloc(n);
+	stream_to_image(stream, layout, image);
+	memcpy(image->palette, &file[palette], sizeof(image->palette));
+	free(file);
+	if (stream_out)
+		*stream_out = stream;
+	else
+		free(stream);
+	return 0;
+}
+
+//---------------------------------------------- benchmark ------------------------------------------------
+static double now_seconds()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void bench_file(const char *path, bgconv_layout_t layout)
+{
+	bgconv_image_t image;
+	uint8_t *stream = NULL;
+	size_t len = strlen(path);
+	if ( (len > 3) && (strcasecmp(&path[len - 3], ".BG") == 0) )
+	{
+		if (bg_load(path, &image, layout, &stream))
+			return;
+	}
+	else
+	{
+		if (png_load(path, &image))
+			return;
+		stream = malloc((size_t)image.width*image.height);
+		image_to_stream(&image, layout, stream);
+	}
+
+	size_t n = (size_t)image.width*image.height;
+	uint8_t *packed = malloc(BGCONV_MAX_ENCODED(n));
+	uint8_t *out = malloc(n + 64);
+	for (size_t c = 0; c < CODEC_COUNT; c++)
+	{
+		size_t size = encode_stream(codecs[c].codec, stream, n, packed);
+		background_codec_decode(codecs[c].codec, packed, size, out, 0);
+		if (memcmp(out, stream, n))
+		{
+			printf("%-24s %-5s does not round trip\n", path, codecs[c].name);
+			continue;
+		}
+		//repeat until the timing is well above the clock resolution
+		long runs = 0;
+		double start = now_seconds(), elapsed;
+#ifdef BGCONV_HAVE_TSC
+		uint64_t tsc_start = __rdtsc();
+#endif
+		do
+		{
+			background_codec_decode(codecs[c].codec, packed, size, out, 0);
+			runs++;
+			elapsed = now_seconds() - start;
+		}
+		while (elapsed < 0.2);
+		double bytes = (double)runs*n;
+#ifdef BGCONV_HAVE_TSC
+		printf("%-24s %-5s %8zu %6.2f%% %7.3f ns/B %6.2f cyc/B\n", path, codecs[c].name, size,
+			   100.0*size/n, elapsed*1e9/bytes, (double)(__rdtsc() - tsc_start)/bytes);
+#else
+		printf("%-24s %-5s %8zu %6.2f%% %7.3f ns/B\n", path, codecs[c].name, size,
+			   100.0*size/n, elapsed*1e9/bytes);
+#endif
+	}
+	free(packed);
+	free(out);
+	free(stream);
+	free(image.pixels);
+}
+
+//---------------------------------------------- main -----------------------------------------------------
+static void usage()
+{
+	printf("bgconv [-c lz77|lz4|rle] [-l cells|linear] [-n name] in.png out.BG\n");
+	printf("bgconv -x [-l cells|linear] in.BG out.png\n");
+	printf("bgconv -b [-l cells|linear] file.png|file.BG ...\n");
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t codec = BACKGROUND_CODEC_LZ77;
+	bgconv_layout_t layout = LAYOUT_CELLS;
+	const char *name = NULL;
+	int extract = 0, bench = 0;
+	int i;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if (strcmp(argv[i], "-x") == 0)
+			extract = 1;
+		else if (strcmp(argv[i], "-b") == 0)
+			bench = 1;
+		else if ( (strcmp(argv[i], "-n") == 0) && (i + 1 < argc) )
+			name = argv[++i];
+		else if ( (strcmp(argv[i], "-l") == 0) && (i + 1 < argc) )
+		{
+			i++;
+			if (strcmp(argv[i], "cells") == 0)
+				layout = LAYOUT_CELLS;
+			else if (strcmp(argv[i], "linear") == 0)
+				layout = LAYOUT_LINEAR;
+			else
+			{
+				usage();
+				return 2;
+			}
+		}
+		else if ( (strcmp(argv[i], "-c") == 0) && (i + 1 < argc) )
+		{
+			i++;
+			codec = 0;
+			for (size_t c = 0; c < CODEC_COUNT; c++)
+				if (strcmp(argv[i], codecs[c].name) == 0)
+					codec = codecs[c].codec;
+			if (!codec)
+			{
+				usage();
+				return 2;
+			}
+		}
+		else
+		{
+			usage();
+			return 2;
+		}
+	}
+
+	if (bench)
+	{
+		if (i == argc)
+		{
+			usage();
+			return 2;
+		}
+		printf("%-24s %-5s %8s %7s\n", "file", "codec", "packed", "ratio");
+		for (; i < argc; i++)
+			bench_file(argv[i], layout);
+		return 0;
+	}
+
+	if (argc - i != 2)
+	{
+		usage();
+		return 2;
+	}
+
+	bgconv_image_t image;
+	int result;
+	if (extract)
+	{
+		if (bg_load(argv[i], &image, layout, NULL))
+			return 1;
+		result = png_save(argv[i+1], &image);
+	}
+	else
+	{
+		if (png_load(argv[i], &image))
+			return 1;
+		if ( (layout == LAYOUT_CELLS) && ((image.width % 8) || (image.height % 8)) )
+		{
+			fprintf(stderr, "%s: cell layout needs a size in multiples of 8, not %dx%d\n", argv[i], image.width, image.height);
+			return 1;
+		}
+		if (!name)
+		{
+			//default name is the file name without path and extension
+			const char *base = strrchr(argv[i], '/');
+			base = base ? base + 1 : argv[i];
+			static char base_name[64];
+			strncpy(base_name, base, sizeof(base_name) - 1);
+			char *dot = strrchr(base_name, '.');
+			if (dot)
+				*dot = 0;
+			name = base_name;
+		}
+		result = bg_save(argv[i+1], &image, layout, codec, name);
+	}
+	free(image.pixels);
+	return result ? 1 : 0;
+}
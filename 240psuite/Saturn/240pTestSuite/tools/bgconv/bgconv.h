@@ -0,0 +1,19 @@
+#ifndef BGCONV_H
+#define BGCONV_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "background_codec.h"
+
+#define BGCONV_SECTOR 2048
+
+//worst case stream size for n pixels, for any codec
+#define BGCONV_MAX_ENCODED(n) (2*(n) + 64)
+
+// Compresses n bytes of src into dst with one of the BACKGROUND_CODEC_*
+// formats. The last literal_tail bytes are always stored as literals,
+// which is how bgconv nudges the stream size off a sector boundary.
+// Returns the stream size, 0 for an unknown codec.
+size_t bgconv_encode(uint32_t codec, const uint8_t *src, size_t n, uint8_t *dst, size_t literal_tail);
+
+#endif /* !BGCONV_H */
@@ -0,0 +1,244 @@
+/*
+ * 240p Test Suite for the Sega Saturn
+ * Encoders for the .BG codecs, the decoders and the RLE encoder, which the
+ * raster4 cache shares, live in background_codec.c
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bgconv.h"
+
+#define MATCH_HASH_BITS 16
+#define MATCH_CHAIN_DEPTH 256
+#define MATCH_MIN 4
+
+//---------------------------------------------- match finder ---------------------------------------------
+typedef struct {
+	const uint8_t *src;
+	size_t n;
+	int32_t head[1 << MATCH_HASH_BITS];
+	int32_t *prev;
+} matcher_t;
+
+static uint32_t match_hash(const uint8_t *p)
+{
+	uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+	return (v * 2654435761u) >> (32 - MATCH_HASH_BITS);
+}
+
+static matcher_t *match_init(const uint8_t *src, size_t n)
+{
+	matcher_t *m = malloc(sizeof(matcher_t));
+	m->src = src;
+	m->n = n;
+	m->prev = malloc((n + 1) * sizeof(int32_t));
+	memset(m->head, 0xFF, sizeof(m->head));
+	return m;
+}
+
+static void match_free(matcher_t *m)
+{
+	free(m->prev);
+	free(m);
+}
+
+static void match_insert(matcher_t *m, size_t i)
+{
+	if (i + MATCH_MIN > m->n)
+		return;
+	uint32_t h = match_hash(&m->src[i]);
+	m->prev[i] = m->head[h];
+	m->head[h] = (int32_t)i;
+}
+
+//longest match for position i that ends before limit, 0 if none
+static size_t match_find(matcher_t *m, size_t i, size_t limit, size_t max_offset, size_t *offset)
+{
+	size_t best = 0;
+	if (i + MATCH_MIN > limit)
+		return 0;
+	int32_t cand = m->head[match_hash(&m->src[i])];
+	for (int depth = 0; (cand >= 0) && (depth < MATCH_CHAIN_DEPTH); depth++)
+	{
+		if (i - (size_t)cand > max_offset)
+			break;
+		size_t len = 0;
+		while ( (i + len < limit) && (m->src[cand + len] == m->src[i + len]) )
+			len++;
+		if (len > best)
+		{
+			best = len;
+			*offset = i - cand;
+			if (i + len == limit)
+				break;
+		}
+		cand = m->prev[cand];
+	}
+	return (best >= MATCH_MIN) ? best : 0;
+}
+
+//---------------------------------------------- LZ77 -----------------------------------------------------
+static size_t lz77_var_size_bytes(size_t x)
+{
+	size_t bytes = 1;
+	while (x >>= 7)
+		bytes++;
+	return bytes;
+}
+
+static size_t lz77_write_var_size(uint8_t *dst, size_t x)
+{
+	size_t bytes = lz77_var_size_bytes(x);
+	for (size_t i = 0; i < bytes; i++)
+	{
+		uint8_t b = (x >> (7 * (bytes - 1 - i))) & 0x7F;
+		if (i + 1 < bytes)
+			b |= 0x80;
+		dst[i] = b;
+	}
+	return bytes;
+}
+
+static size_t encode_lz77(const uint8_t *src, size_t n, uint8_t *dst, size_t literal_tail)
+{
+	//the least used byte value is the marker, so few literals need escaping
+	size_t histogram[256] = {0};
+	for (size_t i = 0; i < n; i++)
+		histogram[src[i]]++;
+	uint8_t marker = 0;
+	for (int v = 1; v < 256; v++)
+		if (histogram[v] < histogram[marker])
+			marker = v;
+
+	matcher_t *m = match_init(src, n);
+	size_t limit = (n > literal_tail) ? n - literal_tail : 0;
+	size_t out = 0;
+	dst[out++] = marker;
+	size_t i = 0;
+	while (i < n)
+	{
+		size_t offset = 0;
+		size_t len = match_find(m, i, limit, (size_t)-1, &offset);
+		if ( len && (1 + lz77_var_size_bytes(len) + lz77_var_size_bytes(offset) < len) )
+		{
+			dst[out++] = marker;
+			out += lz77_write_var_size(&dst[out], len);
+			out += lz77_write_var_size(&dst[out], offset);
+			for (size_t k = 0; k < len; k++)
+				match_insert(m, i + k);
+			i += len;
+		}
+		else
+		{
+			dst[out++] = src[i];
+			if (src[i] == marker)
+				dst[out++] = 0;
+			match_insert(m, i);
+			i++;
+		}
+	}
+	match_free(m);
+	return out;
+}
+
+//---------------------------------------------- LZ4 ------------------------------------------------------
+//the block follows the reference format, so the last 5 bytes are literals
+//and the last match starts at least 12 bytes before the end
+static size_t lz4_write_length(uint8_t *dst, size_t length)
+{
+	size_t out = 0;
+	if (length < 15)
+		return 0;
+	length -= 15;
+	while (length >= 255)
+	{
+		dst[out++] = 255;
+		length -= 255;
+	}
+	dst[out++] = length;
+	return out;
+}
+
+static size_t lz4_write_sequence(uint8_t *dst, const uint8_t *literals, size_t literal_count, size_t offset, size_t match_length)
+{
+	size_t out = 0;
+	size_t match_code = match_length ? match_length - MATCH_MIN : 0;
+	dst[out++] = ((literal_count < 15 ? literal_count : 15) << 4) | (match_code < 15 ? match_code : 15);
+	out += lz4_write_length(&dst[out], literal_count);
+	memcpy(&dst[out], literals, literal_count);
+	out += literal_count;
+	if (match_length)
+	{
+		dst[out++] = offset & 0xFF;
+		dst[out++] = offset >> 8;
+		out += lz4_write_length(&dst[out], match_code);
+	}
+	return out;
+}
+
+static size_t encode_lz4(const uint8_t *src, size_t n, uint8_t *dst, size_t literal_tail)
+{
+	matcher_t *m = match_init(src, n);
+	size_t limit = (n > 5) ? n - 5 : 0;
+	size_t start_limit = (n > 12) ? n - 12 : 0;
+	if (literal_tail > n - limit)
+		limit = (n > literal_tail) ? n - literal_tail : 0;
+	if (start_limit > limit)
+		start_limit = limit;
+
+	size_t out = 0;
+	size_t anchor = 0;
+	size_t i = 0;
+	while (i < start_limit)
+	{
+		size_t offset = 0;
+		size_t len = match_find(m, i, limit, 0xFFFF, &offset);
+		if (len)
+		{
+			out += lz4_write_sequence(&dst[out], &src[anchor], i - anchor, offset, len);
+			for (size_t k = 0; k < len; k++)
+				match_insert(m, i + k);
+			i += len;
+			anchor = i;
+		}
+		else
+		{
+			match_insert(m, i);
+			i++;
+		}
+	}
+	if (anchor < n)
+		out += lz4_write_sequence(&dst[out], &src[anchor], n - anchor, 0, 0);
+	match_free(m);
+	return out;
+}
+
+size_t bgconv_encode(uint32_t codec, const uint8_t *src, size_t n, uint8_t *dst, size_t literal_tail)
+{
+	switch (codec)
+	{
+		case BACKGROUND_CODEC_LZ77:
+			return encode_lz77(src, n, dst, literal_tail);
+		case BACKGROUND_CODEC_LZ4:
+			return encode_lz4(src, n, dst, literal_tail);
+		case BACKGROUND_CODEC_RLE:
+			return background_codec_rle_encode(src, n, dst, literal_tail);
+	}
+	return 0;
+}
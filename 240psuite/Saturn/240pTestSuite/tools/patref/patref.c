@@ -0,0 +1,546 @@
+/* 
+ * 240p Test Suite for the Sega Saturn
+ * Host reference renderer for the pattern generators
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * Runs the real draw_* functions from the suite against a host copy of
+ * VDP2 VRAM and palette 2, then decodes NBG0 the way the VDP2 would show
+ * it: 4bpp 1024x512 bitmap or 8bpp 8x8 cells on a 2x1 plane. Every
+ * pattern variant is rendered in every NTSC and PAL screen mode.
+ *
+ *	patref -o dir				write every image as a PPM
+ *	patref -m golden.txt		write the checksum manifest
+ *	patref -c golden.txt		compare against the manifest
+ *	patref -g golden_dir [-o dir]	compare pixels against golden PPMs,
+ *								writing diff images to dir
+ *	patref -d a.ppm b.ppm [diff.ppm]	compare two images
+ *
+ * -p name only runs the patterns whose name starts with it.
+ * The VDP1 text layer is not rendered. VRAM is kept big-endian like on
+ * the Saturn, so golden.txt does not depend on the host byte order, and
+ * any write outside VDP2 VRAM counts as a failure.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <yaul.h>
+#include "patref.h"
+#include "video_vdp2.h"
+#include "ire.h"
+
+#define PATREF_NAME_MAX		64
+#define PATREF_PATH_MAX		512
+
+#define PATREF_NTSC_MODES	28
+#define PATREF_PAL_MODES	40
+
+typedef struct {
+	char	*name;
+	bool	bmp_mode;
+	int		variants;
+	void	(*draw)(video_screen_mode_t screenmode, int variant);
+	char	*(*variant_name)(int variant, char *buf);
+} patref_pattern_t;
+
+//---------------------------------------------- Pattern table ----------------------------------------------------
+static char *variant_number(int variant, char *buf)
+{
+	sprintf(buf, "%d", variant);
+	return buf;
+}
+
+static char *variant_bool(int variant, char *buf)
+{
+	strcpy(buf, variant ? "on" : "off");
+	return buf;
+}
+
+static char *variant_ire(int variant, char *buf)
+{
+	sprintf(buf, "%03d", variant*10);
+	return buf;
+}
+
+static const int overscan_sets[][4] = {
+	{ 0, 0, 0, 0 },
+	{ 8, 8, 8, 8 },
+	{ 3, 5, 7, 9 },
+};
+
+static char *variant_overscan(int variant, char *buf)
+{
+	sprintf(buf, "%d-%d-%d-%d", overscan_sets[variant][0], overscan_sets[variant][1],
+			overscan_sets[variant][2], overscan_sets[variant][3]);
+	return buf;
+}
+
+static void run_100ire(video_screen_mode_t m, int v)				{ draw_100ire(m, v*10); }
+static void run_colorbars(video_screen_mode_t m, int v)				{ (void)v; draw_colorbars(m); }
+static void run_colorbars_grayscale(video_screen_mode_t m, int v)	{ draw_colorbars_grayscale(m, v); }
+static void run_colorbleed(video_screen_mode_t m, int v)			{ draw_colorbleed(m, v); }
+static void run_convergence(video_screen_mode_t m, int v)			{ draw_convergence(m, v); }
+static void run_ebu(video_screen_mode_t m, int v)					{ draw_ebu(m, v); }
+static void run_grayramp(video_screen_mode_t m, int v)				{ (void)v; draw_grayramp(m); }
+static void run_grid(video_screen_mode_t m, int v)					{ (void)v; draw_grid(m); }
+static void run_pluge(video_screen_mode_t m, int v)					{ draw_pluge(m, v); }
+static void run_smpte(video_screen_mode_t m, int v)					{ draw_smpte(m, v); }
+static void run_whitescreen(video_screen_mode_t m, int v)			{ draw_whitescreen(m, v); }
+
+static void run_overscan(video_screen_mode_t m, int v)
+{
+	draw_overscan(m, overscan_sets[v][0], overscan_sets[v][1], overscan_sets[v][2], overscan_sets[v][3], 0);
+}
+
+static void run_monoscope(video_screen_mode_t m, int v)
+{
+	patref_set_monoscope_mode(m);
+	draw_monoscope(m, v);
+}
+
+static void run_sharpness(video_screen_mode_t m, int v)
+{
+	patref_set_sharpness_mode(m);
+	draw_sharpness(m, v);
+}
+
+static void run_sharpness_bricks(video_screen_mode_t m, int v)
+{
+	(void)v;
+	patref_set_sharpness_mode(m);
+	draw_sharpness_pattern2(m);
+}
+
+static const patref_pattern_t patterns[] = {
+	{ "100ire",				false,	11,	run_100ire,					variant_ire },
+	{ "colorbars",			false,	1,	run_colorbars,				variant_number },
+	{ "colorbars_grayscale",true,	2,	run_colorbars_grayscale,	variant_bool },
+	{ "colorbleed",			false,	2,	run_colorbleed,				variant_bool },
+	{ "convergence",		true,	5,	run_convergence,			variant_number },
+	{ "ebu",				true,	2,	run_ebu,					variant_bool },
+	{ "grayramp",			false,	1,	run_grayramp,				variant_number },
+	{ "grid",				false,	1,	run_grid,					variant_number },
+	{ "monoscope",			true,	2,	run_monoscope,				variant_bool },
+	{ "overscan",			true,	3,	run_overscan,				variant_overscan },
+	{ "pluge",				true,	2,	run_pluge,					variant_bool },
+	{ "sharpness",			true,	2,	run_sharpness,				variant_bool },
+	{ "sharpness_bricks",	false,	1,	run_sharpness_bricks,		variant_number },
+	{ "smpte",				true,	2,	run_smpte,					variant_bool },
+	{ "whitescreen",		false,	5,	run_whitescreen,			variant_number },
+};
+
+#define PATREF_PATTERNS (int)(sizeof(patterns)/sizeof(patterns[0]))
+
+//---------------------------------------------- NBG0 decoding ----------------------------------------------------
+static void put_palette_color(patref_image_t *image, int x, int y, int index)
+{
+	uint8_t *dst = &image->rgb[(y*image->width + x)*3];
+	dst[0] = patref_vdp2.palette[index].r;
+	dst[1] = patref_vdp2.palette[index].g;
+	dst[2] = patref_vdp2.palette[index].b;
+}
+
+static void render_bitmap(patref_image_t *image)
+{
+	//4bpp 1024x512, the special modes show NBG0 and NBG1 interleaved
+	//from identical copies so NBG0 alone is the full picture
+	uint8_t *bitmap = (uint8_t *)VIDEO_VDP2_NBG0_CHPNDR_START;
+	if (is_screenmode_special(patref_vdp2.screenmode))
+		bitmap = (uint8_t *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START;
+
+	for (int y = 0; y < image->height; y++)
+	{
+		for (int x = 0; x < image->width; x++)
+		{
+			uint8_t dots = bitmap[y*512 + x/2];
+			put_palette_color(image, x, y, (x%2) ? (dots & 0x0F) : (dots >> 4));
+		}
+	}
+}
+
+static void render_cells(patref_image_t *image)
+{
+	//8bpp 8x8 characters, 2-word pattern names, plane of 2x1 64x64 pages
+	uint32_t *names = (uint32_t *)VIDEO_VDP2_NBG0_PNDR_START;
+	if (is_screenmode_special(patref_vdp2.screenmode))
+		names = (uint32_t *)VIDEO_VDP2_NBG0_SPECIAL_PNDR_START;
+
+	for (int y = 0; y < image->height; y++)
+	{
+		int cell_y = (y/8) % 64;
+		for (int x = 0; x < image->width; x++)
+		{
+			int cell_x = (x/8) % 128;
+			uint32_t pnd = VIDEO_VDP2_READ32(&names[(cell_x/64)*64*64 + cell_y*64 + cell_x%64]);
+			int palette = ((pnd >> 16) & 0x7F) >> 4;
+			int dot_x = (pnd & 0x40000000) ? 7 - x%8 : x%8;
+			int dot_y = (pnd & 0x80000000) ? 7 - y%8 : y%8;
+
+			if (palette != 2)
+			{
+				//palette 0 is the transparent filler from video_vdp2_init()
+				memset(&image->rgb[(y*image->width + x)*3], 0x00, 3);
+				continue;
+			}
+			uint8_t *character = &patref_vdp2_vram[(pnd & 0x7FFF)*32];
+			put_palette_color(image, x, y, character[dot_y*8 + dot_x]);
+		}
+	}
+}
+
+void patref_render_nbg0(patref_image_t *image)
+{
+	image->width = get_screenmode_resolution_x(patref_vdp2.screenmode);
+	image->height = get_screenmode_resolution_y(patref_vdp2.screenmode);
+	image->rgb = (uint8_t *)realloc(image->rgb, image->width*image->height*3);
+	if (!image->rgb)
+	{
+		fprintf(stderr, "Out of memory for a %dx%d image\n", image->width, image->height);
+		exit(2);
+	}
+
+	if (patref_vdp2.bmp_mode)
+		render_bitmap(image);
+	else
+		render_cells(image);
+}
+
+//---------------------------------------------- Images ----------------------------------------------------
+static int write_ppm(const char *path, const patref_image_t *image)
+{
+	FILE *file = fopen(path, "wb");
+	if (!file)
+	{
+		fprintf(stderr, "Could not write %s\n", path);
+		return 0;
+	}
+	fprintf(file, "P6\n%d %d\n255\n", image->width, image->height);
+	fwrite(image->rgb, 3, image->width*image->height, file);
+	fclose(file);
+	return 1;
+}
+
+static int read_ppm(const char *path, patref_image_t *image)
+{
+	int maxval = 0;
+	FILE *file = fopen(path, "rb");
+	if (!file)
+		return 0;
+	if (fscanf(file, "P6 %d %d %d", &image->width, &image->height, &maxval) != 3 || maxval != 255)
+	{
+		fclose(file);
+		return 0;
+	}
+	fgetc(file);
+	image->rgb = (uint8_t *)realloc(image->rgb, image->width*image->height*3);
+	if (!image->rgb || fread(image->rgb, 3, image->width*image->height, file) != (size_t)(image->width*image->height))
+	{
+		fclose(file);
+		return 0;
+	}
+	fclose(file);
+	return 1;
+}
+
+//FNV-1a, 64 bit
+static uint64_t hash_image(const patref_image_t *image)
+{
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	const int size = image->width*image->height*3;
+
+	hash = (hash ^ (uint64_t)image->width) * 0x100000001B3ULL;
+	hash = (hash ^ (uint64_t)image->height) * 0x100000001B3ULL;
+	for (int i = 0; i < size; i++)
+		hash = (hash ^ image->rgb[i]) * 0x100000001B3ULL;
+	return hash;
+}
+
+//Returns the number of differing pixels, optionally filling a diff image
+//where mismatches are red over a dimmed copy of the expected image
+static int diff_images(const patref_image_t *expected, const patref_image_t *actual, patref_image_t *diff)
+{
+	int count = 0, x1 = expected->width, y1 = expected->height, x2 = -1, y2 = -1;
+
+	if (expected->width != actual->width || expected->height != actual->height)
+	{
+		printf("  size %dx%d, expected %dx%d\n", actual->width, actual->height, expected->width, expected->height);
+		return expected->width*expected->height;
+	}
+
+	if (memcmp(expected->rgb, actual->rgb, expected->width*expected->height*3) == 0)
+		return 0;
+
+	if (diff)
+	{
+		diff->width = expected->width;
+		diff->height = expected->height;
+		diff->rgb = (uint8_t *)realloc(diff->rgb, diff->width*diff->height*3);
+	}
+
+	for (int y = 0; y < expected->height; y++)
+	{
+		for (int x = 0; x < expected->width; x++)
+		{
+			int offset = (y*expected->width + x)*3;
+			int differs = memcmp(&expected->rgb[offset], &actual->rgb[offset], 3) != 0;
+
+			if (differs)
+			{
+				count++;
+				if (x < x1) x1 = x;
+				if (y < y1) y1 = y;
+				if (x > x2) x2 = x;
+				if (y > y2) y2 = y;
+			}
+			if (diff && diff->rgb)
+			{
+				diff->rgb[offset] = differs ? 255 : expected->rgb[offset]/4;
+				diff->rgb[offset+1] = differs ? 0 : expected->rgb[offset+1]/4;
+				diff->rgb[offset+2] = differs ? 0 : expected->rgb[offset+2]/4;
+			}
+		}
+	}
+	printf("  %d pixels differ in (%d,%d)-(%d,%d)\n", count, x1, y1, x2, y2);
+	return count;
+}
+
+//---------------------------------------------- Driver ----------------------------------------------------
+typedef enum {
+	PATREF_WRITE = 0,
+	PATREF_MANIFEST,
+	PATREF_CHECK,
+	PATREF_GOLDEN
+} patref_action_t;
+
+static void image_name(char *buf, const patref_pattern_t *pattern, int variant, vdp2_tvmd_tv_standard_t standard, int number)
+{
+	char variant_buf[PATREF_NAME_MAX];
+
+	sprintf(buf, "%s_%s_%s%02d", pattern->name, pattern->variant_name(variant, variant_buf),
+			VDP2_TVMD_TV_STANDARD_NTSC == standard ? "ntsc" : "pal", number);
+}
+
+static int manifest_lookup(FILE *manifest, const char *name, uint64_t *hash)
+{
+	char line[PATREF_PATH_MAX], entry[PATREF_PATH_MAX];
+	unsigned long long value;
+
+	rewind(manifest);
+	while (fgets(line, sizeof(line), manifest))
+	{
+		if (sscanf(line, "%llx %s", &value, entry) == 2 && strcmp(entry, name) == 0)
+		{
+			*hash = value;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int run_all(patref_action_t action, const char *target, const char *outdir, const char *filter)
+{
+	patref_image_t image = { 0, 0, NULL }, golden = { 0, 0, NULL }, diff = { 0, 0, NULL };
+	char name[PATREF_PATH_MAX], path[PATREF_PATH_MAX + PATREF_NAME_MAX];
+	int images = 0, failures = 0;
+	bool stray_reported;
+	FILE *manifest = NULL;
+
+	if (action == PATREF_MANIFEST || action == PATREF_CHECK)
+	{
+		manifest = fopen(target, action == PATREF_MANIFEST ? "w" : "r");
+		if (!manifest)
+		{
+			fprintf(stderr, "Could not open %s\n", target);
+			return 2;
+		}
+	}
+
+	for (int p = 0; p < PATREF_PATTERNS; p++)
+	{
+		const patref_pattern_t *pattern = &patterns[p];
+
+		if (filter && strncmp(pattern->name, filter, strlen(filter)) != 0)
+			continue;
+		stray_reported = false;
+
+		for (int s = 0; s < 2; s++)
+		{
+			vdp2_tvmd_tv_standard_t standard = s ? VDP2_TVMD_TV_STANDARD_PAL : VDP2_TVMD_TV_STANDARD_NTSC;
+			int modes = s ? PATREF_PAL_MODES : PATREF_NTSC_MODES;
+
+			for (int number = 0; number < modes; number++)
+			{
+				video_screen_mode_t screenmode = create_screenmode_by_number(standard, number);
+
+				for (int variant = 0; variant < pattern->variants; variant++)
+				{
+					update_screen_mode(screenmode, pattern->bmp_mode);
+					pattern->draw(screenmode, variant);
+					patref_render_nbg0(&image);
+					image_name(name, pattern, variant, standard, number);
+					if (!stray_reported && patref_vdp2_guard_touched())
+					{
+						printf("%s: wrote outside VDP2 VRAM\n", name);
+						stray_reported = true;
+						failures++;
+					}
+					images++;
+
+					if (action == PATREF_WRITE)
+					{
+						sprintf(path, "%s/%s.ppm", outdir, name);
+						if (!write_ppm(path, &image))
+							return 2;
+					}
+					else if (action == PATREF_MANIFEST)
+					{
+						fprintf(manifest, "%016llx %s\n", (unsigned long long)hash_image(&image), name);
+					}
+					else if (action == PATREF_CHECK)
+					{
+						uint64_t expected;
+						if (!manifest_lookup(manifest, name, &expected))
+						{
+							printf("%s: not in manifest\n", name);
+							failures++;
+						}
+						else if (expected != hash_image(&image))
+						{
+							printf("%s: checksum mismatch\n", name);
+							failures++;
+							if (outdir)
+							{
+								sprintf(path, "%s/%s.ppm", outdir, name);
+								write_ppm(path, &image);
+							}
+						}
+					}
+					else
+					{
+						sprintf(path, "%s/%s.ppm", target, name);
+						if (!read_ppm(path, &golden))
+						{
+							printf("%s: no golden image\n", name);
+							failures++;
+							continue;
+						}
+						if (diff_images(&golden, &image, outdir ? &diff : NULL))
+						{
+							printf("%s: pixel mismatch\n", name);
+							failures++;
+							if (outdir && diff.rgb)
+							{
+								sprintf(path, "%s/%s_diff.ppm", outdir, name);
+								write_ppm(path, &diff);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (manifest)
+		fclose(manifest);
+	free(image.rgb);
+	free(golden.rgb);
+	free(diff.rgb);
+
+	printf("%d images, %d mismatches\n", images, failures);
+	return failures ? 1 : 0;
+}
+
+static int diff_files(const char *expected_path, const char *actual_path, const char *diff_path)
+{
+	patref_image_t expected = { 0, 0, NULL }, actual = { 0, 0, NULL }, diff = { 0, 0, NULL };
+	int count;
+
+	if (!read_ppm(expected_path, &expected) || !read_ppm(actual_path, &actual))
+	{
+		fprintf(stderr, "Could not read %s or %s\n", expected_path, actual_path);
+		return 2;
+	}
+	count = diff_images(&expected, &actual, diff_path ? &diff : NULL);
+	if (count && diff_path && diff.rgb)
+		write_ppm(diff_path, &diff);
+	printf("%s\n", count ? "images differ" : "images match");
+
+	free(expected.rgb);
+	free(actual.rgb);
+	free(diff.rgb);
+	return count ? 1 : 0;
+}
+
+static void usage()
+{
+	printf("patref -o dir | -m manifest | -c manifest [-o dir] | -g golden_dir [-o dir] [-p pattern]\n");
+	printf("patref -d expected.ppm actual.ppm [diff.ppm]\n");
+}
+
+int main(int argc, char **argv)
+{
+	patref_action_t action = PATREF_WRITE;
+	const char *target = NULL, *outdir = NULL, *filter = NULL;
+
+	if (argc > 1 && strcmp(argv[1], "-d") == 0)
+	{
+		if (argc < 4)
+		{
+			usage();
+			return 2;
+		}
+		return diff_files(argv[2], argv[3], argc > 4 ? argv[4] : NULL);
+	}
+
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "-o") == 0)
+			outdir = argv[++i];
+		else if (strcmp(argv[i], "-p") == 0)
+			filter = argv[++i];
+		else if (strcmp(argv[i], "-m") == 0)
+		{
+			action = PATREF_MANIFEST;
+			target = argv[++i];
+		}
+		else if (strcmp(argv[i], "-c") == 0)
+		{
+			action = PATREF_CHECK;
+			target = argv[++i];
+		}
+		else if (strcmp(argv[i], "-g") == 0)
+		{
+			action = PATREF_GOLDEN;
+			target = argv[++i];
+		}
+	}
+
+	if (action == PATREF_WRITE && !outdir)
+	{
+		usage();
+		return 2;
+	}
+
+	//the suite defaults, so the IRE levels match what the console shows
+	ire_level_0 = 0;
+	ire_level_100 = 255;
+
+	return run_all(action, target, outdir, filter);
+}
@@ -0,0 +1,68 @@
+/* 
+ * 240p Test Suite for the Sega Saturn
+ * Host reference renderer for the pattern generators
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#ifndef PATREF_H
+#define PATREF_H
+
+#include <yaul.h>
+#include "video.h"
+
+//VDP2 state as left behind by the last video_vdp2_init() and palette writes
+typedef struct {
+	video_screen_mode_t	screenmode;
+	bool				bmp_mode;
+	int					color_mode;		//CRAM mode, 0 is RGB555 and 2 is RGB888
+	rgb888_t			palette[256];	//palette 2, the only one the patterns use
+} patref_vdp2_t;
+
+extern patref_vdp2_t patref_vdp2;
+
+typedef struct {
+	int		width;
+	int		height;
+	uint8_t	*rgb;
+} patref_image_t;
+
+void patref_render_nbg0(patref_image_t *image);
+bool patref_vdp2_guard_touched();
+
+//pattern_monoscope.c and pattern_sharpness.c keep their mode in a static
+void patref_set_monoscope_mode(video_screen_mode_t screenmode);
+void patref_set_sharpness_mode(video_screen_mode_t screenmode);
+
+//Drawing entry points, not exported by the pattern headers
+void draw_100ire(video_screen_mode_t screenmode, int ire_level);
+void draw_colorbars(video_screen_mode_t screenmode);
+void draw_colorbars_grayscale(video_screen_mode_t screenmode, bool bIRE100);
+void draw_colorbleed(video_screen_mode_t screenmode, bool checkered);
+void draw_convergence(video_screen_mode_t screenmode, int iPattern);
+void draw_ebu(video_screen_mode_t screenmode, bool bIRE100);
+void draw_grayramp(video_screen_mode_t screenmode);
+void draw_grid(video_screen_mode_t screenmode);
+void draw_monoscope(video_screen_mode_t screenmode, bool bIRE100);
+void draw_overscan(video_screen_mode_t screenmode, int top, int bottom, int left, int right, int cursor);
+void draw_pluge(video_screen_mode_t screenmode, bool bFullRange);
+void draw_sharpness(video_screen_mode_t screenmode, bool bIRE100);
+void draw_sharpness_pattern2(video_screen_mode_t screenmode);
+void draw_smpte(video_screen_mode_t screenmode, bool bIRE100);
+void draw_whitescreen(video_screen_mode_t screenmode, int color);
+
+#endif /* !PATREF_H */
@@ -0,0 +1,180 @@
+/* 
+ * 240p Test Suite for the Sega Saturn
+ * Host stand-ins for VDP1/VDP2, SMPC and the text layer
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <yaul.h>
+#include "patref.h"
+#include "video_vdp2.h"
+#include "font.h"
+#include "control.h"
+#include "input.h"
+
+uint8_t patref_vdp2_memory[PATREF_VDP2_VRAM_GUARD + PATREF_VDP2_VRAM_SIZE + PATREF_VDP2_VRAM_GUARD];
+patref_vdp2_t patref_vdp2;
+
+int _fh = 8;
+int _fw = 8;
+
+struct smpc_peripheral_digital controller;
+
+//---------------------------------------------- VDP2 ----------------------------------------------------
+void video_vdp2_init(video_screen_mode_t screen_mode, bool bmp_mode)
+{
+	//the patterns must not depend on what a previous pattern left in VRAM
+	memset(patref_vdp2_memory, 0x00, sizeof(patref_vdp2_memory));
+	patref_vdp2.screenmode = screen_mode;
+	patref_vdp2.bmp_mode = bmp_mode;
+	patref_vdp2.color_mode = is_screenmode_special(screen_mode) ? 0 : 2;
+}
+
+bool patref_vdp2_guard_touched()
+{
+	for (int i = 0; i < PATREF_VDP2_VRAM_GUARD; i++)
+		if (patref_vdp2_memory[i] || patref_vdp2_memory[PATREF_VDP2_VRAM_GUARD + PATREF_VDP2_VRAM_SIZE + i])
+			return true;
+	return false;
+}
+
+void video_vdp2_deinit()
+{
+}
+
+void video_vdp2_set_cycle_patterns_cpu()
+{
+}
+
+void video_vdp2_set_cycle_patterns_nbg(video_screen_mode_t screen_mode)
+{
+	(void)screen_mode;
+}
+
+void video_vdp2_set_cycle_patterns_nbg_bmp(video_screen_mode_t screen_mode)
+{
+	(void)screen_mode;
+}
+
+void video_vdp2_set_palette_part(int number, rgb888_t *pointer, int start, int end)
+{
+	if (number != 2)
+		return;
+	for (int i = start; i <= end; i++)
+	{
+		rgb888_t color = pointer[i-start];
+		if (patref_vdp2.color_mode == 0)
+		{
+			//RGB555 CRAM keeps the top 5 bits, expand them back like the DAC does
+			color.r = (color.r & 0xF8) | (color.r >> 5);
+			color.g = (color.g & 0xF8) | (color.g >> 5);
+			color.b = (color.b & 0xF8) | (color.b >> 5);
+		}
+		patref_vdp2.palette[i] = color;
+	}
+}
+
+void video_vdp2_clear_palette_part(int number, int start, int end)
+{
+	if (number != 2)
+		return;
+	memset(&patref_vdp2.palette[start], 0x00, (end-start+1)*sizeof(rgb888_t));
+}
+
+void video_vdp2_clear_palette(int number)
+{
+	video_vdp2_clear_palette_part(number,0,255);
+}
+
+//---------------------------------------------- SCU ----------------------------------------------------
+void scu_dma_transfer(int level, void *dst, const void *src, size_t len)
+{
+	(void)level;
+	memcpy(dst, src, len);
+}
+
+void scu_dma_transfer_wait(int level)
+{
+	(void)level;
+}
+
+//---------------------------------------------- VDP1 and text ----------------------------------------------------
+void video_vdp1_init(video_screen_mode_t screen_mode)
+{
+	(void)screen_mode;
+}
+
+void video_vdp1_deinit()
+{
+}
+
+void SetFontPalette()
+{
+}
+
+void DrawString(char *str, unsigned int x, unsigned int y, unsigned int palette)
+{
+	(void)str; (void)x; (void)y; (void)palette;
+}
+
+void DrawStringWithBackground(char *str, unsigned int x, unsigned int y, unsigned int palette, unsigned int bg_palette)
+{
+	(void)str; (void)x; (void)y; (void)palette; (void)bg_palette;
+}
+
+void DrawChar(unsigned int x, unsigned int y, char c, unsigned int palette, bool transparent)
+{
+	(void)x; (void)y; (void)c; (void)palette; (void)transparent;
+}
+
+void ClearText(int left, int top, int width, int height)
+{
+	(void)left; (void)top; (void)width; (void)height;
+}
+
+void ClearTextLayer()
+{
+}
+
+//---------------------------------------------- Input ----------------------------------------------------
+//The interactive loops are linked in but never entered by the renderer
+void smpc_peripheral_init(void)
+{
+}
+
+void smpc_peripheral_process(void)
+{
+}
+
+void vdp2_tvmd_vblank_in_wait(void)
+{
+}
+
+void vdp2_tvmd_vblank_out_wait(void)
+{
+}
+
+void get_digital_keypress_anywhere(smpc_peripheral_digital_t *digital)
+{
+	memset(digital, 0x00, sizeof(*digital));
+}
+
+void wait_for_key_unpress()
+{
+}
@@ -0,0 +1,38 @@
+/* 
+ * 240p Test Suite for the Sega Saturn
+ * Pulls in the pattern generators that keep their screen mode in a static
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#define curr_screenmode monoscope_screenmode
+#include "pattern_monoscope.c"
+#undef curr_screenmode
+
+void patref_set_monoscope_mode(video_screen_mode_t screenmode)
+{
+	monoscope_screenmode = screenmode;
+}
+
+#define curr_screenmode sharpness_screenmode
+#include "pattern_sharpness.c"
+#undef curr_screenmode
+
+void patref_set_sharpness_mode(video_screen_mode_t screenmode)
+{
+	sharpness_screenmode = screenmode;
+}
@@ -0,0 +1,102 @@
+/* 
+ * 240p Test Suite for the Sega Saturn
+ * Host stand-in for the parts of <yaul.h> used by the pattern generators
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#ifndef PATREF_YAUL_H
+#define PATREF_YAUL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef __packed
+#define __packed __attribute__ ((packed))
+#endif
+
+//VDP2 VRAM is four 128KB banks, backed by a host array with a guard band
+//on each side so stray writes are caught instead of corrupting the host
+#define PATREF_VDP2_VRAM_SIZE	0x80000
+#define PATREF_VDP2_VRAM_GUARD	0x10000
+extern uint8_t patref_vdp2_memory[PATREF_VDP2_VRAM_GUARD + PATREF_VDP2_VRAM_SIZE + PATREF_VDP2_VRAM_GUARD];
+
+#define patref_vdp2_vram	(&patref_vdp2_memory[PATREF_VDP2_VRAM_GUARD])
+#define VDP2_VRAM_ADDR(bank, offset)	((uintptr_t)&patref_vdp2_vram[(0x20000*(bank)) + (offset)])
+
+//VRAM is big-endian, word stores from the suite are swapped on the way in
+//so character data and pattern names keep the Saturn byte order
+#define VIDEO_VDP2_WRITE32(ptr, value)	(*(ptr) = (__typeof__(*(ptr)))__builtin_bswap32((uint32_t)(value)))
+#define VIDEO_VDP2_READ32(ptr)	((__typeof__(*(ptr)))__builtin_bswap32((uint32_t)*(ptr)))
+
+typedef enum {
+        VDP2_TVMD_VERT_224 = 0,
+        VDP2_TVMD_VERT_240 = 1,
+        VDP2_TVMD_VERT_256 = 2
+} __packed vdp2_tvmd_vert_t;
+
+typedef enum {
+        VDP2_TVMD_TV_STANDARD_NTSC = 0,
+        VDP2_TVMD_TV_STANDARD_PAL = 1
+} __packed vdp2_tvmd_tv_standard_t;
+
+typedef struct {
+        uint8_t cc;
+        uint8_t b;
+        uint8_t g;
+        uint8_t r;
+} __packed rgb888_t;
+
+struct smpc_peripheral_digital {
+        uint8_t connected;
+        uint8_t port;
+        uint8_t type;
+        uint8_t size;
+        union {
+                struct {
+                        unsigned int right:1;
+                        unsigned int left:1;
+                        unsigned int down:1;
+                        unsigned int up:1;
+                        unsigned int start:1;
+                        unsigned int a:1;
+                        unsigned int c:1;
+                        unsigned int b:1;
+                        unsigned int r:1;
+                        unsigned int x:1;
+                        unsigned int y:1;
+                        unsigned int z:1;
+                        unsigned int l:1;
+                } __packed button;
+                uint16_t raw;
+        } pressed, held, released;
+};
+
+typedef struct smpc_peripheral_digital smpc_peripheral_digital_t;
+
+void scu_dma_transfer(int level, void *dst, const void *src, size_t len);
+void scu_dma_transfer_wait(int level);
+
+void smpc_peripheral_init(void);
+void smpc_peripheral_process(void);
+void vdp2_tvmd_vblank_in_wait(void);
+void vdp2_tvmd_vblank_out_wait(void);
+
+#endif /* !PATREF_YAUL_H */
@@ -0,0 +1,445 @@
+/*
+ * 240p Test Suite for the Sega Saturn
+ * VDP2 VRAM cycle pattern validator
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * Runs the real video_vdp2_init() for every screen mode, in cell and in
+ * bitmap mode, and checks the VRAM cycle pattern it leaves against the
+ * layers it sets up:
+ *
+ *  - every bank holding a layer's pattern names or character/bitmap data
+ *    has enough reads for it: 1 pattern name read, 1/2/4/4/8 data reads
+ *    for 16/256/2048/32K/16M colors, both doubled by 1/2 reduction
+ *  - character reads follow a pattern name read of the same layer by at
+ *    most 2 slots (the i(Tn) table in video_vdp2.h). That is the hi-res
+ *    rule, normal resolution allows more, so there it is only a warning
+ *  - hi-res modes only have T0-T3, anything set in T4-T7 is ignored
+ *
+ * It then reports what is left for the CPU. During active display the CPU
+ * only gets the CPU_RW slots, during blanking every slot. Each bank does
+ * one 16-bit access per normal-resolution dot clock.
+ *
+ *	vdp2cyc [-v]			check the suite's tables in every mode
+ *	vdp2cyc -m ntsc08 [-b] [-t table] [-v]
+ *
+ * -m picks one mode by the names patref uses, -b the bitmap setup, and -t
+ * checks a proposed table for it instead of the suite's one. The table is
+ * written like the comments in video_vdp2.c, banks A0;A1;B0;B1 with 4 or
+ * 8 slots each: D0/D1 character data, i0/i1 pattern names, C CPU, x none
+ *
+ *	-t "D0 D0 D1 D1;D0 D0 D1 D1;D0 D0 D1 D1;i0 i1 D1 D1"
+ *
+ * The -draw rows show the CPU-only table the patterns are drawn with.
+ */
+
+#include "vdp2cyc.h"
+#include "video_vdp2.h"
+
+#define BANK_SIZE 0x20000
+#define BANKS 4
+
+static const char *bank_names[BANKS] = { "A0", "A1", "B0", "B1" };
+static bool verbose = false;
+
+typedef struct {
+	int errors;
+	int warnings;
+	int cpu_slots[BANKS];
+	int slots;
+	double active_rate;		//CPU bytes per second while the display is drawn
+	double average_rate;	//including blanking
+} vdp2cyc_result_t;
+
+static uint8_t slot_code(const struct vdp2_vram_cycp *cycp, int bank, int t)
+{
+	const uint8_t *pt = &cycp->pt[bank].t0;
+	return pt[t];
+}
+
+static int bank_of(uintptr_t addr)
+{
+	return (int)((addr - VDP2_VRAM_ADDR(0,0)) / BANK_SIZE);
+}
+
+static int data_reads(int ccc)
+{
+	switch (ccc)
+	{
+		case VDP2_SCRN_CCC_PALETTE_16: return 1;
+		case VDP2_SCRN_CCC_PALETTE_256: return 2;
+		case VDP2_SCRN_CCC_PALETTE_2048: return 4;
+		case VDP2_SCRN_CCC_RGB_32768: return 4;
+	}
+	return 8;
+}
+
+static int bits_per_pixel(int ccc)
+{
+	switch (ccc)
+	{
+		case VDP2_SCRN_CCC_PALETTE_16: return 4;
+		case VDP2_SCRN_CCC_PALETTE_256: return 8;
+		case VDP2_SCRN_CCC_RGB_16770000: return 32;
+	}
+	return 16;
+}
+
+static int reduction_factor(int reduction)
+{
+	return (reduction == VDP2_SCRN_REDUCTION_QUARTER) ? 4 :
+			(reduction == VDP2_SCRN_REDUCTION_HALF) ? 2 : 1;
+}
+
+//banks holding the layer's character or bitmap data, as a bit mask. cell
+//data can sit anywhere, so this uses the suite's layout from video_vdp2.h
+static int data_banks(const vdp2cyc_layer_t *layer, int number, bool special)
+{
+	uintptr_t start, size;
+	if (layer->bitmap)
+	{
+		int width = (layer->bitmap_size & 1) ? 1024 : 512;
+		int height = (layer->bitmap_size & 2) ? 512 : 256;
+		start = layer->bitmap_base;
+		size = width*height*bits_per_pixel(layer->ccc)/8;
+	}
+	else if (special)
+	{
+		start = number ? VIDEO_VDP2_NBG1_SPECIAL_CHPNDR_START : VIDEO_VDP2_NBG0_SPECIAL_CHPNDR_START;
+		size = number ? VIDEO_VDP2_NBG1_SPECIAL_CHPNDR_SIZE : VIDEO_VDP2_NBG0_SPECIAL_CHPNDR_SIZE;
+	}
+	else
+	{
+		start = number ? VIDEO_VDP2_NBG1_CHPNDR_START : VIDEO_VDP2_NBG0_CHPNDR_START;
+		size = number ? VIDEO_VDP2_NBG1_CHPNDR_SIZE : VIDEO_VDP2_NBG0_CHPNDR_SIZE;
+	}
+	int mask = 0;
+	for (int bank = bank_of(start); bank <= bank_of(start + size - 1) && bank < BANKS; bank++)
+		mask |= 1 << bank;
+	return mask;
+}
+
+static void finding(vdp2cyc_result_t *result, bool error, const char *label, const char *fmt, int a, int b, int c)
+{
+	if (error)
+		result->errors++;
+	else
+		result->warnings++;
+	if (verbose)
+	{
+		printf("  %s %s: ", label, error ? "error" : "warning");
+		printf(fmt, a, b, c);
+		printf("\n");
+	}
+}
+
+//---------------------------------------------- timing ---------------------------------------------------
+//dot clock of the normal resolution, hi-res doubles the dots but not the
+//VRAM accesses. 31kHz modes run the same dots per line twice as fast
+static void mode_timing(video_screen_mode_t mode, double *dot_clock, double *dots, double *lines)
+{
+	bool ntsc = (VDP2_TVMD_TV_STANDARD_NTSC == mode.colorsystem);
+	bool wide = (VIDEO_X_RESOLUTION_352 == mode.x_res);
+	*dot_clock = ntsc ? (wide ? 28636363.0 : 26846591.0)/4 : (wide ? 28437500.0 : 26687500.0)/4;
+	*dots = wide ? 455 : 427;
+	*lines = ntsc ? 263 : 313;
+	if (VIDEO_SCANMODE_480P == mode.scanmode)
+	{
+		*dot_clock *= 2;
+		*lines = 525;
+	}
+}
+
+//---------------------------------------------- model ----------------------------------------------------
+static vdp2cyc_result_t check(const vdp2cyc_state_t *state, video_screen_mode_t mode, bool layers, const char *label)
+{
+	vdp2cyc_result_t result;
+	memset(&result, 0x00, sizeof(result));
+	bool hires = (state->horz & 2) ? true : false;
+	bool special = is_screenmode_special(mode);
+	result.slots = hires ? 4 : 8;
+
+	for (int bank = 0; bank < BANKS; bank++)
+	{
+		for (int t = 0; t < 8; t++)
+		{
+			uint8_t code = slot_code(&state->cycp, bank, t);
+			if (t >= result.slots)
+			{
+				if (code != VDP2_VRAM_CYCP_NO_ACCESS)
+					finding(&result, false, label, "bank %d T%d is set but hi-res only has T0-T3", bank, t, 0);
+				continue;
+			}
+			if ( (code >= 0x8) && (code <= 0xB) )
+				finding(&result, true, label, "bank %d T%d has the prohibited code %X", bank, t, code);
+			if (code == VDP2_VRAM_CYCP_CPU_RW)
+				result.cpu_slots[bank]++;
+		}
+	}
+
+	for (int number = 0; layers && number < 2; number++)
+	{
+		const vdp2cyc_layer_t *layer = &state->layer[number];
+		if (!layer->enabled)
+			continue;
+		int factor = reduction_factor(layer->reduction);
+		int banks = data_banks(layer, number, special);
+		int needed = data_reads(layer->ccc)*factor;
+		int pn_slots = 0; //bit mask of slots reading this layer's pattern names
+
+		if (!layer->bitmap)
+		{
+			int pn_bank = bank_of(layer->plane_a);
+			int reads = 0;
+			for (int t = 0; t < result.slots; t++)
+			{
+				if (slot_code(&state->cycp, pn_bank, t) == VDP2_VRAM_CYCP_PNDR_NBG0 + number)
+				{
+					reads++;
+					pn_slots |= 1 << t;
+				}
+			}
+			if (reads < factor)
+				finding(&result, true, label, "NBG%d needs %d pattern name read(s) in bank %d", number, factor, pn_bank);
+		}
+
+		for (int bank = 0; bank < BANKS; bank++)
+		{
+			if (!(banks & (1 << bank)))
+				continue;
+			int reads = 0;
+			for (int t = 0; t < result.slots; t++)
+			{
+				if (slot_code(&state->cycp, bank, t) != VDP2_VRAM_CYCP_CHPNDR_NBG0 + number)
+					continue;
+				reads++;
+				if (layer->bitmap)
+					continue;
+				//a read is fine if some pattern name read is at most 2 slots before it
+				bool in_window = false;
+				for (int back = 0; back <= 2; back++)
+					if (pn_slots & (1 << ((t - back + result.slots) % result.slots)))
+						in_window = true;
+				if (!in_window)
+					finding(&result, hires, label, "NBG%d character read at T%d of bank %d is too far from its pattern name read", number, t, bank);
+			}
+			if (reads < needed)
+				finding(&result, true, label, "NBG%d needs %d data read(s) in bank %d", number, needed, bank);
+		}
+	}
+
+	double dot_clock, dots, lines;
+	mode_timing(mode, &dot_clock, &dots, &lines);
+	double active = (VIDEO_X_RESOLUTION_320 == mode.x_res ? 320 : 352)/dots *
+					((VIDEO_SCANMODE_480P == mode.scanmode) ? get_screenmode_resolution_y(mode) :
+					 get_screenmode_resolution_y(mode)/((VIDEO_SCANMODE_480I == mode.scanmode) ? 2 : 1))/lines;
+	for (int bank = 0; bank < BANKS; bank++)
+	{
+		double cpu = (double)result.cpu_slots[bank]/result.slots*dot_clock*2;
+		result.active_rate += cpu;
+		result.average_rate += active*cpu + (1 - active)*dot_clock*2;
+	}
+	return result;
+}
+
+static void print_table(const struct vdp2_vram_cycp *cycp, int slots)
+{
+	static const char *codes[16] = { "i0", "i1", "i2", "i3", "D0", "D1", "D2", "D3",
+									 "!!", "!!", "!!", "!!", "V0", "V1", "C", "x" };
+	printf("      ");
+	for (int t = 0; t < slots; t++)
+		printf(" T%d", t);
+	printf("\n");
+	for (int bank = 0; bank < BANKS; bank++)
+	{
+		printf("  %s :", bank_names[bank]);
+		for (int t = 0; t < slots; t++)
+			printf(" %2s", codes[slot_code(cycp, bank, t) & 0xF]);
+		printf("\n");
+	}
+}
+
+static void print_result(const char *name, const char *setup, video_screen_mode_t mode, const vdp2cyc_result_t *result)
+{
+	printf("%-7s %-5s %4dx%-3d %d  %-4s %2d %2d %2d %2d  %6.2f  %6.2f  %s\n", name, setup,
+		   get_screenmode_resolution_x(mode), get_screenmode_resolution_y(mode),
+		   result->slots, result->errors ? "FAIL" : result->warnings ? "warn" : "ok",
+		   result->cpu_slots[0], result->cpu_slots[1], result->cpu_slots[2], result->cpu_slots[3],
+		   result->active_rate/1e6, result->average_rate/1e6, scanmode_text_value(mode));
+}
+
+//---------------------------------------------- tables from the command line -----------------------------
+static int parse_table(const char *text, struct vdp2_vram_cycp *cycp)
+{
+	memset(cycp, VDP2_VRAM_CYCP_NO_ACCESS, sizeof(*cycp));
+	int bank = 0, t = 0;
+	char token[8];
+	const char *p = text;
+	while (*p)
+	{
+		if ( (*p == ' ') || (*p == '\t') )
+		{
+			p++;
+			continue;
+		}
+		if ( (*p == ';') || (*p == '/') )
+		{
+			if (++bank >= BANKS)
+				return -1;
+			t = 0;
+			p++;
+			continue;
+		}
+		int len = 0;
+		while (*p && !strchr(" \t;/", *p) && len < 7)
+			token[len++] = *p++;
+		token[len] = 0;
+		uint8_t code;
+		if ( (token[0] == 'i') && (token[1] >= '0') && (token[1] <= '3') )
+			code = VDP2_VRAM_CYCP_PNDR_NBG0 + token[1] - '0';
+		else if ( (token[0] == 'D') && (token[1] >= '0') && (token[1] <= '3') )
+			code = VDP2_VRAM_CYCP_CHPNDR_NBG0 + token[1] - '0';
+		else if (strcmp(token, "C") == 0)
+			code = VDP2_VRAM_CYCP_CPU_RW;
+		else if (strcmp(token, "x") == 0)
+			code = VDP2_VRAM_CYCP_NO_ACCESS;
+		else
+			return -1;
+		if (t >= 8)
+			return -1;
+		(&cycp->pt[bank].t0)[t++] = code;
+	}
+	return (bank == BANKS - 1) ? 0 : -1;
+}
+
+static bool parse_mode(const char *name, video_screen_mode_t *mode)
+{
+	int number;
+	if ( (sscanf(name, "ntsc%d", &number) == 1) && (number >= 0) && (number < 28) )
+		*mode = create_screenmode_by_number(VDP2_TVMD_TV_STANDARD_NTSC, number);
+	else if ( (sscanf(name, "pal%d", &number) == 1) && (number >= 0) && (number < 40) )
+		*mode = create_screenmode_by_number(VDP2_TVMD_TV_STANDARD_PAL, number);
+	else
+		return false;
+	return true;
+}
+
+static void mode_name(video_screen_mode_t mode, char *buf)
+{
+	sprintf(buf, "%s%02d", VDP2_TVMD_TV_STANDARD_NTSC == mode.colorsystem ? "ntsc" : "pal",
+			get_screenmode_number(mode));
+}
+
+//---------------------------------------------- main -----------------------------------------------------
+//returns the number of setups with errors
+static int run_mode(video_screen_mode_t mode, int only_setup, const char *table)
+{
+	static const char *setups[] = { "cell", "bmp", "draw" };
+	char name[16];
+	int failed = 0;
+	mode_name(mode, name);
+	for (int setup = 0; setup < 3; setup++)
+	{
+		if ( (only_setup >= 0) && (setup != only_setup) )
+			continue;
+		vdp2cyc_reset();
+		video_vdp2_init(mode, setup != 0);
+		if (setup == 2)
+			video_vdp2_set_cycle_patterns_cpu();
+		if (table)
+			parse_table(table, &vdp2cyc_state.cycp);
+		char label[32];
+		sprintf(label, "%s-%s", name, setups[setup]);
+		vdp2cyc_result_t result = check(&vdp2cyc_state, mode, setup != 2, label);
+		print_result(name, setups[setup], mode, &result);
+		if (verbose)
+			print_table(&vdp2cyc_state.cycp, result.slots);
+		if (result.errors)
+			failed++;
+	}
+	return failed;
+}
+
+static void usage()
+{
+	printf("vdp2cyc [-v]\n");
+	printf("vdp2cyc -m ntsc08|pal12|... [-b] [-t \"A0 slots;A1 slots;B0 slots;B1 slots\"] [-v]\n");
+}
+
+int main(int argc, char **argv)
+{
+	const char *mode_arg = NULL, *table = NULL;
+	bool bitmap = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-v") == 0)
+			verbose = true;
+		else if (strcmp(argv[i], "-b") == 0)
+			bitmap = true;
+		else if ( (strcmp(argv[i], "-m") == 0) && (i + 1 < argc) )
+			mode_arg = argv[++i];
+		else if ( (strcmp(argv[i], "-t") == 0) && (i + 1 < argc) )
+			table = argv[++i];
+		else
+		{
+			usage();
+			return 2;
+		}
+	}
+	if (table && !mode_arg)
+	{
+		usage();
+		return 2;
+	}
+
+	video_screen_mode_t mode;
+	if (mode_arg && !parse_mode(mode_arg, &mode))
+	{
+		usage();
+		return 2;
+	}
+	if (table)
+	{
+		struct vdp2_vram_cycp cycp;
+		if (parse_table(table, &cycp))
+		{
+			fprintf(stderr, "Could not parse the table \"%s\"\n", table);
+			return 2;
+		}
+	}
+
+	printf("%-7s %-5s %-8s %s  %-4s %2s %2s %2s %2s  %6s  %6s  %s\n", "mode", "setup", "res", "T",
+		   "", "A0", "A1", "B0", "B1", "active", "avg", "scan");
+	printf("%-7s %-5s %-8s %s  %-4s %-11s  %6s  %6s\n", "", "", "", " ", "", "CPU slots", "MB/s", "MB/s");
+
+	int failed = 0;
+	if (mode_arg)
+	{
+		failed = run_mode(mode, table ? (bitmap ? 1 : 0) : -1, table);
+	}
+	else
+	{
+		for (int number = 0; number < 28; number++)
+			failed += run_mode(create_screenmode_by_number(VDP2_TVMD_TV_STANDARD_NTSC, number), -1, NULL);
+		for (int number = 0; number < 40; number++)
+			failed += run_mode(create_screenmode_by_number(VDP2_TVMD_TV_STANDARD_PAL, number), -1, NULL);
+	}
+	return failed ? 1 : 0;
+}
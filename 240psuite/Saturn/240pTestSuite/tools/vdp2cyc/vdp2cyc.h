@@ -0,0 +1,30 @@
+#ifndef VDP2CYC_H
+#define VDP2CYC_H
+
+#include <yaul.h>
+#include "video.h"
+
+typedef struct {
+	bool enabled;
+	bool bitmap;
+	int ccc;
+	int reduction;
+	uintptr_t bitmap_base;
+	int bitmap_size;
+	uintptr_t plane_a;	//pattern name table, cells only
+} vdp2cyc_layer_t;
+
+//what video_vdp2.c last wrote to the VDP2 registers
+typedef struct {
+	struct vdp2_vram_cycp cycp;
+	vdp2cyc_layer_t layer[2];
+	int horz;
+	int interlace;
+	vdp2_tvmd_vert_t vert;
+} vdp2cyc_state_t;
+
+extern vdp2cyc_state_t vdp2cyc_state;
+
+void vdp2cyc_reset();
+
+#endif /* !VDP2CYC_H */
@@ -0,0 +1,96 @@
+/*
+ * 240p Test Suite for the Sega Saturn
+ * Register capture for the VDP2 cycle pattern model
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#include "vdp2cyc.h"
+#include "font.h"
+
+uint8_t patref_vdp2_memory[PATREF_VDP2_VRAM_GUARD + PATREF_VDP2_VRAM_SIZE + PATREF_VDP2_VRAM_GUARD];
+uint8_t vdp2cyc_cram[0x1000];
+vdp2cyc_state_t vdp2cyc_state;
+
+int _fh = 9;
+int _fw = 6;
+
+void vdp2cyc_reset()
+{
+	memset(&vdp2cyc_state, 0x00, sizeof(vdp2cyc_state));
+	memset(&vdp2cyc_state.cycp, VDP2_VRAM_CYCP_NO_ACCESS, sizeof(vdp2cyc_state.cycp));
+}
+
+//---------------------------------------------- VDP2 ----------------------------------------------------
+void vdp2_vram_cycp_set(const struct vdp2_vram_cycp *cycp)
+{
+	vdp2cyc_state.cycp = *cycp;
+}
+
+void vdp2_scrn_bitmap_format_set(const struct vdp2_scrn_bitmap_format *format)
+{
+	vdp2cyc_layer_t *layer = &vdp2cyc_state.layer[format->scroll_screen];
+	layer->bitmap = true;
+	layer->ccc = format->ccc;
+	layer->bitmap_base = format->bitmap_base;
+	layer->bitmap_size = format->bitmap_size;
+}
+
+void vdp2_scrn_cell_format_set(const struct vdp2_scrn_cell_format *format, const vdp2_scrn_normal_map_t *map)
+{
+	vdp2cyc_layer_t *layer = &vdp2cyc_state.layer[format->scroll_screen];
+	layer->bitmap = false;
+	layer->ccc = format->ccc;
+	layer->plane_a = map->plane_a;
+}
+
+void vdp2_scrn_display_set(uint32_t disp)
+{
+	vdp2cyc_state.layer[0].enabled = (disp & VDP2_SCRN_DISP_NBG0) ? true : false;
+	vdp2cyc_state.layer[1].enabled = (disp & VDP2_SCRN_DISP_NBG1) ? true : false;
+}
+
+void vdp2_scrn_reduction_set(int screen, int reduction)
+{
+	vdp2cyc_state.layer[screen].reduction = reduction;
+}
+
+void vdp2_tvmd_display_res_set(int interlace, int horz, vdp2_tvmd_vert_t vert)
+{
+	vdp2cyc_state.interlace = interlace;
+	vdp2cyc_state.horz = horz;
+	vdp2cyc_state.vert = vert;
+}
+
+void vdp2_scrn_reduction_x_set(int screen, int32_t scale) {}
+void vdp2_scrn_reduction_y_set(int screen, int32_t scale) {}
+void vdp2_scrn_scroll_x_set(int screen, int32_t scroll) {}
+void vdp2_scrn_priority_set(int screen, int priority) {}
+void vdp2_scrn_back_color_set(uintptr_t addr, rgb1555_t color) {}
+void vdp2_sprite_priority_set(int number, int priority) {}
+void vdp2_tvmd_display_set(void) {}
+void vdp2_tvmd_display_clear(void) {}
+void vdp2_cram_mode_set(int mode) {}
+void vdp2_sync(void) {}
+
+//---------------------------------------------- the rest of the suite -----------------------------------
+void video_vdp1_init(video_screen_mode_t screen_mode) {}
+void video_vdp1_deinit() {}
+void smpc_peripheral_init(void) {}
+void SetFontPalette() {}
+void ClearText(int left, int top, int width, int height) {}
+void DrawStringWithBackground(char *str, unsigned int x, unsigned int y, unsigned int palette, unsigned int bg_palette) {}
@@ -0,0 +1,137 @@
+/*
+ * 240p Test Suite for the Sega Saturn
+ * Host stand-in for the VDP2 parts of <yaul.h> used by video_vdp2.c
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#ifndef VDP2CYC_YAUL_H
+#define VDP2CYC_YAUL_H
+
+//VRAM, base types and input come from the pattern renderer's stand-in
+#include "../patref/yaul.h"
+
+extern uint8_t vdp2cyc_cram[0x1000];
+#define VDP2_CRAM_ADDR(offset)	((uintptr_t)&vdp2cyc_cram[(offset)])
+
+#define FIX16(x)	((int32_t)((x) * 65536.0f))
+
+typedef uint16_t rgb1555_t;
+#define RGB1555(msb, r, g, b)	((rgb1555_t)(((msb) << 15) | ((b) << 10) | ((g) << 5) | (r)))
+
+//access codes, as written to the CYCA0L..CYCB1U registers
+#define VDP2_VRAM_CYCP_PNDR_NBG0	0x0
+#define VDP2_VRAM_CYCP_PNDR_NBG1	0x1
+#define VDP2_VRAM_CYCP_PNDR_NBG2	0x2
+#define VDP2_VRAM_CYCP_PNDR_NBG3	0x3
+#define VDP2_VRAM_CYCP_CHPNDR_NBG0	0x4
+#define VDP2_VRAM_CYCP_CHPNDR_NBG1	0x5
+#define VDP2_VRAM_CYCP_CHPNDR_NBG2	0x6
+#define VDP2_VRAM_CYCP_CHPNDR_NBG3	0x7
+#define VDP2_VRAM_CYCP_VCSTDR_NBG0	0xC
+#define VDP2_VRAM_CYCP_VCSTDR_NBG1	0xD
+#define VDP2_VRAM_CYCP_CPU_RW		0xE
+#define VDP2_VRAM_CYCP_NO_ACCESS	0xF
+
+struct vdp2_vram_cycp_bank {
+	uint8_t t0, t1, t2, t3, t4, t5, t6, t7;
+};
+
+struct vdp2_vram_cycp {
+	struct vdp2_vram_cycp_bank pt[4];
+};
+
+#define VDP2_SCRN_NBG0	0
+#define VDP2_SCRN_NBG1	1
+
+#define VDP2_SCRN_DISP_NBG0	0x0001
+#define VDP2_SCRN_DISP_NBG1	0x0002
+#define VDP2_SCRN_DISPTP_NBG0	0x0101
+#define VDP2_SCRN_DISPTP_NBG1	0x0202
+
+#define VDP2_SCRN_CCC_PALETTE_16	0
+#define VDP2_SCRN_CCC_PALETTE_256	1
+#define VDP2_SCRN_CCC_PALETTE_2048	2
+#define VDP2_SCRN_CCC_RGB_32768		3
+#define VDP2_SCRN_CCC_RGB_16770000	4
+
+#define VDP2_SCRN_CHAR_SIZE_1X1	1
+#define VDP2_SCRN_AUX_MODE_1	1
+#define VDP2_SCRN_PLANE_SIZE_2X1	1
+#define VDP2_SCRN_BITMAP_SIZE_1024X512	3
+
+#define VDP2_SCRN_REDUCTION_NONE	0
+#define VDP2_SCRN_REDUCTION_HALF	1
+#define VDP2_SCRN_REDUCTION_QUARTER	2
+
+typedef int vdp2_tvmd_interlace_t;
+typedef int vdp2_tvmd_horz_t;
+
+#define VDP2_TVMD_INTERLACE_NONE	0
+#define VDP2_TVMD_INTERLACE_SINGLE	2
+#define VDP2_TVMD_INTERLACE_DOUBLE	3
+
+#define VDP2_TVMD_HORZ_NORMAL_A		0
+#define VDP2_TVMD_HORZ_NORMAL_B		1
+#define VDP2_TVMD_HORZ_HIRESO_A		2
+#define VDP2_TVMD_HORZ_HIRESO_B		3
+#define VDP2_TVMD_HORZ_NORMAL_AE	4
+#define VDP2_TVMD_HORZ_NORMAL_BE	5
+#define VDP2_TVMD_HORZ_HIRESO_AE	6
+#define VDP2_TVMD_HORZ_HIRESO_BE	7
+
+struct vdp2_scrn_bitmap_format {
+	int scroll_screen;
+	int ccc;
+	int bitmap_size;
+	uint32_t palette_base;
+	uintptr_t bitmap_base;
+};
+
+struct vdp2_scrn_cell_format {
+	int scroll_screen;
+	int ccc;
+	int char_size;
+	int pnd_size;
+	int aux_mode;
+	uintptr_t cpd_base;
+	uint32_t palette_base;
+	int plane_size;
+};
+
+typedef struct {
+	uintptr_t plane_a, plane_b, plane_c, plane_d;
+} vdp2_scrn_normal_map_t;
+
+void vdp2_vram_cycp_set(const struct vdp2_vram_cycp *cycp);
+void vdp2_scrn_bitmap_format_set(const struct vdp2_scrn_bitmap_format *format);
+void vdp2_scrn_cell_format_set(const struct vdp2_scrn_cell_format *format, const vdp2_scrn_normal_map_t *map);
+void vdp2_scrn_display_set(uint32_t disp);
+void vdp2_scrn_reduction_set(int screen, int reduction);
+void vdp2_scrn_reduction_x_set(int screen, int32_t scale);
+void vdp2_scrn_reduction_y_set(int screen, int32_t scale);
+void vdp2_scrn_scroll_x_set(int screen, int32_t scroll);
+void vdp2_scrn_priority_set(int screen, int priority);
+void vdp2_scrn_back_color_set(uintptr_t addr, rgb1555_t color);
+void vdp2_sprite_priority_set(int number, int priority);
+void vdp2_tvmd_display_res_set(int interlace, int horz, vdp2_tvmd_vert_t vert);
+void vdp2_tvmd_display_set(void);
+void vdp2_tvmd_display_clear(void);
+void vdp2_cram_mode_set(int mode);
+void vdp2_sync(void);
+
+#endif /* !VDP2CYC_YAUL_H */
@@ -168,7 +168,7 @@ double get_screen_square_pixel_ratio(video_screen_mode_t screenmode)
 {	
 	//calculating X:Y ratio for the corresponding pixel mode
 	
-	double ratio;
+	double ratio = 1.0;
 	switch (screenmode.colorsystem)
 	{
 		case VDP2_TVMD_TV_STANDARD_NTSC:
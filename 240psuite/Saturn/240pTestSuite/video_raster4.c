@@ -0,0 +1,247 @@
+#include <yaul.h>
+#include <stdlib.h>
+#include "video.h"
+#include "video_vdp2.h"
+#include "video_raster4.h"
+#include "background_codec.h"
+
+static uint8_t *_raster4_buffer = NULL;
+static uint8_t *_raster4_target = NULL; //either the work RAM buffer or NBG0 VRAM
+static int _raster4_lines = 0;
+static bool _raster4_special = false;
+
+typedef struct {
+    int id;             //VIDEO_RASTER4_CACHE_NONE for a free slot
+    int mode;           //colorsystem and screen mode number
+    int lines;
+    unsigned int used;  //LRU stamp
+    size_t size;
+    uint8_t *data;
+} raster4_cache_entry_t;
+
+static raster4_cache_entry_t _raster4_cache[VIDEO_RASTER4_CACHE_ENTRIES];
+static size_t _raster4_cache_total = 0;
+static unsigned int _raster4_cache_clock = 0;
+static raster4_cache_entry_t _raster4_pending; //what video_raster4_end() should store
+
+static void raster4_setup(video_screen_mode_t screen_mode)
+{
+    _raster4_pending.id = VIDEO_RASTER4_CACHE_NONE;
+    _raster4_special = is_screenmode_special(screen_mode);
+    _raster4_lines = get_screenmode_resolution_y(screen_mode);
+    if (_raster4_lines > VIDEO_RASTER4_MAX_LINES)
+        _raster4_lines = VIDEO_RASTER4_MAX_LINES;
+
+    //only the visible lines are buffered, if there is no room for them
+    //we fall back to drawing straight into NBG0
+    _raster4_buffer = (uint8_t *)malloc(_raster4_lines*VIDEO_RASTER4_PITCH);
+    if (_raster4_buffer)
+        _raster4_target = _raster4_buffer;
+    else
+        _raster4_target = (uint8_t *)(_raster4_special ? VIDEO_VDP2_NBG0_SPECIAL_BMP_START : VIDEO_VDP2_NBG0_CHPNDR_START);
+}
+
+void video_raster4_begin(video_screen_mode_t screen_mode, int color)
+{
+    raster4_setup(screen_mode);
+    memset(_raster4_target, 0x11*color, _raster4_lines*VIDEO_RASTER4_PITCH);
+}
+
+//---------------------------------------------- Cache ----------------------------------------------------
+static int raster4_mode_key(video_screen_mode_t screen_mode)
+{
+    return screen_mode.colorsystem*64 + get_screenmode_number(screen_mode);
+}
+
+static void raster4_cache_drop(raster4_cache_entry_t *entry)
+{
+    free(entry->data);
+    _raster4_cache_total -= entry->size;
+    memset(entry, 0x00, sizeof(raster4_cache_entry_t));
+}
+
+static raster4_cache_entry_t *raster4_cache_find(int id, int mode)
+{
+    for (int i = 0; i < VIDEO_RASTER4_CACHE_ENTRIES; i++)
+        if ( (_raster4_cache[i].id == id) && (_raster4_cache[i].mode == mode) )
+            return &_raster4_cache[i];
+    return NULL;
+}
+
+static raster4_cache_entry_t *raster4_cache_lru()
+{
+    raster4_cache_entry_t *oldest = NULL;
+    for (int i = 0; i < VIDEO_RASTER4_CACHE_ENTRIES; i++)
+    {
+        if (VIDEO_RASTER4_CACHE_NONE == _raster4_cache[i].id)
+            continue;
+        if ( (NULL == oldest) || (_raster4_cache[i].used < oldest->used) )
+            oldest = &_raster4_cache[i];
+    }
+    return oldest;
+}
+
+static void raster4_cache_store()
+{
+    const size_t raw_size = _raster4_lines*VIDEO_RASTER4_PITCH;
+    size_t size = background_codec_rle_encode(_raster4_target, raw_size, NULL, 0);
+    raster4_cache_entry_t *slot = NULL;
+
+    if (size > VIDEO_RASTER4_CACHE_BUDGET)
+        return;
+
+    //make room, oldest first
+    while (_raster4_cache_total + size > VIDEO_RASTER4_CACHE_BUDGET)
+        raster4_cache_drop(raster4_cache_lru());
+    for (int i = 0; (i < VIDEO_RASTER4_CACHE_ENTRIES) && (NULL == slot); i++)
+        if (VIDEO_RASTER4_CACHE_NONE == _raster4_cache[i].id)
+            slot = &_raster4_cache[i];
+    if (NULL == slot)
+    {
+        slot = raster4_cache_lru();
+        raster4_cache_drop(slot);
+    }
+
+    slot->data = (uint8_t *)malloc(size);
+    if (NULL == slot->data)
+        return;
+    background_codec_rle_encode(_raster4_target, raw_size, slot->data, 0);
+    slot->id = _raster4_pending.id;
+    slot->mode = _raster4_pending.mode;
+    slot->lines = _raster4_lines;
+    slot->size = size;
+    slot->used = ++_raster4_cache_clock;
+    _raster4_cache_total += size;
+}
+
+bool video_raster4_begin_cached(video_screen_mode_t screen_mode, int color, int cache_id)
+{
+    const int mode = raster4_mode_key(screen_mode);
+    raster4_cache_entry_t *entry = raster4_cache_find(cache_id, mode);
+
+    raster4_setup(screen_mode);
+    if ( (entry) && (entry->lines == _raster4_lines) )
+    {
+        background_codec_decode(BACKGROUND_CODEC_RLE, entry->data, entry->size, _raster4_target, 0);
+        entry->used = ++_raster4_cache_clock;
+        return true;
+    }
+
+    //a miss, keep the result once it is drawn
+    memset(_raster4_target, 0x11*color, _raster4_lines*VIDEO_RASTER4_PITCH);
+    _raster4_pending.id = cache_id;
+    _raster4_pending.mode = mode;
+    return false;
+}
+
+void video_raster4_cache_flush()
+{
+    for (int i = 0; i < VIDEO_RASTER4_CACHE_ENTRIES; i++)
+        if (VIDEO_RASTER4_CACHE_NONE != _raster4_cache[i].id)
+            raster4_cache_drop(&_raster4_cache[i]);
+}
+
+//---------------------------------------------- Drawing ----------------------------------------------------
+void video_raster4_end()
+{
+    const size_t size = _raster4_lines*VIDEO_RASTER4_PITCH;
+
+    if (VIDEO_RASTER4_CACHE_NONE != _raster4_pending.id)
+    {
+        raster4_cache_store();
+        _raster4_pending.id = VIDEO_RASTER4_CACHE_NONE;
+    }
+
+    if (_raster4_buffer)
+    {
+        if (_raster4_special)
+        {
+            scu_dma_transfer(0, (void *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START, _raster4_buffer, size);
+            scu_dma_transfer_wait(0);
+            scu_dma_transfer(0, (void *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START, _raster4_buffer, size);
+        }
+        else
+        {
+            scu_dma_transfer(0, (void *)VIDEO_VDP2_NBG0_CHPNDR_START, _raster4_buffer, size);
+        }
+        scu_dma_transfer_wait(0);
+        free(_raster4_buffer);
+        _raster4_buffer = NULL;
+    }
+    else if (_raster4_special)
+    {
+        //drawn in place on NBG0, NBG1 gets a copy
+        memcpy((void *)VIDEO_VDP2_NBG1_SPECIAL_BMP_START, (void *)VIDEO_VDP2_NBG0_SPECIAL_BMP_START, size);
+    }
+    _raster4_target = NULL;
+}
+
+static inline bool raster4_clip(int *x1, int *x2, int y)
+{
+    if ( (y < 0) || (y >= _raster4_lines) )
+        return false;
+    if (*x1 < 0) *x1 = 0;
+    if (*x2 > VIDEO_RASTER4_PITCH*2-1) *x2 = VIDEO_RASTER4_PITCH*2-1;
+    return (*x1 <= *x2);
+}
+
+static inline void raster4_nibble(uint8_t *line, int x, int color, bool bOr)
+{
+    //even pixels are in the high nibble
+    uint8_t mask = (x%2) ? 0x0F : 0xF0;
+    uint8_t value = (x%2) ? color : color<<4;
+    if (bOr)
+        line[x/2] |= value;
+    else
+        line[x/2] = (line[x/2] & ~mask) | value;
+}
+
+static void raster4_span(int x1, int x2, int y, int color, bool bOr)
+{
+    if (false == raster4_clip(&x1,&x2,y))
+        return;
+    uint8_t *line = &_raster4_target[y*VIDEO_RASTER4_PITCH];
+
+    //edge nibbles
+    if (x1%2)
+        raster4_nibble(line, x1++, color, bOr);
+    if ( (x2%2 == 0) && (x2 >= x1) )
+        raster4_nibble(line, x2--, color, bOr);
+    if (x1 > x2)
+        return;
+
+    //whole bytes x1/2..x2/2, words for the aligned middle part
+    const uint8_t value8 = 0x11*color;
+    const uint32_t value32 = 0x11111111u*(uint32_t)color;
+    int b = x1/2;
+    int b_end = x2/2 + 1;
+    for (; (b < b_end) && (b%4); b++)
+        line[b] = bOr ? (line[b] | value8) : value8;
+    uint32_t *line32 = (uint32_t *)&line[b];
+    for (; b_end - b >= 4; b += 4, line32++)
+        VIDEO_VDP2_WRITE32(line32, bOr ? (VIDEO_VDP2_READ32(line32) | value32) : value32);
+    for (; b < b_end; b++)
+        line[b] = bOr ? (line[b] | value8) : value8;
+}
+
+void video_raster4_set_pixel(int x, int y, int color)
+{
+    if ( (x >= 0) && (x < VIDEO_RASTER4_PITCH*2) && (y >= 0) && (y < _raster4_lines) )
+        raster4_nibble(&_raster4_target[y*VIDEO_RASTER4_PITCH], x, color, false);
+}
+
+void video_raster4_or_pixel(int x, int y, int color)
+{
+    if ( (x >= 0) && (x < VIDEO_RASTER4_PITCH*2) && (y >= 0) && (y < _raster4_lines) )
+        raster4_nibble(&_raster4_target[y*VIDEO_RASTER4_PITCH], x, color, true);
+}
+
+void video_raster4_set_span(int x1, int x2, int y, int color)
+{
+    raster4_span(x1, x2, y, color, false);
+}
+
+void video_raster4_or_span(int x1, int x2, int y, int color)
+{
+    raster4_span(x1, x2, y, color, true);
+}
@@ -0,0 +1,35 @@
+#ifndef VIDEO_RASTER4_H
+#define VIDEO_RASTER4_H
+
+#include "video.h"
+
+//4bpp 1024x512 bitmap layout used by NBG0/NBG1 in bmp mode
+#define VIDEO_RASTER4_PITCH 512
+#define VIDEO_RASTER4_MAX_LINES 512
+
+// Patterns are drawn into a work RAM copy of the bitmap and sent to VRAM
+// once at the end, to NBG0 and for special modes also to NBG1. Spans are
+// written a word at a time, only the edge nibbles are handled separately.
+void video_raster4_begin(video_screen_mode_t screen_mode, int color);
+void video_raster4_end();
+
+// Finished bitmaps can be kept PackBits-compressed in work RAM, keyed by
+// pattern and screen mode. Past the budget the least recently used ones
+// are dropped. When begin_cached() returns true the bitmap has been
+// restored and the caller goes straight to video_raster4_end().
+#define VIDEO_RASTER4_CACHE_ENTRIES 16
+#define VIDEO_RASTER4_CACHE_BUDGET (128*1024)
+
+#define VIDEO_RASTER4_CACHE_NONE 0
+#define VIDEO_RASTER4_CACHE_MONOSCOPE 1
+#define VIDEO_RASTER4_CACHE_SHARPNESS 2
+
+bool video_raster4_begin_cached(video_screen_mode_t screen_mode, int color, int cache_id);
+void video_raster4_cache_flush();
+
+void video_raster4_set_pixel(int x, int y, int color);
+void video_raster4_or_pixel(int x, int y, int color);
+void video_raster4_set_span(int x1, int x2, int y, int color);
+void video_raster4_or_span(int x1, int x2, int y, int color);
+
+#endif /* !VIDEO_RASTER4_H */
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <yaul.h>
+#include "video_scroll.h"
+
+//SCU DMA level 2 registers. Level 0 is left to scu_dma_transfer() users
+#define VIDEO_SCROLL_DMA_BASE 0x25FE0040UL
+#define VIDEO_SCROLL_DMA_R (0x00/4)
+#define VIDEO_SCROLL_DMA_W (0x04/4)
+#define VIDEO_SCROLL_DMA_C (0x08/4)
+#define VIDEO_SCROLL_DMA_AD (0x0C/4)
+#define VIDEO_SCROLL_DMA_EN (0x10/4)
+#define VIDEO_SCROLL_DMA_MD (0x14/4)
+
+//read +4, write +2 (the B-bus side is 16 bits wide)
+#define VIDEO_SCROLL_DMA_AD_VALUE 0x00000101
+//enable, no CPU start
+#define VIDEO_SCROLL_DMA_EN_VALUE 0x00000100
+//direct mode, read address kept after each transfer, started by vblank-in
+#define VIDEO_SCROLL_DMA_MD_VALUE 0x00010000
+
+typedef struct {
+    uint16_t integer;   //SCxINn
+    uint16_t fraction;  //SCxDNn
+} video_scroll_entry_t;
+
+static video_scroll_entry_t _scroll_table[VIDEO_SCROLL_TABLE_MAX] __aligned(4);
+static volatile bool _scroll_running = false;
+static volatile bool _scroll_skip_vblank_out = false;
+static volatile int _scroll_done = 0;
+static int _scroll_period = 0;
+
+static int scroll_gcd(int a, int b)
+{
+    while (b)
+    {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static void scroll_dma_rewind()
+{
+    volatile uint32_t *dma = (volatile uint32_t *)VIDEO_SCROLL_DMA_BASE;
+    dma[VIDEO_SCROLL_DMA_R] = (uintptr_t)_scroll_table;
+}
+
+int video_scroll_table_start(uintptr_t reg, int start, int step, int wrap)
+{
+    volatile uint32_t *dma = (volatile uint32_t *)VIDEO_SCROLL_DMA_BASE;
+
+    video_scroll_table_stop();
+
+    //the smallest number of frames after which the motion repeats exactly
+    step = ((step % wrap) + wrap) % wrap;
+    _scroll_period = step ? wrap / scroll_gcd(step, wrap) : 1;
+    assert(_scroll_period <= VIDEO_SCROLL_TABLE_MAX);
+
+    int position = ((start % wrap) + wrap) % wrap;
+    for (int i = 0; i < _scroll_period; i++)
+    {
+        _scroll_table[i].integer = position;
+        _scroll_table[i].fraction = 0;
+        position = (position + step) % wrap;
+    }
+
+    //started inside vblank, the coming vblank-out has no transfer before it
+    _scroll_skip_vblank_out = vdp2_tvmd_vblank_in();
+    _scroll_done = 0;
+
+    dma[VIDEO_SCROLL_DMA_R] = (uintptr_t)_scroll_table;
+    dma[VIDEO_SCROLL_DMA_W] = (uint32_t)reg;
+    dma[VIDEO_SCROLL_DMA_C] = sizeof(video_scroll_entry_t);
+    dma[VIDEO_SCROLL_DMA_AD] = VIDEO_SCROLL_DMA_AD_VALUE;
+    dma[VIDEO_SCROLL_DMA_MD] = VIDEO_SCROLL_DMA_MD_VALUE;
+    _scroll_running = true;
+    dma[VIDEO_SCROLL_DMA_EN] = VIDEO_SCROLL_DMA_EN_VALUE;
+
+    return _scroll_period;
+}
+
+void video_scroll_table_stop()
+{
+    volatile uint32_t *dma = (volatile uint32_t *)VIDEO_SCROLL_DMA_BASE;
+    dma[VIDEO_SCROLL_DMA_EN] = 0;
+    _scroll_running = false;
+}
+
+bool video_scroll_table_running()
+{
+    return _scroll_running;
+}
+
+int video_scroll_table_position()
+{
+    int last = (_scroll_done + _scroll_period - 1) % _scroll_period;
+    return _scroll_table[last].integer;
+}
+
+void video_scroll_table_vblank_out()
+{
+    if (!_scroll_running)
+        return;
+    if (_scroll_skip_vblank_out)
+    {
+        _scroll_skip_vblank_out = false;
+        return;
+    }
+    //one transfer happened at the vblank-in before this vblank-out
+    if (++_scroll_done >= _scroll_period)
+    {
+        _scroll_done = 0;
+        scroll_dma_rewind();
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef VIDEO_SCROLL_H
+#define VIDEO_SCROLL_H
+
+// Hardware-timed scrolling. The scroll positions of a whole motion period
+// are computed up front, one SCxINn/SCxDNn pair per frame, and SCU DMA
+// level 2 writes the next pair into the VDP2 scroll registers at every
+// vblank-in, stepping through the table by itself. The only CPU work left
+// is rewinding the DMA once per period, from the vblank-out interrupt.
+#define VIDEO_SCROLL_TABLE_MAX 1024
+
+// reg is a VDP2 scroll register, e.g. VDP2_IOREG_BASE+SCXIN0. Positions
+// run start, start+step, ... modulo wrap. Returns the period in frames.
+int video_scroll_table_start(uintptr_t reg, int start, int step, int wrap);
+void video_scroll_table_stop();
+bool video_scroll_table_running();
+
+// position the table wrote last, to carry on from it
+int video_scroll_table_position();
+
+// called from the vblank-out handler
+void video_scroll_table_vblank_out();
+
+#endif /* !VIDEO_SCROLL_H */
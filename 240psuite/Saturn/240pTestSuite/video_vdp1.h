@@ -11,5 +11,6 @@
 #define VIDEO_VDP1_ORDER_LIMIT                    4
 
 void video_vdp1_init(video_screen_mode_t screen_mode);
+void video_vdp1_deinit();
 
 #endif /* !VIDEO_VDP1_H */
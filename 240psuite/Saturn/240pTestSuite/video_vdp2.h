@@ -8,6 +8,14 @@
 #define VIDEO_VDP2_CHARACTER_BYTES   (VIDEO_VDP2_CHARACTER_HEIGHT*VIDEO_VDP2_CHARACTER_WIDTH)
 #define VIDEO_VDP2_CHARACTER_UNITS   (VIDEO_VDP2_CHARACTER_BYTES/32)
 
+//VRAM is big-endian. Whole words are stored and read through these so
+//the host reference renderer (tools/patref) can keep that byte order,
+//on the Saturn they are plain accesses
+#ifndef VIDEO_VDP2_WRITE32
+#define VIDEO_VDP2_WRITE32(ptr, value)   (*(ptr) = (value))
+#define VIDEO_VDP2_READ32(ptr)   (*(ptr))
+#endif
+
 //using VDP2 VRAM static allocation with everything contingent
 
 //i(T0) -> 0,1,2
@@ -90,6 +98,7 @@ void video_vdp2_set_cycle_patterns_cpu();
 void video_vdp2_set_cycle_patterns_nbg(video_screen_mode_t screen_mode);
 void video_vdp2_set_cycle_patterns_nbg_bmp(video_screen_mode_t screen_mode);
 void video_vdp2_init(video_screen_mode_t screen_mode, bool bmp_mode);
+void video_vdp2_deinit();
 
 void video_vdp2_set_palette_part(int number, rgb888_t * pointer, int start, int end);
 void video_vdp2_clear_palette(int number);
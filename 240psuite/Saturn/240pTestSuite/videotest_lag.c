@@ -8,6 +8,7 @@
 #include "control.h"
 #include "ire.h"
 #include "image_big_digits.h"
+#include "profile.h"
 
 void update_lag(video_screen_mode_t screenmode, int frame)
 {
@@ -265,6 +266,7 @@ void videotest_lag(video_screen_mode_t screenmode)
 		{
 			//quit the pattern
 			wait_for_key_unpress();
+			PROFILE_DUMP();
 			update_screen_mode(screenmode,false);
 			return;
 		}
@@ -272,9 +274,12 @@ void videotest_lag(video_screen_mode_t screenmode)
 			key_pressed = false;
 		vdp2_tvmd_vblank_out_wait();
 		vdp2_tvmd_vblank_in_wait();
+		PROFILE_FRAME();
 		if (running)
 		{
+			PROFILE_BEGIN(PROFILE_SECTION_LAG);
 			update_lag(screenmode,mode_run_counter);
+			PROFILE_END(PROFILE_SECTION_LAG);
 		}
 		mode_run_counter++;
 	}
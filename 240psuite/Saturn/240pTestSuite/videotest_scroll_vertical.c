@@ -7,49 +7,32 @@
 #include "video.h"
 #include "control.h"
 #include "ire.h"
+#include "background.h"
+#include "profile.h"
+#include "video_scroll.h"
 
 extern uint8_t asset_kiki_bg[];
 extern uint8_t asset_kiki_bg_end[];
 
 void update_scroll_vertical(video_screen_mode_t screenmode, int frame, int offset)
 {
-	//shift background1
+	//shift background1, unless the scroll table does it
 	//vdp2_scrn_scroll_x_set(VDP2_SCRN_NBG0,fix16_int32_from(offset1));
-	uint16_t * p16 = (uint16_t *)(VDP2_IOREG_BASE+SCYIN0);
-	p16[0] = offset;
+	if (!video_scroll_table_running())
+	{
+		uint16_t * p16 = (uint16_t *)(VDP2_IOREG_BASE+SCYIN0);
+		p16[0] = offset;
+	}
 	//vdp2_sync();
 }
 
 void draw_scroll_vertical(video_screen_mode_t screenmode)
 {
-	char buf[256*256];	
 	video_vdp2_set_cycle_patterns_cpu();
 
-	uint8_t *p8 = (uint8_t *)(asset_kiki_bg);
-	uint16_t *p16 = (uint16_t*)p8;
-	uint16_t size_x = p16[2];
-	uint16_t size_y = p16[3];
-	//if ( (p8[2048] == 'L') && (p8[2048+1] == 'Z') && (p8[2048+2] == '7') && (p8[2048+3] == '7') )
-	{
-		//compressed, decompressing
-		//getting size
-		int * p32 = (int *)(&p8[2048]);
-		int compressed_size = p32[1];
-		assert(compressed_size > 0);
-		assert(compressed_size < 0x1000000);
-		int compressed_size_sectors = ((compressed_size-1)/2048)+1;
-		//decompress
-		bcl_lz_decompress(&(p8[2048+8]),(char*)VIDEO_VDP2_NBG0_CHPNDR_START,compressed_size);
-		//palette in file is 24-bit, setting it color-by-color
-		rgb888_t _color  = {0,0,0,0};
-		for (int i = 0; i<256; i++)
-		{
-			_color.r = p8[2048*compressed_size_sectors+2048+i*3+0];
-			_color.g = p8[2048*compressed_size_sectors+2048+i*3+1];
-			_color.b = p8[2048*compressed_size_sectors+2048+i*3+2];
-			video_vdp2_set_palette_part(2, &_color, i, i);
-		}
-	}
+	//image goes to NBG0, using palette 2
+	background_asset_decompress(asset_kiki_bg,(void*)VIDEO_VDP2_NBG0_CHPNDR_START,0);
+	background_asset_set_palette(asset_kiki_bg,2,0,256);
 
 	video_vdp2_set_cycle_patterns_nbg(screenmode);
 }
@@ -98,6 +81,8 @@ void videotest_scroll_vertical(video_screen_mode_t screenmode)
 				key_pressed = true;
 				speed++;
 				if (speed > 10) speed=10;
+				if (video_scroll_table_running())
+					video_scroll_table_start(VDP2_IOREG_BASE+SCYIN0, video_scroll_table_position()-speed, -speed, 512);
 			}
 		}
 		else if ( (controller.pressed.button.down) )
@@ -107,12 +92,36 @@ void videotest_scroll_vertical(video_screen_mode_t screenmode)
 				key_pressed = true;
 				speed--;
 				if (speed < 1) speed=1;
+				if (video_scroll_table_running())
+					video_scroll_table_start(VDP2_IOREG_BASE+SCYIN0, video_scroll_table_position()-speed, -speed, 512);
+			}
+		}
+		else if ( (controller.pressed.button.a) || (controller.pressed.button.c) )
+		{
+			//switch between CPU and hardware-timed scrolling
+			if (false == key_pressed)
+			{
+				key_pressed = true;
+				if (video_scroll_table_running())
+				{
+					offset = video_scroll_table_position();
+					video_scroll_table_stop();
+					DrawStringWithBackground("CPU scroll", 20, 20, FONT_WHITE, FONT_BLUE);
+				}
+				else
+				{
+					video_scroll_table_start(VDP2_IOREG_BASE+SCYIN0, offset-speed, -speed, 512);
+					DrawStringWithBackground("Scroll table", 20, 20, FONT_WHITE, FONT_BLUE);
+				}
+				mode_display_counter = 60;
 			}
 		}
 		else if ( (controller.pressed.button.b) )
 		{
 			//quit the pattern
 			wait_for_key_unpress();
+			video_scroll_table_stop();
+			PROFILE_DUMP();
 			update_screen_mode(screenmode,false);
 			return;
 		}
@@ -121,6 +130,7 @@ void videotest_scroll_vertical(video_screen_mode_t screenmode)
 
 		vdp2_tvmd_vblank_out_wait();
 		vdp2_tvmd_vblank_in_wait();
+		PROFILE_FRAME();
 		if (mode_display_counter > 0)
 		{
 			mode_display_counter--;
@@ -132,6 +142,8 @@ void videotest_scroll_vertical(video_screen_mode_t screenmode)
 		frame_counter++;
 		offset-=speed;
 		offset %= 512;
+		PROFILE_BEGIN(PROFILE_SECTION_SCROLL_VERTICAL);
 		update_scroll_vertical(screenmode,frame_counter,offset);
+		PROFILE_END(PROFILE_SECTION_SCROLL_VERTICAL);
 	}
 }
\ No newline at end of file
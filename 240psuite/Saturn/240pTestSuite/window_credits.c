@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
 #include <yaul.h>
 #include "font.h"
@@ -69,11 +70,7 @@ void window_credits(video_screen_mode_t screenmode)
     vdp1_vram_partitions_get(&vdp1_vram_partitions);
 	
 	//ClearTextLayer();
-	uint8_t * p8_vram = (uint8_t *)(vdp1_vram_partitions.texture_base);
-	for (int _x = 0; _x < 320*256*4 ; _x++)
-	{
-		p8_vram[_x] = 0;
-	}
+	memset((void *)(vdp1_vram_partitions.texture_base), 0, 320*256*4);
 
 	wait_for_key_unpress();
 	int scroll_counter = 0;
@@ -84,6 +84,16 @@ void debugdata()
 
 static u8 gp_fifo[GX_FIFO_MINSIZE] ATTRIBUTE_ALIGN(32);
 
+// Framebuffer snapshots for the menu backdrop are kept resident, so opening
+// the menu doesn't go through memalign and can be done with a single EFB copy
+typedef struct snapshot_st {
+	u8		*buffer;
+	u32		size;
+	u8		inuse;
+} snapshot;
+
+static snapshot snapshots[SNAPSHOT_SLOTS];
+
 TPLFile backsTPL;
 u8 TPL_Loaded = 0;
 u8 TextureMemoryMalloc = 0;
@@ -140,14 +150,91 @@ u8 InitGX()
 	memset(&gp_fifo, 0, sizeof(gp_fifo));
 	GX_Init(&gp_fifo, sizeof(gp_fifo));
 	
+	InitSnapshotPool();
 	return LoadTextures();
 }
 
 void EndGX()
 {
+	ReleaseSnapshotPool();
 	ReleaseTextures();
 }
 
+/***********************/
+/*   Snapshot Pool     */
+/***********************/
+
+static u8 *AllocSnapshotSlot(snapshot *slot, u32 size)
+{
+	if(slot->buffer && slot->size >= size)
+		return slot->buffer;
+		
+	// Grow only when a larger video mode needs it
+	if(slot->buffer)
+		free(slot->buffer);
+	slot->buffer = (u8 *)memalign(32, size);
+	slot->size = slot->buffer ? size : 0;
+	return slot->buffer;
+}
+
+void InitSnapshotPool()
+{
+	int i = 0;
+	u32 size = 0;
+	
+	// The EFB is at most 640x528, so the default format never needs to grow
+	size = GX_GetTexBufferSize(640, 528, SNAPSHOT_FORMAT, GX_FALSE, 0);
+	for(i = 0; i < SNAPSHOT_SLOTS; i++)
+	{
+		snapshots[i].inuse = 0;
+		AllocSnapshotSlot(&snapshots[i], size);
+	}
+}
+
+void ReleaseSnapshotPool()
+{
+	int i = 0;
+	
+	for(i = 0; i < SNAPSHOT_SLOTS; i++)
+	{
+		if(snapshots[i].buffer)
+			free(snapshots[i].buffer);
+		snapshots[i].buffer = NULL;
+		snapshots[i].size = 0;
+		snapshots[i].inuse = 0;
+	}
+}
+
+static u8 *GetSnapshotBuffer(u32 size)
+{
+	int i = 0;
+	
+	for(i = 0; i < SNAPSHOT_SLOTS; i++)
+	{
+		if(!snapshots[i].inuse && AllocSnapshotSlot(&snapshots[i], size))
+		{
+			snapshots[i].inuse = 1;
+			return snapshots[i].buffer;
+		}
+	}
+	return NULL;
+}
+
+static u8 ReleaseSnapshotBuffer(u8 *buffer)
+{
+	int i = 0;
+	
+	for(i = 0; i < SNAPSHOT_SLOTS; i++)
+	{
+		if(snapshots[i].buffer == buffer)
+		{
+			snapshots[i].inuse = 0;
+			return 1;
+		}
+	}
+	return 0;
+}
+
 void SetupGX()
 {
 	f32 yscale;
@@ -417,6 +504,13 @@ void MapToScreen(ImagePtr image)
 }
 
 ImagePtr CopyFrameBufferToImage()
+{
+	return CopyFrameBufferToImageFmt(SNAPSHOT_FORMAT);
+}
+
+// Formats: GX_TF_RGB565 is enough for the darkened menu backdrop, 
+// GX_TF_I8 for monochrome ones and GX_TF_RGBA8 for full precision
+ImagePtr CopyFrameBufferToImageFmt(u8 format)
 {	
 	int fbsize = 0;
 	ImagePtr image;	
@@ -425,39 +519,43 @@ ImagePtr CopyFrameBufferToImage()
 			
 	width = rmode->fbWidth;
 	height = rmode->efbHeight;
-	fbsize = GX_GetTexBufferSize(width, height, GX_TF_RGBA8, GX_FALSE, 0);
-	cfb = (u8 *)memalign(32, fbsize);
+	fbsize = GX_GetTexBufferSize(width, height, format, GX_FALSE, 0);
+	cfb = GetSnapshotBuffer(fbsize);
 	if (!cfb)
 		return NULL;
-		
-	GX_DrawDone();
-	GX_SetCopyFilter(GX_FALSE, NULL, GX_FALSE, NULL);
-	GX_SetTexCopySrc(0, 0, width, height);
-	GX_SetTexCopyDst(width, height, GX_TF_RGBA8, GX_FALSE);
-	GX_CopyTex(cfb, GX_TRUE);
-	GX_PixModeSync();	
-	DCFlushRange(cfb, fbsize);
-	
-	SetupGX();
-	
-	ActiveFB ^= 1;
-	  
-	VIDEO_Flush();
-	VIDEO_WaitVSync();
-
-	VIDEO_SetNextFramebuffer(frameBuffer[IsPAL][ActiveFB]);
 	
 	image = (ImagePtr)malloc(sizeof(struct image_st));
 	if(!image)
 	{
-		free(cfb);
+		ReleaseSnapshotBuffer(cfb);
 		fprintf(stderr, "\nCould not malloc image struct FB\n");
 		return(NULL);
 	}
 	memset(image, 0, sizeof(struct image_st));
 	
+	// GX_PixModeSync keeps the draws that sample cfb behind the EFB copy,
+	// otherwise the menu can show a stale or torn backdrop
+	GX_SetCopyFilter(GX_FALSE, NULL, GX_FALSE, NULL);
+	GX_SetTexCopySrc(0, 0, width, height);
+	GX_SetTexCopyDst(width, height, format, GX_FALSE);
+	GX_CopyTex(cfb, GX_FALSE);
+	GX_PixModeSync();
+	GX_InvalidateTexAll();
+	
+	SetupGX();
+	
+	// Present the frame we just copied, so the menu doesn't cost a frame
+	GX_CopyDisp(frameBuffer[IsPAL][ActiveFB], GX_TRUE);
+	
+	VIDEO_Flush();
+	VIDEO_WaitVSync();
+	
+	ActiveFB ^= 1;
+	VIDEO_SetNextFramebuffer(frameBuffer[IsPAL][ActiveFB]);
+	
 	image->cFB = cfb;
-	GX_InitTexObj(&image->tex, image->cFB, width, height, GX_TF_RGBA8, GX_CLAMP, GX_CLAMP, GX_FALSE);
+	image->cFBPooled = 1;
+	GX_InitTexObj(&image->tex, image->cFB, width, height, format, GX_CLAMP, GX_CLAMP, GX_FALSE);
 	GX_InitTexObjFilterMode(&image->tex, GX_NEAR, GX_NEAR);
 
 	image->r = 0xff;
@@ -498,7 +596,8 @@ void FreeImage(ImagePtr *image)
 	{
 		if((*image)->cFB)
 		{
-			free((*image)->cFB);
+			if(!(*image)->cFBPooled || !ReleaseSnapshotBuffer((*image)->cFB))
+				free((*image)->cFB);
 			(*image)->cFB = NULL;
 		}
 		if((*image)->memCpyTexture)
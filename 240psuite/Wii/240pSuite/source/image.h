@@ -67,6 +67,7 @@ struct image_st{
 		u8		IgnoreOffsetY;
 
 		u8			*cFB;
+		u8			cFBPooled;
 		u8			*memCpyTexture;
 };
 
@@ -82,6 +83,16 @@ void EndScene();
 void EndSceneScreenShot();
 void EndGX();
 
+/************************/
+/*    Snapshot Pool     */
+/************************/
+
+#define SNAPSHOT_SLOTS	2
+#define SNAPSHOT_FORMAT	GX_TF_RGB565
+
+void InitSnapshotPool();
+void ReleaseSnapshotPool();
+
 u8 LoadTextures();
 void ReleaseTextures();
 void CloseTextures();
@@ -96,6 +107,7 @@ extern uLong full_textures_tpl_size;
 ImagePtr LoadImage(int texture, int maptoscreen);
 ImagePtr LoadImageMemCpy(int Texture, int maptoscreen);
 ImagePtr CopyFrameBufferToImage();
+ImagePtr CopyFrameBufferToImageFmt(u8 format);
 void FreeImage(ImagePtr *image);
 void CalculateUV(float posx, float posy, float width, float height, ImagePtr image);
 void FlipH(ImagePtr image, u16 flip);
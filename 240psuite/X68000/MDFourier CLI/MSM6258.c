@@ -22,14 +22,17 @@
 #include <stdio.h>
 #include "ym2151.h"
 #include "MSM6258.h"
+#include "mdftrace.h"
 
 void adpcm_outsel(unsigned char sel)
 {
 	vu8 *ppi_cwr;
 
-	ppi_cwr = (u8*)0xe9a005;
+	ppi_cwr = ADPCM_PPI_CWR;
 	*ppi_cwr = (0 << 1) | ((sel >> 1) & 1); /* Left */
 	*ppi_cwr = (1 << 1) | (sel & 1); /* Right */
+
+	MDF_TRACE_WRITE(MDF_TRACE_MSM6258, 0x02, sel);
 }
 
 /* 10 -> 1/512  (7.8k/4Mhz 15.6k/8Mhz) */
@@ -39,8 +42,10 @@ void adpcm_sample(unsigned char rate)
 {
 	vu8 *ppi_cwr;
 
-	ppi_cwr = (u8*)0xe9a005;
+	ppi_cwr = ADPCM_PPI_CWR;
 	*ppi_cwr = (rate << 2) & 0x0C;
+
+	MDF_TRACE_WRITE(MDF_TRACE_MSM6258, 0x0C, rate);
 }
 
 /* OPM 0x1B sets clk, 0 -> 8Mhz 1 -> 4Mhz) */
@@ -53,16 +58,20 @@ void adpcm_stop()
 {
 	vu8 *adpcm_command;
 
-	adpcm_command  = (u8*)0xe92001;
+	adpcm_command  = ADPCM_COMMAND;
 	*adpcm_command = 0x1;
+
+	MDF_TRACE_WRITE(MDF_TRACE_MSM6258, 0x00, 0x1);
 }
 
 void adpcm_start()
 {
 	vu8 *adpcm_command;
 
-	adpcm_command  = (u8*)0xe92001;
+	adpcm_command  = ADPCM_COMMAND;
 	*adpcm_command = 0x2;
+
+	MDF_TRACE_WRITE(MDF_TRACE_MSM6258, 0x00, 0x2);
 }
 
 void adpcm_dma_setup(unsigned char *adpcm_source, unsigned short adpcm_size)
@@ -70,8 +79,8 @@ void adpcm_dma_setup(unsigned char *adpcm_source, unsigned short adpcm_size)
 	volatile struct DMAREG *dma;
 	vu8 *adpcm_data;
 
-	dma = (struct DMAREG *)0xe840c0;
-	adpcm_data = (u8*)0xe92003;
+	dma = ADPCM_DMA;
+	adpcm_data = ADPCM_DATA;
 
 	dma->dcr = 0x80;
 	dma->ocr = 0x32;
@@ -101,7 +110,7 @@ void adpcm_dma_start()
 {
 	volatile struct DMAREG *dma;
 
-	dma = (struct DMAREG *)0xe840c0;
+	dma = ADPCM_DMA;
 	dma->ccr |= 0x80;
 }
 
@@ -110,8 +119,8 @@ void adpcm_dma_wait_complete()
 	vu8						*adpcm_status;
 	volatile struct DMAREG 	*dma;
 
-	dma = (struct DMAREG *)0xe840c0;
-	adpcm_status = (u8*)0xe92001;
+	dma = ADPCM_DMA;
+	adpcm_status = ADPCM_COMMAND;
 
 	while(!(dma->csr & 0x90) && ! (*adpcm_status & 0x80));
 }
@@ -120,6 +129,6 @@ void adpcm_dma_clear_flag()
 {
 	volatile struct DMAREG *dma;
 
-	dma = (struct DMAREG *)0xe840c0;
+	dma = ADPCM_DMA;
 	dma->csr = 0xff;
 }
@@ -61,6 +61,15 @@ struct DMAREG {
 	unsigned char gcr;
 };
 
+#ifdef MDF_HOST
+#include "mdfhost.h"
+#else
+#define ADPCM_DMA		((volatile struct DMAREG *)0xe840c0)	/* DMAC channel 3 */
+#define ADPCM_COMMAND	((vu8*)0xe92001)	/* status when read */
+#define ADPCM_DATA		((vu8*)0xe92003)
+#define ADPCM_PPI_CWR	((vu8*)0xe9a005)
+#endif
+
 /* 00: Left and right ON
    01: Right only 
    10: Left only 
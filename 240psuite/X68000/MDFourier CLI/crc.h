@@ -8,7 +8,7 @@
 
 #include <stdlib.h>           /* For size_t                 */
 typedef unsigned char  BYTE;
-typedef unsigned long  DWORD;
+typedef unsigned int   DWORD;         /* 32 bits, also on a PC      */
 typedef unsigned short WORD;
 
 /*
@@ -0,0 +1,129 @@
+/* 
+ * 240p Test Suite
+ * Hardware stand-ins for building the MDFourier CLI on a PC
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307	USA
+ */
+
+#ifdef MDF_HOST
+
+#include <stdio.h>
+#include <string.h>
+#include "types.h"
+#include "MSM6258.h"
+
+struct DMAREG	mdf_host_dma;
+unsigned char	mdf_host_adpcm_command = 0;
+unsigned char	mdf_host_adpcm_data = 0;
+unsigned char	mdf_host_ppi_cwr = 0;
+
+static const mdf_backend	*host_backend = NULL;
+static double				host_frame_rate = 55.458;
+static int					host_input = 1;
+static long					host_frame = 0;
+
+static int		adpcm_clock = 8000000;
+static double	adpcm_time = 0;		// MSM6258 samples since init
+static int		dma_running = 0;
+static long		dma_nibble = 0;
+
+void mdf_host_init(const mdf_backend *backend, double frame_rate, int input)
+{
+	memset(&mdf_host_dma, 0, sizeof(mdf_host_dma));
+	mdf_host_adpcm_command = 0;
+	mdf_host_adpcm_data = 0;
+	mdf_host_ppi_cwr = 0;
+
+	host_backend = backend;
+	host_frame_rate = frame_rate;
+	host_input = input;
+	host_frame = 0;
+
+	adpcm_clock = 8000000;
+	adpcm_time = 0;
+	dma_running = 0;
+	dma_nibble = 0;
+}
+
+// key.c is not built, the answer to the prompt is given at init
+int read_input()
+{
+	return host_input;
+}
+
+void mdf_host_ym2151(unsigned char reg, unsigned char data)
+{
+	// CT1 is the MSM6258 clock
+	if(reg == 0x1B)
+		adpcm_clock = (data & 0x80) ? 4000000 : 8000000;
+	if(host_backend && host_backend->ym2151)
+		host_backend->ym2151(reg, data);
+}
+
+void mdf_host_vblank()
+{
+	// Prepare_ADPCM_DMA() always sets the /512 divider
+	int					rate = adpcm_clock / 512;
+	int					samples = 0, nibbles = 0;
+	const unsigned char	*data = NULL;
+
+	samples = (int)((long)(adpcm_time + rate / host_frame_rate) - (long)adpcm_time);
+	adpcm_time += rate / host_frame_rate;
+
+	// writing all ones clears the flags
+	if(mdf_host_dma.csr == 0xFF)
+		mdf_host_dma.csr = 0;
+
+	// started during the frame that just ended
+	if((mdf_host_dma.ccr & 0x80) && !dma_running)
+	{
+		dma_running = 1;
+		dma_nibble = 0;
+	}
+
+	// two samples a byte, while the MSM6258 is told to play
+	if(dma_running && (mdf_host_adpcm_command & 0x02))
+	{
+		long left = mdf_host_dma.mtc * 2L - dma_nibble;
+
+		nibbles = samples < left ? samples : (int)left;
+		data = mdf_host_dma.mar;
+	}
+
+	if(host_backend && host_backend->frame)
+		host_backend->frame(data, dma_nibble, nibbles, samples, rate);
+
+	if(data)
+	{
+		dma_nibble += nibbles;
+		// COC, the loop waiting on it sees it after this vblank
+		if(dma_nibble >= mdf_host_dma.mtc * 2L)
+		{
+			mdf_host_dma.ccr &= ~0x80;
+			mdf_host_dma.csr |= 0x80;
+			dma_running = 0;
+		}
+	}
+	host_frame++;
+}
+
+long mdf_host_frames()
+{
+	return host_frame;
+}
+
+#endif
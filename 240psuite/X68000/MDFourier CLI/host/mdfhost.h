@@ -0,0 +1,67 @@
+/* 
+ * 240p Test Suite
+ * Hardware stand-ins for building the MDFourier CLI on a PC
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307	USA
+ */
+
+#ifndef _MDFHOST_H_
+#define _MDFHOST_H_
+
+// Included by ym2151.c, MSM6258.h and video.h when built with MDF_HOST.
+// The YM2151 writes come here whole, as its busy flag is read back from
+// the port that is written. The MSM6258 and its DMA channel are plain
+// variables that mdf_host_vblank() looks at once a frame, as often as
+// the sequence looks at them too, and the DMA runs there at the rate the
+// MSM6258 takes the bytes, so adpcm_dma_wait_complete_vblank() sees the
+// transfer end on the same frame it would on the console.
+//
+// What the chips sound like is up to a backend. Without one only the
+// timing is there, which is all tools/mdftrace needs.
+
+struct DMAREG;
+
+extern struct DMAREG	mdf_host_dma;
+extern unsigned char	mdf_host_adpcm_command;
+extern unsigned char	mdf_host_adpcm_data;
+extern unsigned char	mdf_host_ppi_cwr;
+
+#define ADPCM_DMA		(&mdf_host_dma)
+#define ADPCM_COMMAND	((vu8*)&mdf_host_adpcm_command)
+#define ADPCM_DATA		((vu8*)&mdf_host_adpcm_data)
+#define ADPCM_PPI_CWR	((vu8*)&mdf_host_ppi_cwr)
+
+typedef struct {
+	const char	*name;
+	// a register write, they take no time
+	void		(*ym2151)(unsigned char reg, unsigned char data);
+	// one frame of output, with the writes made during it already in.
+	// adpcm is what the DMA points at and nibble where the MSM6258 is in
+	// it, it has data for nibbles of the samples at adpcm_rate and is
+	// NULL while it isn't playing. nibble is 0 when a transfer starts.
+	void		(*frame)(const unsigned char *adpcm, long nibble, int nibbles,
+					int samples, int adpcm_rate);
+} mdf_backend;
+
+// what the frames are timed at, read_input() returns input
+void mdf_host_init(const mdf_backend *backend, double frame_rate, int input);
+void mdf_host_ym2151(unsigned char reg, unsigned char data);
+void mdf_host_vblank();
+// vblanks since mdf_host_init()
+long mdf_host_frames();
+
+#endif // _MDFHOST_H_
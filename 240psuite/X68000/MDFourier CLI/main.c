@@ -27,6 +27,7 @@
 #include "key.h"
 #include "crc.h"
 #include "mdfourier.h"
+#include "mdftrace.h"
 
 #define ADPCM_SIZE	39061
 #define ADPCM_CRC32	0x8E5FFD51
@@ -135,6 +136,9 @@ int main(void)
 		printf("Starting MDFourier ADPCM DMA Playback test\n");
 		ExecuteADPCMOnly(adpcm_sweep, adpcm_size);
 	}
+#ifdef MDF_TRACE
+	printf("Register trace: %d writes over %d frames, %d lost\n", mdf_trace_count, mdf_trace_frame, mdf_trace_lost);
+#endif
 	
 	if(adpcm_sweep)
 	{
@@ -25,6 +25,7 @@
 #include "MSM6258.h"
 #include "video.h"
 #include "key.h"
+#include "mdftrace.h"
 
 int video_count = 0;
 int adcpm_dma_frames = 0;
@@ -156,8 +157,8 @@ void adpcm_dma_wait_complete_vblank()
 	vu8						*adpcm_status;
 	volatile struct DMAREG 	*dma;
 
-	dma = (struct DMAREG *)0xe840c0;
-	adpcm_status = (u8*)0xe92001;
+	dma = ADPCM_DMA;
+	adpcm_status = ADPCM_COMMAND;
 
 	adcpm_dma_frames = 0;
 	while(!(dma->csr & 0x90) && ! (*adpcm_status & 0x80))
@@ -251,6 +252,7 @@ void ExecuteADPCM()
 
 void MDFSequence(u16 framelen, u8 *adpcm, u16 adpcm_size)
 {
+	MDF_TRACE_START();
 	yminit();
 	Prepare_ADPCM_DMA(adpcm, adpcm_size);
 	wait_vblank();	
@@ -299,10 +301,12 @@ void ExecuteMDF(u16 framelen, u8 *adpcm, u16 adpcm_size)
 {
 	MDFSequence(framelen, adpcm, adpcm_size);
 	SilenceMDF();
+	MDF_TRACE_STOP();
 }
 
 void ExecuteADPCMOnly(u8 *adpcm, u16 adpcm_size)
 {
+	MDF_TRACE_START();
 	yminit();
 	Prepare_ADPCM_DMA(adpcm, adpcm_size);
 	wait_vblank();
@@ -314,6 +318,7 @@ void ExecuteADPCMOnly(u8 *adpcm, u16 adpcm_size)
 #endif
 
 	ExecuteADPCM();
+	MDF_TRACE_STOP();
 
 	printf("ADPCM DMA playback frames: %d\n", adcpm_dma_frames);
 	
@@ -0,0 +1,64 @@
+/* 
+ * 240p Test Suite
+ * Register write trace for the MDFourier sequence
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+ 
+#include "mdftrace.h"
+
+#ifdef MDF_TRACE
+
+mdf_trace_entry	mdf_trace[MDF_TRACE_SIZE];
+int				mdf_trace_count = 0;
+int				mdf_trace_lost = 0;
+u16				mdf_trace_frame = 0;
+static u8		mdf_trace_on = 0;
+
+void mdf_trace_start()
+{
+	mdf_trace_count = 0;
+	mdf_trace_lost = 0;
+	mdf_trace_frame = 0;
+	mdf_trace_on = 1;
+}
+
+void mdf_trace_stop()
+{
+	mdf_trace_on = 0;
+}
+
+void mdf_trace_write(u8 chip, u8 reg, u8 value)
+{
+	mdf_trace_entry *entry = NULL;
+
+	if(!mdf_trace_on)
+		return;
+	// keep the start, the sync pulses are there
+	if(mdf_trace_count == MDF_TRACE_SIZE)
+	{
+		mdf_trace_lost++;
+		return;
+	}
+	entry = &mdf_trace[mdf_trace_count++];
+	entry->frame = mdf_trace_frame;
+	entry->chip = chip;
+	entry->reg = reg;
+	entry->value = value;
+}
+
+#endif
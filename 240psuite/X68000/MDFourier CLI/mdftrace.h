@@ -0,0 +1,78 @@
+/* 
+ * 240p Test Suite
+ * Register write trace for the MDFourier sequence
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _MDFTRACE_H_
+#define _MDFTRACE_H_
+
+#include "types.h"
+
+// Built with "make TRACE=1", every YM2151 and MSM6258 write the sequence
+// makes is kept in RAM with the number of vblanks waited before it, so
+// the exact timeline can be compared against the other ports and fed to
+// a reference renderer. tools/mdftrace builds the sequence on a PC and
+// saves the same trace as a VGM. The macros compile to nothing otherwise.
+
+// chip numbers are the same in the Genesis trace
+#define MDF_TRACE_YM2612	0
+#define MDF_TRACE_YM2612_B	1	// second register bank
+#define MDF_TRACE_PSG		2
+#define MDF_TRACE_YM2151	3
+#define MDF_TRACE_MSM6258	4	// as the VGM OKIM6258 registers
+
+// about 1600 entries for the full sequence
+#ifndef MDF_TRACE_SIZE
+#define MDF_TRACE_SIZE		2048
+#endif
+
+typedef struct {
+	u16 frame;
+	u8	chip;
+	u8	reg;
+	u8	value;
+	u8	pad;
+} mdf_trace_entry;
+
+#ifdef MDF_TRACE
+
+extern mdf_trace_entry	mdf_trace[MDF_TRACE_SIZE];
+extern int				mdf_trace_count;
+extern int				mdf_trace_lost;
+extern u16				mdf_trace_frame;
+
+void mdf_trace_start();
+void mdf_trace_stop();
+void mdf_trace_write(u8 chip, u8 reg, u8 value);
+
+#define MDF_TRACE_START()					mdf_trace_start()
+#define MDF_TRACE_STOP()					mdf_trace_stop()
+#define MDF_TRACE_FRAME()					mdf_trace_frame++
+#define MDF_TRACE_WRITE(chip, reg, value)	mdf_trace_write(chip, reg, value)
+
+#else
+
+#define MDF_TRACE_START()
+#define MDF_TRACE_STOP()
+#define MDF_TRACE_FRAME()
+#define MDF_TRACE_WRITE(chip, reg, value)
+
+#endif
+
+#endif // _MDFTRACE_H_
@@ -21,6 +21,7 @@
  
 #include <stdint.h>
 #include "types.h"
+#include "mdftrace.h"
 
 // Original Code by	lydux
 // https://nfggames.com/forum2/index.php?topic=5115.0
@@ -143,13 +144,22 @@ static void inline wait_for_vdisp  (void)
 	while(CRTC_under_vblank);
 }
 
+#ifdef MDF_HOST
+#include "mdfhost.h"
+#endif
+
 static void inline wait_vblank (void)
 {
+#ifdef MDF_HOST
+	mdf_host_vblank();
+#else
 	// were we called during vblank? (most probably the same one due to our short cycles)
 	if(CRTC_under_vblank)
 		wait_for_vdisp();
 	wait_for_vblank ();
+#endif
 
+	MDF_TRACE_FRAME();
 	video_count++;
 }
 
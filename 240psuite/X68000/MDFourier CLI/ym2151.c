@@ -20,6 +20,10 @@
  */
  
 #include "ym2151.h"
+#include "mdftrace.h"
+#ifdef MDF_HOST
+#include "mdfhost.h"
+#endif
 
 #define BYTE_TO_BINARY(byte)  \
   (byte & 0x80 ? '1' : '0'), \
@@ -34,6 +38,9 @@
 
 void YM2151_writeReg(const u8 reg, const u8 data)
 {
+#ifdef MDF_HOST
+	mdf_host_ym2151(reg, data);
+#else
 	vu8 *regPTR, *dataPTR;
 
 	regPTR = (u8*) YM2151_REG;
@@ -47,7 +54,9 @@ void YM2151_writeReg(const u8 reg, const u8 data)
 	// wait while YM2151 busy
 	while (*dataPTR & 0x80);
 	*dataPTR = data;
+#endif
 
+	MDF_TRACE_WRITE(MDF_TRACE_YM2151, reg, data);
 	//printf("%02X->%c%c%c%c%c%c%c%c\n", reg, BYTE_TO_BINARY(data));
 }
 
@@ -0,0 +1,277 @@
+/*
+ * 240p Test Suite
+ * OKI ADPCM encoder and analyzer
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * Encodes and decodes the ADPCM the PC Engine CD (PCE/adpcm*.vox) and the
+ * X68000 play, so MDFourier can be given the exact waveform a console
+ * should put out for an ADPCM block:
+ *
+ *	adpcm -t chip [-r rate] [-d depth] -e in.wav out.vox
+ *	adpcm -t chip [-r rate] -x in.vox out.wav
+ *	adpcm -t chip [-r rate] [-c ref.wav] -a in.vox
+ *
+ *	-e  encode, then decode again and report the SNR against the input
+ *	-x  decode to a 16 bit mono WAV, bit exact to the chip's DAC
+ *	-a  decoder statistics; with -c the SNR against a reference WAV
+ *	-r  sample rate, the chip's default otherwise; input WAVs at other
+ *	    rates are resampled linearly. For the PCE, ad_play() rate n
+ *	    plays at 32000/(16-n) Hz.
+ *	-d  encoder lookahead in samples, 1 to 3
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "adpcm.h"
+
+// segmental SNR frames, and what counts as silence in them
+#define SEGMENT_MS 20
+#define SEGMENT_SILENCE 1.0e4
+
+static void usage()
+{
+	printf("adpcm -t chip [-r rate] [-d depth] -e in.wav out.vox\n");
+	printf("adpcm -t chip [-r rate] -x in.vox out.wav\n");
+	printf("adpcm -t chip [-r rate] [-c ref.wav] -a in.vox\n");
+	printf("chips:\n");
+	adpcm_chip_list();
+}
+
+static uint8_t *load_file(const char *path, int *size)
+{
+	FILE *fp = fopen(path, "rb");
+	if (!fp)
+	{
+		fprintf(stderr, "%s: could not open\n", path);
+		return NULL;
+	}
+	fseek(fp, 0, SEEK_END);
+	*size = (int)ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	uint8_t *data = malloc(*size > 0 ? *size : 1);
+	if (data && (fread(data, 1, *size, fp) != (size_t)*size))
+	{
+		free(data);
+		data = NULL;
+	}
+	fclose(fp);
+	if (!data)
+		fprintf(stderr, "%s: could not read\n", path);
+	return data;
+}
+
+// WAV at the given rate
+static int16_t *load_wav(const char *path, int rate, int *count)
+{
+	int wav_rate;
+	int16_t *samples = adpcm_wav_load(path, count, &wav_rate);
+	if (!samples || (wav_rate == rate))
+		return samples;
+
+	fprintf(stderr, "%s: resampled from %d to %d Hz\n", path, wav_rate, rate);
+	int16_t *resampled = adpcm_resample(samples, *count, wav_rate, rate, count);
+	free(samples);
+	return resampled;
+}
+
+// overall and segmental SNR of decoded against reference
+static void report_snr(const int16_t *ref, const int16_t *out, int count, int rate)
+{
+	double signal = 0, noise = 0, seg_sum = 0, seg_min = 1e9;
+	int segment = rate*SEGMENT_MS/1000, segments = 0, peak = 0;
+
+	for (int start = 0; start < count; start += segment)
+	{
+		double s = 0, n = 0;
+		for (int i = start; (i < start + segment) && (i < count); i++)
+		{
+			double d = (double)ref[i] - out[i];
+			s += (double)ref[i]*ref[i];
+			n += d*d;
+			if (abs(ref[i] - out[i]) > peak)
+				peak = abs(ref[i] - out[i]);
+		}
+		signal += s;
+		noise += n;
+		if (s < SEGMENT_SILENCE*segment)
+			continue;
+		double snr = 10*log10(s/(n > 0 ? n : 1));
+		seg_sum += snr;
+		if (snr < seg_min)
+			seg_min = snr;
+		segments++;
+	}
+
+	if (noise == 0)
+	{
+		printf("  bit exact\n");
+		return;
+	}
+	printf("  SNR %.2f dB", 10*log10(signal/noise));
+	if (segments)
+		printf(", segmental %.2f dB (worst %d ms frame %.2f dB)", seg_sum/segments, SEGMENT_MS, seg_min);
+	printf(", peak error %d\n", peak);
+}
+
+static int encode(const adpcm_chip_t *chip, int rate, int depth, const char *in_path, const char *out_path)
+{
+	int count;
+	int16_t *in = load_wav(in_path, rate, &count);
+	if (!in)
+		return 1;
+
+	uint8_t *data = malloc((count + 1)/2 + 1);
+	int16_t *out = malloc(sizeof(int16_t)*(count + 1));
+	if (!data || !out)
+		return 1;
+	adpcm_encode(chip, in, count, depth, data);
+
+	FILE *fp = fopen(out_path, "wb");
+	if (!fp || (fwrite(data, 1, (count + 1)/2, fp) != (size_t)(count + 1)/2) || fclose(fp))
+	{
+		fprintf(stderr, "%s: could not write\n", out_path);
+		return 1;
+	}
+
+	// round trip through the decoder the console has
+	int clamped = adpcm_decode(chip, data, count, out);
+	printf("%s: %d samples at %d Hz, %d bytes, %d clamped\n", out_path, count, rate, (count + 1)/2, clamped);
+	report_snr(in, out, count, rate);
+	free(in);
+	free(out);
+	free(data);
+	return 0;
+}
+
+static int decode(const adpcm_chip_t *chip, int rate, const char *in_path, const char *out_path)
+{
+	int size;
+	uint8_t *data = load_file(in_path, &size);
+	if (!data)
+		return 1;
+	int16_t *out = malloc(sizeof(int16_t)*(size*2 + 1));
+	if (!out)
+		return 1;
+	adpcm_decode(chip, data, size*2, out);
+	int status = adpcm_wav_save(out_path, out, size*2, rate);
+	free(out);
+	free(data);
+	return status ? 1 : 0;
+}
+
+static int analyze(const adpcm_chip_t *chip, int rate, const char *in_path, const char *ref_path)
+{
+	int size;
+	uint8_t *data = load_file(in_path, &size);
+	if (!data)
+		return 1;
+
+	int count = size*2, clamped = 0, peak = 0, step_max = 0, step_hist[7] = { 0 };
+	double energy = 0, step_sum = 0;
+	int16_t *out = malloc(sizeof(int16_t)*(count + 1));
+	adpcm_state_t state;
+	if (!out)
+		return 1;
+
+	adpcm_reset(&state);
+	for (int i = 0; i < count; i++)
+	{
+		bool hit;
+		int shift = ((i & 1) ^ chip->high_first) ? 4 : 0;
+		int signal = adpcm_decode_nibble(chip, &state, (data[i >> 1] >> shift) & 15, &hit);
+		out[i] = adpcm_output(chip, signal);
+		clamped += hit;
+		energy += (double)out[i]*out[i];
+		if (abs(out[i]) > peak)
+			peak = abs(out[i]);
+		step_sum += state.step;
+		step_hist[state.step/7]++;
+		if (state.step > step_max)
+			step_max = state.step;
+	}
+
+	printf("%s: %d samples, %.3f s at %d Hz\n", in_path, count, (double)count/rate, rate);
+	printf("  peak %.2f dBFS, RMS %.2f dBFS, %d clamped\n", 20*log10((peak ? peak : 1)/32768.0),
+			10*log10((energy > 0 ? energy/count : 1)/(32768.0*32768.0)), clamped);
+	printf("  step index average %.1f, max %d, by 7s:", count ? step_sum/count : 0, step_max);
+	for (int i = 0; i < 7; i++)
+		printf(" %d", step_hist[i]);
+	printf("\n");
+
+	if (ref_path)
+	{
+		int ref_count;
+		int16_t *ref = load_wav(ref_path, rate, &ref_count);
+		if (!ref)
+			return 1;
+		if (ref_count != count)
+			printf("  %s has %d samples, comparing the first %d\n", ref_path, ref_count,
+					ref_count < count ? ref_count : count);
+		report_snr(ref, out, ref_count < count ? ref_count : count, rate);
+		free(ref);
+	}
+	free(out);
+	free(data);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const adpcm_chip_t *chip = NULL;
+	const char *ref = NULL;
+	int rate = 0, depth = 1;
+	char mode = 0;
+	int i;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if ( (strcmp(argv[i], "-t") == 0) && (i + 1 < argc) )
+			chip = adpcm_chip_find(argv[++i]);
+		else if ( (strcmp(argv[i], "-r") == 0) && (i + 1 < argc) )
+			rate = (int)strtol(argv[++i], NULL, 0);
+		else if ( (strcmp(argv[i], "-d") == 0) && (i + 1 < argc) )
+			depth = (int)strtol(argv[++i], NULL, 0);
+		else if ( (strcmp(argv[i], "-c") == 0) && (i + 1 < argc) )
+			ref = argv[++i];
+		else if ( (strcmp(argv[i], "-e") == 0) || (strcmp(argv[i], "-x") == 0) || (strcmp(argv[i], "-a") == 0) )
+			mode = argv[i][1];
+		else
+		{
+			usage();
+			return 2;
+		}
+	}
+	if ( !chip || !mode || (depth < 1) || (depth > 3) || (rate < 0) ||
+		(i != argc - ((mode == 'a') ? 1 : 2)) )
+	{
+		usage();
+		return 2;
+	}
+	if (!rate)
+		rate = chip->rate;
+
+	if (mode == 'e')
+		return encode(chip, rate, depth, argv[i], argv[i + 1]);
+	if (mode == 'x')
+		return decode(chip, rate, argv[i], argv[i + 1]);
+	return analyze(chip, rate, argv[i], ref);
+}
@@ -0,0 +1,46 @@
+#ifndef ADPCM_H
+#define ADPCM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// One OKI ADPCM chip: the MSM5205 on the PC Engine CD, the MSM6258 on
+// the X68000. Both decode with the same 49 step table, they differ in
+// the order of the nibbles in a byte and in the DAC width.
+#define ADPCM_SIGNAL_BITS 12
+
+typedef struct {
+	const char *name;
+	int high_first;			//1 if the high nibble plays first
+	int dac_bits;			//top bits of the signal the DAC takes
+	int rate;				//default sample rate
+} adpcm_chip_t;
+
+typedef struct {
+	int signal;				//ADPCM_SIGNAL_BITS wide, signed
+	int step;				//0-48
+} adpcm_state_t;
+
+// adpcm_codec.c
+const adpcm_chip_t *adpcm_chip_find(const char *name);
+void adpcm_chip_list();
+void adpcm_reset(adpcm_state_t *state);
+// Clocks one nibble through the decoder, returns the new signal.
+// *clamped is set when the signal hit the 12 bit range.
+int adpcm_decode_nibble(const adpcm_chip_t *chip, adpcm_state_t *state, int nibble, bool *clamped);
+// What the DAC makes of a signal, scaled to 16 bits.
+int16_t adpcm_output(const adpcm_chip_t *chip, int signal);
+// Decodes count samples, to 16 bit. Returns the number of clamped ones.
+int adpcm_decode(const adpcm_chip_t *chip, const uint8_t *data, int count, int16_t *out);
+// Encodes count 16 bit samples into (count+1)/2 bytes. depth is how
+// many samples each choice looks at, 1 is the plain best nibble.
+void adpcm_encode(const adpcm_chip_t *chip, const int16_t *in, int count, int depth, uint8_t *out);
+
+// adpcm_wav.c. PCM WAV, 8 or 16 bit, channels are mixed down to mono.
+// Returns the samples or NULL after printing why.
+int16_t *adpcm_wav_load(const char *path, int *count, int *rate);
+int adpcm_wav_save(const char *path, const int16_t *samples, int count, int rate);
+// Linear interpolation to another rate, returns a new buffer.
+int16_t *adpcm_resample(const int16_t *in, int count, int from, int to, int *out_count);
+
+#endif /* !ADPCM_H */
@@ -0,0 +1,216 @@
+/*
+ * 240p Test Suite
+ * OKI ADPCM encoder and decoder
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * The decoder follows the OKI data sheets: a nibble adds sign * (step*b2
+ * + step/2*b1 + step/4*b0 + step/8) with each term truncated on its own,
+ * then the signal is clamped to 12 bits and the step index moves by
+ * -1 -1 -1 -1 2 4 6 8. Both chips start at signal 0, step 0 after a
+ * reset. The DAC takes the top dac_bits of the signal, the MSM6258 drops
+ * the two low ones. Decoded samples are the DAC value scaled to 16 bits.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "adpcm.h"
+
+#define ADPCM_STEPS 49
+
+static const adpcm_chip_t chips[] = {
+	{ "pce", 1, 12, 32000 },	// MSM5205, ad_play() rate 15
+	{ "x68k", 0, 10, 15625 },	// MSM6258, 8MHz/512
+};
+
+// 16*1.1^n truncated, as the data sheets list it
+static const int step_size[ADPCM_STEPS] = {
+	16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66,
+	73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+	337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411,
+	1552
+};
+
+static const int index_shift[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static int diff_lookup[ADPCM_STEPS][16];
+static bool tables_ready;
+
+static void build_tables()
+{
+	for (int step = 0; step < ADPCM_STEPS; step++)
+	{
+		int size = step_size[step];
+		for (int nibble = 0; nibble < 16; nibble++)
+		{
+			int diff = size/8;
+			if (nibble & 4)
+				diff += size;
+			if (nibble & 2)
+				diff += size/2;
+			if (nibble & 1)
+				diff += size/4;
+			diff_lookup[step][nibble] = (nibble & 8) ? -diff : diff;
+		}
+	}
+	tables_ready = true;
+}
+
+const adpcm_chip_t *adpcm_chip_find(const char *name)
+{
+	for (unsigned i = 0; i < sizeof(chips)/sizeof(chips[0]); i++)
+		if (strcmp(chips[i].name, name) == 0)
+			return &chips[i];
+	return NULL;
+}
+
+void adpcm_chip_list()
+{
+	for (unsigned i = 0; i < sizeof(chips)/sizeof(chips[0]); i++)
+		printf("  %-5s %d bit DAC, %s nibble first, %d Hz\n", chips[i].name, chips[i].dac_bits,
+				chips[i].high_first ? "high" : "low", chips[i].rate);
+}
+
+void adpcm_reset(adpcm_state_t *state)
+{
+	if (!tables_ready)
+		build_tables();
+	state->signal = 0;
+	state->step = 0;
+}
+
+static inline int clamp_step(int step)
+{
+	return step < 0 ? 0 : (step > ADPCM_STEPS - 1 ? ADPCM_STEPS - 1 : step);
+}
+
+int adpcm_decode_nibble(const adpcm_chip_t *chip, adpcm_state_t *state, int nibble, bool *clamped)
+{
+	int max = (1 << (ADPCM_SIGNAL_BITS - 1)) - 1;
+	int min = -(1 << (ADPCM_SIGNAL_BITS - 1));
+	int signal = state->signal + diff_lookup[state->step][nibble & 15];
+
+	*clamped = false;
+	if (signal > max)
+	{
+		signal = max;
+		*clamped = true;
+	}
+	else if (signal < min)
+	{
+		signal = min;
+		*clamped = true;
+	}
+	state->signal = signal;
+	state->step = clamp_step(state->step + index_shift[nibble & 7]);
+	return signal;
+}
+
+int16_t adpcm_output(const adpcm_chip_t *chip, int signal)
+{
+	int drop = ADPCM_SIGNAL_BITS - chip->dac_bits;
+	return (int16_t)((signal >> drop)*(1 << (16 - chip->dac_bits)));
+}
+
+static inline int nibble_at(const adpcm_chip_t *chip, const uint8_t *data, int i)
+{
+	int shift = ((i & 1) ^ chip->high_first) ? 4 : 0;
+	return (data[i >> 1] >> shift) & 15;
+}
+
+int adpcm_decode(const adpcm_chip_t *chip, const uint8_t *data, int count, int16_t *out)
+{
+	adpcm_state_t state;
+	int clamped_count = 0;
+
+	adpcm_reset(&state);
+	for (int i = 0; i < count; i++)
+	{
+		bool clamped;
+		int signal = adpcm_decode_nibble(chip, &state, nibble_at(chip, data, i), &clamped);
+		out[i] = adpcm_output(chip, signal);
+		clamped_count += clamped;
+	}
+	return clamped_count;
+}
+
+/*
+ * Encoder. All 16 nibbles are tried from the current state in one pass
+ * over fixed size arrays, which compilers turn into vector code, and the
+ * one with the least squared error wins. With depth > 1 every candidate
+ * is followed that many samples further and judged by the sum, so a
+ * nibble that overshoots now but leaves a better step can be picked.
+ * The cost grows 16 times per level, 3 is about the useful limit.
+ */
+
+static int64_t search(const adpcm_chip_t *chip, const adpcm_state_t *state, const int16_t *in, int left,
+		int depth, int *best)
+{
+	int max = (1 << (ADPCM_SIGNAL_BITS - 1)) - 1;
+	int min = -(1 << (ADPCM_SIGNAL_BITS - 1));
+	int drop = ADPCM_SIGNAL_BITS - chip->dac_bits;
+	int scale = 1 << (16 - chip->dac_bits);
+	const int *diff = diff_lookup[state->step];
+	int signal[16];
+	int64_t error[16];
+
+	for (int k = 0; k < 16; k++)
+	{
+		int s = state->signal + diff[k];
+		s = s > max ? max : s;
+		s = s < min ? min : s;
+		signal[k] = s;
+		int64_t e = (int64_t)in[0] - (int64_t)((s >> drop) * scale);
+		error[k] = e*e;
+	}
+
+	if ( (depth > 1) && (left > 1) )
+	{
+		for (int k = 0; k < 16; k++)
+		{
+			adpcm_state_t next = { signal[k], clamp_step(state->step + index_shift[k & 7]) };
+			error[k] += search(chip, &next, in + 1, left - 1, depth - 1, NULL);
+		}
+	}
+
+	int pick = 0;
+	for (int k = 1; k < 16; k++)
+		if (error[k] < error[pick])
+			pick = k;
+	if (best)
+		*best = pick;
+	return error[pick];
+}
+
+void adpcm_encode(const adpcm_chip_t *chip, const int16_t *in, int count, int depth, uint8_t *out)
+{
+	adpcm_state_t state;
+	bool clamped;
+
+	adpcm_reset(&state);
+	memset(out, 0, (count + 1)/2);
+	for (int i = 0; i < count; i++)
+	{
+		int nibble;
+		search(chip, &state, in + i, count - i, depth, &nibble);
+		adpcm_decode_nibble(chip, &state, nibble, &clamped);
+		int shift = ((i & 1) ^ chip->high_first) ? 4 : 0;
+		out[i >> 1] |= (uint8_t)(nibble << shift);
+	}
+}
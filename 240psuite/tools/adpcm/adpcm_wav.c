@@ -0,0 +1,186 @@
+/*
+ * 240p Test Suite
+ * WAV files for the ADPCM tool
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "adpcm.h"
+
+static uint32_t le32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t le16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+	p[0] = v & 0xff;
+	p[1] = (v >> 8) & 0xff;
+	p[2] = (v >> 16) & 0xff;
+	p[3] = (v >> 24) & 0xff;
+}
+
+static void put16(uint8_t *p, uint16_t v)
+{
+	p[0] = v & 0xff;
+	p[1] = (v >> 8) & 0xff;
+}
+
+int16_t *adpcm_wav_load(const char *path, int *count, int *rate)
+{
+	FILE *fp = fopen(path, "rb");
+	if (!fp)
+	{
+		fprintf(stderr, "%s: could not open\n", path);
+		return NULL;
+	}
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	uint8_t *file = malloc(size > 0 ? size : 1);
+	if (!file || fread(file, 1, size, fp) != (size_t)size)
+	{
+		fprintf(stderr, "%s: could not read\n", path);
+		fclose(fp);
+		free(file);
+		return NULL;
+	}
+	fclose(fp);
+
+	if ( (size < 12) || memcmp(file, "RIFF", 4) || memcmp(file + 8, "WAVE", 4) )
+	{
+		fprintf(stderr, "%s: not a WAV file\n", path);
+		free(file);
+		return NULL;
+	}
+
+	int channels = 0, bits = 0, format = 0;
+	const uint8_t *data = NULL;
+	uint32_t data_size = 0;
+	for (long pos = 12; pos + 8 <= size; )
+	{
+		uint32_t len = le32(file + pos + 4);
+		if (len > (uint32_t)(size - pos - 8))
+			len = (uint32_t)(size - pos - 8);
+		if ( (memcmp(file + pos, "fmt ", 4) == 0) && (len >= 16) )
+		{
+			format = le16(file + pos + 8);
+			channels = le16(file + pos + 10);
+			*rate = (int)le32(file + pos + 12);
+			bits = le16(file + pos + 22);
+		}
+		else if (memcmp(file + pos, "data", 4) == 0)
+		{
+			data = file + pos + 8;
+			data_size = len;
+		}
+		pos += 8 + len + (len & 1);
+	}
+
+	// 0xFFFE is WAVE_FORMAT_EXTENSIBLE, still plain PCM for what is read here
+	if ( !data || ((format != 1) && (format != 0xFFFE)) || (channels < 1) || ((bits != 8) && (bits != 16)) )
+	{
+		fprintf(stderr, "%s: only 8 and 16 bit PCM WAV files are read\n", path);
+		free(file);
+		return NULL;
+	}
+
+	int frame = channels*bits/8;
+	*count = (int)(data_size/frame);
+	int16_t *samples = malloc(sizeof(int16_t)*(*count > 0 ? *count : 1));
+	if (!samples)
+	{
+		free(file);
+		return NULL;
+	}
+	for (int i = 0; i < *count; i++)
+	{
+		int sum = 0;
+		for (int c = 0; c < channels; c++)
+		{
+			const uint8_t *p = data + i*frame + c*bits/8;
+			sum += (bits == 8) ? (p[0] - 128)*256 : (int16_t)le16(p);
+		}
+		samples[i] = (int16_t)(sum/channels);
+	}
+	free(file);
+	return samples;
+}
+
+int adpcm_wav_save(const char *path, const int16_t *samples, int count, int rate)
+{
+	uint8_t header[44];
+
+	memcpy(header, "RIFF", 4);
+	put32(header + 4, 36 + count*2);
+	memcpy(header + 8, "WAVEfmt ", 8);
+	put32(header + 16, 16);
+	put16(header + 20, 1);
+	put16(header + 22, 1);
+	put32(header + 24, rate);
+	put32(header + 28, rate*2);
+	put16(header + 32, 2);
+	put16(header + 34, 16);
+	memcpy(header + 36, "data", 4);
+	put32(header + 40, count*2);
+
+	FILE *fp = fopen(path, "wb");
+	if (!fp)
+	{
+		fprintf(stderr, "%s: could not write\n", path);
+		return -1;
+	}
+	fwrite(header, 1, sizeof(header), fp);
+	for (int i = 0; i < count; i++)
+	{
+		uint8_t p[2];
+		put16(p, (uint16_t)samples[i]);
+		fwrite(p, 1, 2, fp);
+	}
+	if (fclose(fp))
+	{
+		fprintf(stderr, "%s: could not write\n", path);
+		return -1;
+	}
+	return 0;
+}
+
+int16_t *adpcm_resample(const int16_t *in, int count, int from, int to, int *out_count)
+{
+	*out_count = (int)((int64_t)count*to/from);
+	int16_t *out = malloc(sizeof(int16_t)*(*out_count > 0 ? *out_count : 1));
+	if (!out)
+		return NULL;
+	for (int i = 0; i < *out_count; i++)
+	{
+		int64_t pos = (int64_t)i*from;		// in units of 1/to input samples
+		int n = (int)(pos/to);
+		int frac = (int)(pos%to);
+		int a = in[n];
+		int b = (n + 1 < count) ? in[n + 1] : a;
+		out[i] = (int16_t)(a + (int64_t)(b - a)*frac/to);
+	}
+	return out;
+}
@@ -0,0 +1,275 @@
+/*
+ * 240p Test Suite
+ * Audio/video sync analyzer for the Audio Sync test
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+/*
+ * Measures how far the 1 kHz tone of the Audio Sync test is from the
+ * white flash it plays with, in a capture of many of its cycles:
+ *
+ *	avsync -s WxH [options] video.gray audio.wav
+ *	avsync -c [options] luma.csv audio.wav
+ *
+ *	-s  raw 8 bit luma frames of that size, one after the other
+ *	-c  a CSV of the average luma per frame, "time,luma" or just "luma"
+ *	-f  frames per second of the capture, 59.94 by default
+ *	-l  scanlines per frame period with blanking, for raw frames; the
+ *	    frame height by default, 262 or 525 for an NTSC capture
+ *	-y  luma a flash adds over the frame before it, 48 by default
+ *	-W  luma of a fully lit frame in the CSV, the brightest otherwise;
+ *	    give it when the flash is one frame, as then none may be fully lit
+ *	-t  tone frequency in Hz, 1000 by default
+ *	-a  tone level in dBFS, -40 by default
+ *	-m  largest offset in ms that pairs a flash with a tone, 500
+ *	-b  histogram bin in ms, 0.25 by default
+ *	-g  print the histogram
+ *	-p  print each pair as CSV, the summary goes to stderr
+ *
+ * Either input can be - for stdin. Both are read as they are needed and
+ * the distribution is a fixed histogram, so an hour long capture takes
+ * no more memory than a short one. With ffmpeg:
+ *
+ *	ffmpeg -i cap.mkv -vn cap.wav
+ *	ffmpeg -i cap.mkv -an -f rawvideo -pix_fmt gray - | avsync -s 720x480 -l 525 - cap.wav
+ *	ffprobe -f lavfi movie=cap.mkv,signalstats -show_entries
+ *	    frame=pts_time:frame_tags=lavfi.signalstats.YAVG -of csv=p=0 > luma.csv
+ *
+ * Positive offsets are audio late.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "avsync.h"
+
+#define HISTOGRAM_LINES 60
+
+typedef struct {
+	long count;
+	double mean, m2;		//Welford's, in ms
+	double min, max;
+	double mean_time, cov, var_time;	//offset against time, for the drift
+	double bin;
+	int bins;
+	long *histogram;		//-max to +max offset
+} stats_t;
+
+static void usage()
+{
+	printf("avsync -s WxH [-f fps] [-l lines] [options] video.gray audio.wav\n");
+	printf("avsync -c [-f fps] [-W white] [options] luma.csv audio.wav\n");
+	printf("options: [-y luma] [-t hz] [-a dBFS] [-m ms] [-b ms] [-g] [-p]\n");
+}
+
+static void stats_add(stats_t *st, double time, double offset)
+{
+	st->count++;
+	double d = offset - st->mean, dt = time - st->mean_time;
+	st->mean += d/st->count;
+	st->mean_time += dt/st->count;
+	st->m2 += d*(offset - st->mean);
+	st->cov += dt*(offset - st->mean);
+	st->var_time += dt*(time - st->mean_time);
+	if ( (st->count == 1) || (offset < st->min) )
+		st->min = offset;
+	if ( (st->count == 1) || (offset > st->max) )
+		st->max = offset;
+
+	int i = (int)floor(offset/st->bin) + st->bins/2;
+	st->histogram[i < 0 ? 0 : (i >= st->bins ? st->bins - 1 : i)]++;
+}
+
+// within the bin the offsets are taken to be spread evenly
+static double percentile(const stats_t *st, double p)
+{
+	double target = p*st->count;
+	long sum = 0;
+
+	for (int i = 0; i < st->bins; i++)
+	{
+		if (st->histogram[i] && (sum + st->histogram[i] >= target))
+		{
+			double at = (i - st->bins/2 + (target - sum)/st->histogram[i])*st->bin;
+			return at < st->min ? st->min : (at > st->max ? st->max : at);
+		}
+		sum += st->histogram[i];
+	}
+	return st->max;
+}
+
+static void print_histogram(FILE *out, const stats_t *st)
+{
+	int first = (int)floor(st->min/st->bin) + st->bins/2, last = (int)floor(st->max/st->bin) + st->bins/2;
+	int merge = (last - first)/HISTOGRAM_LINES + 1;
+	long top = 0;
+
+	for (int i = first; i <= last; i += merge)
+	{
+		long n = 0;
+		for (int j = i; (j < i + merge) && (j <= last); j++)
+			n += st->histogram[j];
+		top = n > top ? n : top;
+	}
+	for (int i = first; i <= last; i += merge)
+	{
+		long n = 0;
+		for (int j = i; (j < i + merge) && (j <= last); j++)
+			n += st->histogram[j];
+		fprintf(out, "  %9.2f ms %6ld ", (i - st->bins/2)*st->bin, n);
+		for (int k = 0; k < (int)(50*n/top); k++)
+			fputc('#', out);
+		fputc('\n', out);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int i, width = 0, height = 0, lines = 0, graph = 0, pairs = 0, csv = 0;
+	double fps = 60000/1001.0, threshold = 48, white = 0, freq = 1000, level = -40, window = 500, bin = 0.25;
+
+	for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1]; i++)
+	{
+		if ( (strcmp(argv[i], "-s") == 0) && (i + 1 < argc) )
+		{
+			if (sscanf(argv[++i], "%dx%d", &width, &height) != 2)
+				width = height = 0;
+		}
+		else if (strcmp(argv[i], "-c") == 0)
+			csv = 1;
+		else if ( (strcmp(argv[i], "-f") == 0) && (i + 1 < argc) )
+			fps = atof(argv[++i]);
+		else if ( (strcmp(argv[i], "-l") == 0) && (i + 1 < argc) )
+			lines = atoi(argv[++i]);
+		else if ( (strcmp(argv[i], "-y") == 0) && (i + 1 < argc) )
+			threshold = atof(argv[++i]);
+		else if ( (strcmp(argv[i], "-W") == 0) && (i + 1 < argc) )
+			white = atof(argv[++i]);
+		else if ( (strcmp(argv[i], "-t") == 0) && (i + 1 < argc) )
+			freq = atof(argv[++i]);
+		else if ( (strcmp(argv[i], "-a") == 0) && (i + 1 < argc) )
+			level = atof(argv[++i]);
+		else if ( (strcmp(argv[i], "-m") == 0) && (i + 1 < argc) )
+			window = atof(argv[++i]);
+		else if ( (strcmp(argv[i], "-b") == 0) && (i + 1 < argc) )
+			bin = atof(argv[++i]);
+		else if (strcmp(argv[i], "-g") == 0)
+			graph = 1;
+		else if (strcmp(argv[i], "-p") == 0)
+			pairs = 1;
+		else
+		{
+			usage();
+			return 1;
+		}
+	}
+	if ( (i + 2 != argc) || (csv == (width > 0)) || (fps <= 0) || (freq <= 0) || (window <= 0) || (bin <= 0) )
+	{
+		usage();
+		return 1;
+	}
+	if ( (strcmp(argv[i], "-") == 0) && (strcmp(argv[i + 1], "-") == 0) )
+	{
+		fprintf(stderr, "only one of the inputs can be stdin\n");
+		return 1;
+	}
+
+	flash_detector_t *fd = csv ? flash_open_csv(argv[i], fps, threshold, white)
+			: flash_open_frames(argv[i], width, height, lines, fps, threshold);
+	if (!fd)
+		return 1;
+	tone_detector_t *td = tone_open(argv[i + 1], freq, level);
+	if (!td)
+	{
+		flash_close(fd);
+		return 1;
+	}
+
+	stats_t st = { 0 };
+	st.bin = bin;
+	st.bins = 2*(int)ceil(window/bin) + 2;
+	st.histogram = calloc(st.bins, sizeof(long));
+	if (!st.histogram)
+		return 1;
+
+	FILE *out = pairs ? stderr : stdout;
+	avsync_event_t flash, tone;
+	long flashes = 0, tones = 0;
+	double flash_length = 0, tone_length = 0, first_flash = 0, last_flash = 0;
+	int have_flash = flash_next(fd, &flash), have_tone = tone_next(td, &tone);
+
+	if (pairs)
+		printf("flash,tone,offset\n");
+	// both are in time order, whichever is further behind moves on
+	while (have_flash || have_tone)
+	{
+		double offset = (have_flash && have_tone) ? (tone.start - flash.start)*1000 : 0;
+
+		if ( have_flash && (!have_tone || (offset > window)) )
+		{
+			flash_length += flash.length;
+			if (!flashes++)
+				first_flash = flash.start;
+			last_flash = flash.start;
+			have_flash = flash_next(fd, &flash);
+		}
+		else if ( have_tone && (!have_flash || (offset < -window)) )
+		{
+			tone_length += tone.length;
+			tones++;
+			have_tone = tone_next(td, &tone);
+		}
+		else
+		{
+			if (pairs)
+				printf("%.6f,%.6f,%.4f\n", flash.start, tone.start, offset);
+			stats_add(&st, flash.start, offset);
+			flash_length += flash.length;
+			tone_length += tone.length;
+			if (!flashes++)
+				first_flash = flash.start;
+			last_flash = flash.start;
+			tones++;
+			have_flash = flash_next(fd, &flash);
+			have_tone = tone_next(td, &tone);
+		}
+	}
+	flash_close(fd);
+	tone_close(td);
+
+	fprintf(out, "%ld flashes, %ld tones, %ld in sync pairs\n", flashes, tones, st.count);
+	if (flashes > 1)
+		fprintf(out, "  cycle %.4f s (%.2f frames), flash %.2f frames, tone %.2f ms\n",
+				(last_flash - first_flash)/(flashes - 1), (last_flash - first_flash)/(flashes - 1)*fps,
+				flash_length/flashes*fps, tones ? tone_length/tones*1000 : 0);
+	if (st.count)
+	{
+		fprintf(out, "  offset mean %.3f ms (%.3f frames), standard deviation %.3f ms\n", st.mean,
+				st.mean*fps/1000, st.count > 1 ? sqrt(st.m2/(st.count - 1)) : 0);
+		fprintf(out, "  min %.3f, 5%% %.3f, median %.3f, 95%% %.3f, max %.3f ms\n", st.min,
+				percentile(&st, 0.05), percentile(&st, 0.5), percentile(&st, 0.95), st.max);
+		if (st.var_time > 0)
+			fprintf(out, "  drift %.3f ms per hour\n", st.cov/st.var_time*3600);
+		if (graph)
+			print_histogram(out, &st);
+	}
+	free(st.histogram);
+	return st.count ? 0 : 1;
+}
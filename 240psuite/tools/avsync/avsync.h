@@ -0,0 +1,36 @@
+#ifndef AVSYNC_H
+#define AVSYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// A white flash or a tone, in seconds from the start of the capture
+typedef struct {
+	double start;
+	double length;
+} avsync_event_t;
+
+// tone.c. Follows a tone through a PCM WAV, read in blocks, and finds
+// where it starts and stops to a fraction of a sample. level is the
+// amplitude in dBFS it has to reach to count.
+typedef struct tone_detector tone_detector_t;
+tone_detector_t *tone_open(const char *path, double freq, double level);
+// 1 and the next tone, 0 at the end of the audio
+int tone_next(tone_detector_t *td, avsync_event_t *ev);
+void tone_close(tone_detector_t *td);
+
+// flash.c. Either raw 8 bit luma frames, width x height each, or a CSV
+// with one luma value per frame, optionally after its time in seconds.
+// A frame is part of a flash when it is threshold brighter than the last
+// one before it; lines is the scanlines in a frame period, blanking
+// included, for where in the frame a row was captured.
+typedef struct flash_detector flash_detector_t;
+flash_detector_t *flash_open_frames(const char *path, int width, int height, int lines,
+		double fps, double threshold);
+// white is the luma of a fully lit frame, 0 to take the brightest seen
+flash_detector_t *flash_open_csv(const char *path, double fps, double threshold, double white);
+// 1 and the next flash, 0 at the end of the video
+int flash_next(flash_detector_t *fd, avsync_event_t *ev);
+void flash_close(flash_detector_t *fd);
+
+#endif /* !AVSYNC_H */
@@ -0,0 +1,305 @@
+/*
+ * 240p Test Suite
+ * White flashes for the audio/video sync analyzer
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+/*
+ * A capture frame is scanned from the top while the console draws, so a
+ * flash that starts in the middle of one shows up lit only from the row
+ * the scan was at, and one that ends in the middle is lit only above it.
+ * With raw frames each row is lit or not against the last frame before
+ * the flash, and the first rows that change give the time to a line.
+ * Rows that never light, like the Audio Sync test's bars, are told apart
+ * by the frame after the first one: between them every row the flash
+ * reaches has been lit.
+ *
+ * A luma CSV only has the frame's average, the lit fraction of the first
+ * and last frames stands for the rows. A frame only a few rows of the
+ * flash made it into is well under the threshold, so the frame before
+ * the one that crosses it, and the one after the flash, count when they
+ * are an eighth of it brighter.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "avsync.h"
+
+// fewer lit rows than this is the sprite or noise
+#define FLASH_MIN_ROWS 2
+
+struct flash_detector {
+	FILE *fp;
+	const char *path;
+	bool csv;
+	double period;			//seconds per frame
+	double threshold;
+	int64_t frame;			//frames read
+	double time;			//of the last frame read
+	// raw frames
+	int width;
+	int height;
+	int lines;
+	uint8_t *pixels;
+	uint8_t *dark;			//the last frame before the flash
+	bool have_dark;
+	uint8_t *lit;			//rows lit in the last frame read
+	uint8_t *first;			//in the first frame of the flash
+	uint8_t *reach;			//rows the flash lights
+	// CSV
+	double luma;
+	double prev_luma;		//and time, of the frame before
+	double prev_time;
+	double dark_luma;		//the one before that
+	double white;
+	bool fixed_white;
+};
+
+static flash_detector_t *flash_open(const char *path, double fps, double threshold)
+{
+	flash_detector_t *fd = calloc(1, sizeof(flash_detector_t));
+	if (!fd)
+		return NULL;
+	fd->path = path;
+	fd->fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+	if (!fd->fp)
+	{
+		fprintf(stderr, "%s: could not open\n", path);
+		free(fd);
+		return NULL;
+	}
+	fd->period = 1/fps;
+	fd->threshold = threshold;
+	return fd;
+}
+
+flash_detector_t *flash_open_frames(const char *path, int width, int height, int lines,
+		double fps, double threshold)
+{
+	flash_detector_t *fd = flash_open(path, fps, threshold);
+	if (!fd)
+		return NULL;
+	fd->width = width;
+	fd->height = height;
+	fd->lines = lines > height ? lines : height;
+	fd->pixels = malloc((size_t)width*height);
+	fd->dark = malloc((size_t)width*height);
+	fd->lit = malloc(height);
+	fd->first = malloc(height);
+	fd->reach = malloc(height);
+	if (!fd->pixels || !fd->dark || !fd->lit || !fd->first || !fd->reach)
+	{
+		flash_close(fd);
+		return NULL;
+	}
+	return fd;
+}
+
+flash_detector_t *flash_open_csv(const char *path, double fps, double threshold, double white)
+{
+	flash_detector_t *fd = flash_open(path, fps, threshold);
+	if (!fd)
+		return NULL;
+	fd->csv = true;
+	fd->white = white;
+	fd->fixed_white = white > 0;
+	return fd;
+}
+
+// reads a frame and marks its lit rows, returns how many
+static int read_frame(flash_detector_t *fd)
+{
+	if (fread(fd->pixels, fd->width, fd->height, fd->fp) != (size_t)fd->height)
+		return -1;
+	fd->time = fd->frame++*fd->period;
+	if (!fd->have_dark)
+	{
+		memcpy(fd->dark, fd->pixels, (size_t)fd->width*fd->height);
+		fd->have_dark = true;
+	}
+
+	int count = 0;
+	for (int y = 0; y < fd->height; y++)
+	{
+		const uint8_t *p = fd->pixels + (size_t)y*fd->width, *d = fd->dark + (size_t)y*fd->width;
+		int brighter = 0;
+		for (int x = 0; x < fd->width; x++)
+			brighter += (p[x] - d[x] > fd->threshold);
+		fd->lit[y] = brighter*2 > fd->width;
+		count += fd->lit[y];
+	}
+	return count;
+}
+
+// the time row y of the last frame read was captured at
+static double row_time(const flash_detector_t *fd, double y)
+{
+	return fd->time + y/fd->lines*fd->period;
+}
+
+// the flash reaches no row between these, the edge is taken half way;
+// rows of the frame before are at -lines
+static double between(const flash_detector_t *fd, int from, int to)
+{
+	int last;
+
+	if (from < 0)
+	{
+		for (last = fd->height - 1; (last >= 0) && !fd->reach[last]; last--)
+			;
+		from = last - fd->lines;
+	}
+	return (from + to)/2.0;
+}
+
+static int next_frames(flash_detector_t *fd, avsync_event_t *ev)
+{
+	int count, y, u;
+	double start_time;
+
+	while ( (count = read_frame(fd)) >= 0 )
+	{
+		if (count < FLASH_MIN_ROWS)
+		{
+			memcpy(fd->dark, fd->pixels, (size_t)fd->width*fd->height);
+			continue;
+		}
+
+		// the first frame lit from row s down, s is between the first lit
+		// row and the last row before it the flash reaches
+		memcpy(fd->first, fd->lit, fd->height);
+		start_time = fd->time;
+		if (read_frame(fd) < 0)
+			return 0;
+		for (y = 0; y < fd->height; y++)
+			fd->reach[y] = fd->first[y] | fd->lit[y];
+		for (y = 0; !fd->first[y]; y++)
+			;
+		for (u = y - 1; (u >= 0) && !fd->reach[u]; u--)
+			;
+		ev->start = start_time + between(fd, u, y)/fd->lines*fd->period;
+
+		// the last frame lit down to row s, the first not fully lit
+		for (;;)
+		{
+			for (y = 0; (y < fd->height) && (fd->lit[y] || !fd->reach[y]); y++)
+				;
+			if (y < fd->height)
+				break;
+			if (read_frame(fd) < 0)
+				return 0;
+		}
+		int l, v;
+		for (l = fd->height - 1; (l >= 0) && !fd->lit[l]; l--)
+			;
+		for (v = l + 1; (v < fd->height) && !fd->reach[v]; v++)
+			;
+		ev->length = row_time(fd, between(fd, l, v)) - ev->start;
+		return 1;
+	}
+	return 0;
+}
+
+// next luma value; a line with two numbers has the time first
+static bool read_luma(flash_detector_t *fd)
+{
+	char line[256];
+
+	while (fgets(line, sizeof(line), fd->fp))
+	{
+		double a, b;
+		int n = sscanf(line, "%lf%*[ ,;\t]%lf", &a, &b);
+		if (n < 1)
+			continue;
+		fd->time = n == 2 ? a : fd->frame*fd->period;
+		fd->luma = n == 2 ? b : a;
+		fd->frame++;
+		return true;
+	}
+	return false;
+}
+
+static double lit_fraction(const flash_detector_t *fd, double luma, double dark)
+{
+	double f = (luma - dark)/(fd->white - dark);
+	return f < 0 ? 0 : (f > 1 ? 1 : f);
+}
+
+static int next_csv(flash_detector_t *fd, avsync_event_t *ev)
+{
+	while (read_luma(fd))
+	{
+		if (fd->frame == 1)
+			fd->prev_luma = fd->dark_luma = fd->luma;
+		if (fd->luma - fd->prev_luma <= fd->threshold)
+		{
+			fd->dark_luma = fd->prev_luma;
+			fd->prev_luma = fd->luma;
+			fd->prev_time = fd->time;
+			continue;
+		}
+
+		double dark = fd->prev_luma, first = fd->luma, start_time = fd->time;
+		double last = first, last_time = start_time, peak = first;
+		int frames = 1;
+		if (fd->prev_luma - fd->dark_luma > fd->threshold/8)
+		{
+			dark = fd->dark_luma;
+			first = fd->prev_luma;
+			start_time = fd->prev_time;
+			frames++;
+		}
+		while (read_luma(fd) && (fd->luma - dark > fd->threshold/8))
+		{
+			last = fd->luma;
+			last_time = fd->time;
+			peak = last > peak ? last : peak;
+			frames++;
+		}
+		if (!fd->fixed_white && (peak > fd->white))
+			fd->white = peak;
+
+		ev->start = start_time + (1 - lit_fraction(fd, first, dark))*fd->period;
+		// a flash within one frame is taken to last to its end
+		ev->length = last_time + (frames > 1 ? lit_fraction(fd, last, dark) : 1)*fd->period - ev->start;
+		fd->dark_luma = fd->prev_luma = fd->luma;
+		fd->prev_time = fd->time;
+		return 1;
+	}
+	return 0;
+}
+
+int flash_next(flash_detector_t *fd, avsync_event_t *ev)
+{
+	return fd->csv ? next_csv(fd, ev) : next_frames(fd, ev);
+}
+
+void flash_close(flash_detector_t *fd)
+{
+	if (fd->fp && (fd->fp != stdin))
+		fclose(fd->fp);
+	free(fd->pixels);
+	free(fd->dark);
+	free(fd->lit);
+	free(fd->first);
+	free(fd->reach);
+	free(fd);
+}
@@ -0,0 +1,334 @@
+/*
+ * 240p Test Suite
+ * Tone onsets for the audio/video sync analyzer
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+/*
+ * The audio is mixed to mono and multiplied by a complex oscillator at
+ * the tone's frequency; the products are summed over one period of it,
+ * which cancels the tone's harmonics and leaves its amplitude. A tone
+ * starting at sample o makes that envelope ramp up linearly from o to
+ * o + period, so o is found from where the ramp crosses half of the
+ * level the tone settles at, interpolated between samples, minus half
+ * a period. The end is found the same way on the way down. Only the last
+ * few periods of the envelope are kept.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "avsync.h"
+
+#define TONE_BLOCK 4096
+
+enum { TONE_ARMED, TONE_RISING, TONE_ON, TONE_WAIT };
+
+struct tone_detector {
+	FILE *fp;
+	const char *path;
+	int rate;
+	int channels;
+	int bits;
+	bool is_float;
+	int64_t left;			//data bytes still to read, -1 up to the end of the file
+	uint8_t *block;
+	int block_count;		//frames in the block
+	int block_pos;
+	int period;				//samples in one period of the tone, the window
+	double osc_re, osc_im;	//oscillator, turned by rot every sample
+	double rot_re, rot_im;
+	float *mix_re, *mix_im;	//the last period of products
+	double sum_re, sum_im;
+	float *env;				//envelope history, a power of two
+	int env_mask;
+	int64_t n;				//samples so far
+	double level;			//amplitude that counts as a tone, full scale 1
+	int state;
+	int64_t trigger;		//sample the level was crossed at
+	double plateau;
+	double start;			//in samples
+};
+
+static uint32_t le32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t le16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+// skips a chunk by reading it, the audio can come from a pipe
+static bool skip(FILE *fp, uint32_t size)
+{
+	uint8_t buffer[256];
+
+	while (size)
+	{
+		uint32_t n = size > sizeof(buffer) ? sizeof(buffer) : size;
+		if (fread(buffer, 1, n, fp) != n)
+			return false;
+		size -= n;
+	}
+	return true;
+}
+
+static bool read_header(tone_detector_t *td)
+{
+	uint8_t riff[12], chunk[8], fmt[40];
+	bool have_fmt = false;
+	int format = 0;
+
+	if ( (fread(riff, 1, 12, td->fp) != 12) || memcmp(riff, "RIFF", 4) || memcmp(riff + 8, "WAVE", 4) )
+	{
+		fprintf(stderr, "%s: not a WAV file\n", td->path);
+		return false;
+	}
+	while (fread(chunk, 1, 8, td->fp) == 8)
+	{
+		uint32_t size = le32(chunk + 4);
+
+		if (memcmp(chunk, "fmt ", 4) == 0)
+		{
+			uint32_t n = size > sizeof(fmt) ? sizeof(fmt) : size;
+			memset(fmt, 0, sizeof(fmt));
+			if ( (fread(fmt, 1, n, td->fp) != n) || !skip(td->fp, size - n + (size & 1)) )
+				break;
+			format = le16(fmt);
+			// WAVE_FORMAT_EXTENSIBLE, the format is the start of the sub format GUID
+			if ( (format == 0xFFFE) && (size >= 26) )
+				format = le16(fmt + 24);
+			td->channels = le16(fmt + 2);
+			td->rate = (int)le32(fmt + 4);
+			td->bits = le16(fmt + 14);
+			have_fmt = true;
+		}
+		else if (memcmp(chunk, "data", 4) == 0)
+		{
+			if (!have_fmt)
+				break;
+			td->is_float = (format == 3);
+			if ( !((format == 1) && ((td->bits == 8) || (td->bits == 16) || (td->bits == 24) || (td->bits == 32)))
+					&& !(td->is_float && (td->bits == 32)) )
+			{
+				fprintf(stderr, "%s: only 8, 16, 24 and 32 bit PCM or 32 bit float WAVs are read\n", td->path);
+				return false;
+			}
+			if ( (td->channels < 1) || (td->rate < 8000) )
+			{
+				fprintf(stderr, "%s: %d channels at %d Hz\n", td->path, td->channels, td->rate);
+				return false;
+			}
+			// capture programs that stream the file leave these at 0 or all ones
+			td->left = (size && (size != 0xFFFFFFFF)) ? size : -1;
+			return true;
+		}
+		else if (!skip(td->fp, size + (size & 1)))
+			break;
+	}
+	fprintf(stderr, "%s: no audio data\n", td->path);
+	return false;
+}
+
+tone_detector_t *tone_open(const char *path, double freq, double level)
+{
+	tone_detector_t *td = calloc(1, sizeof(tone_detector_t));
+	if (!td)
+		return NULL;
+	td->path = path;
+	td->fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+	if (!td->fp)
+	{
+		fprintf(stderr, "%s: could not open\n", path);
+		free(td);
+		return NULL;
+	}
+	if (!read_header(td))
+	{
+		tone_close(td);
+		return NULL;
+	}
+
+	td->period = (int)lround(td->rate/freq);
+	for (td->env_mask = 1; td->env_mask < 4*td->period; td->env_mask <<= 1)
+		;
+	td->block = malloc((size_t)TONE_BLOCK*td->channels*(td->bits/8));
+	td->mix_re = calloc(td->period, sizeof(float));
+	td->mix_im = calloc(td->period, sizeof(float));
+	td->env = calloc(td->env_mask, sizeof(float));
+	td->env_mask--;
+	if (!td->block || !td->mix_re || !td->mix_im || !td->env)
+	{
+		tone_close(td);
+		return NULL;
+	}
+	td->osc_re = 1;
+	td->rot_re = cos(2*M_PI*freq/td->rate);
+	td->rot_im = -sin(2*M_PI*freq/td->rate);
+	td->level = pow(10.0, level/20);
+	return td;
+}
+
+// next sample mixed to mono, false at the end of the audio
+static bool read_sample(tone_detector_t *td, float *out)
+{
+	int size = td->bits/8;
+
+	if (td->block_pos == td->block_count)
+	{
+		size_t want = TONE_BLOCK;
+		if ( (td->left >= 0) && ((int64_t)want*td->channels*size > td->left) )
+			want = td->left/(td->channels*size);
+		td->block_count = want ? (int)fread(td->block, td->channels*size, want, td->fp) : 0;
+		td->block_pos = 0;
+		if (td->left >= 0)
+			td->left -= (int64_t)td->block_count*td->channels*size;
+		if (!td->block_count)
+			return false;
+		// the oscillator drifts off the unit circle a little every sample
+		double norm = sqrt(td->osc_re*td->osc_re + td->osc_im*td->osc_im);
+		td->osc_re /= norm;
+		td->osc_im /= norm;
+	}
+
+	const uint8_t *p = td->block + (size_t)td->block_pos*td->channels*size;
+	float sum = 0;
+	for (int c = 0; c < td->channels; c++, p += size)
+	{
+		if (td->is_float)
+		{
+			float f;
+			memcpy(&f, p, 4);
+			sum += f;
+		}
+		else if (size == 1)
+			sum += (p[0] - 128)/128.0f;
+		else if (size == 2)
+			sum += (int16_t)le16(p)/32768.0f;
+		else if (size == 3)
+			sum += (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24))/2147483648.0f;
+		else
+			sum += (int32_t)le32(p)/2147483648.0f;
+	}
+	td->block_pos++;
+	*out = sum/td->channels;
+	return true;
+}
+
+static inline float env_at(const tone_detector_t *td, int64_t n)
+{
+	return td->env[n & td->env_mask];
+}
+
+// where the envelope went through half the plateau between from and
+// to (either way), and from there where the tone started or stopped
+static double crossing(const tone_detector_t *td, int64_t from, int64_t to)
+{
+	double half = td->plateau/2;
+	int64_t step = from < to ? 1 : -1;
+
+	for (int64_t k = from; k != to; k += step)
+	{
+		double a = env_at(td, k), b = env_at(td, k + step);
+		if ( ((a - half)*(b - half) <= 0) && (a != b) )
+			return k + step*(half - a)/(b - a) + 1 - td->period/2.0;
+	}
+	return from + 1 - td->period/2.0;
+}
+
+int tone_next(tone_detector_t *td, avsync_event_t *ev)
+{
+	float sample;
+
+	while (read_sample(td, &sample))
+	{
+		int i = (int)(td->n % td->period);
+		float re = (float)(sample*td->osc_re), im = (float)(sample*td->osc_im);
+		double osc_re = td->osc_re*td->rot_re - td->osc_im*td->rot_im;
+
+		td->osc_im = td->osc_re*td->rot_im + td->osc_im*td->rot_re;
+		td->osc_re = osc_re;
+		td->sum_re += re - td->mix_re[i];
+		td->sum_im += im - td->mix_im[i];
+		td->mix_re[i] = re;
+		td->mix_im[i] = im;
+
+		int64_t n = td->n++;
+		float e = (float)(2*sqrt(td->sum_re*td->sum_re + td->sum_im*td->sum_im)/td->period);
+		td->env[n & td->env_mask] = e;
+
+		switch (td->state)
+		{
+		case TONE_WAIT:
+			// back under the level before the next one can start
+			if (e < td->level)
+				td->state = TONE_ARMED;
+			break;
+		case TONE_ARMED:
+			if (e >= td->level)
+			{
+				td->trigger = n;
+				td->plateau = 0;
+				td->state = TONE_RISING;
+			}
+			break;
+		case TONE_RISING:
+			// the ramp is over a period after the trigger at the latest,
+			// the plateau is the average over the period after that
+			if (e < td->level/2)
+				td->state = TONE_ARMED;
+			else if (n > td->trigger + td->period)
+			{
+				td->plateau += e;
+				if (n == td->trigger + 2*td->period)
+				{
+					td->plateau /= td->period;
+					td->start = crossing(td, td->trigger + td->period, td->trigger - td->period);
+					td->state = TONE_ON;
+				}
+			}
+			break;
+		case TONE_ON:
+			if (e < td->plateau/2)
+			{
+				double end = crossing(td, n - 1, n);
+				ev->start = td->start/td->rate;
+				ev->length = (end - td->start)/td->rate;
+				td->state = TONE_WAIT;
+				return 1;
+			}
+			break;
+		}
+	}
+	return 0;
+}
+
+void tone_close(tone_detector_t *td)
+{
+	if (td->fp && (td->fp != stdin))
+		fclose(td->fp);
+	free(td->block);
+	free(td->mix_re);
+	free(td->mix_im);
+	free(td->env);
+	free(td);
+}
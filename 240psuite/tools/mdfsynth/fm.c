@@ -0,0 +1,522 @@
+/*
+ * 240p Test Suite
+ * YM2612 and YM2151 models for the MDFourier reference renderer
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * Both chips share the operator: a 20 bit phase accumulator, a quarter
+ * sine held as 4.8 log attenuation, the 10 bit envelope added to it and
+ * the sum turned back into a 13 bit level through the exponent table,
+ * the same two ROMs read from the OPN die. The envelope generator steps
+ * every third sample by the rate's increment pattern. They differ in
+ * how the pitch becomes a phase step: F-number and block on the YM2612,
+ * key code and fraction on the YM2151, and in the output stage, a 9 bit
+ * DAC per channel against the YM3012's floating point one.
+ */
+
+#include <string.h>
+#include <math.h>
+#include "mdfsynth.h"
+
+enum { EG_ATTACK = 1, EG_DECAY, EG_SUSTAIN, EG_RELEASE };
+
+#define EG_QUIET 0x380
+
+static uint16_t sin_table[256];			//4.8 log attenuation, quarter wave
+static uint16_t power_table[256];		//mantissas for attenuation_to_volume
+static uint32_t opm_phase_table[768];	//per 1/64 semitone, block 2
+static bool tables_ready;
+
+static const uint32_t increment_table[64] = {
+	0x00000000, 0x00000000, 0x10101010, 0x10101010,
+	0x10101010, 0x10101010, 0x11101110, 0x11101110,
+	0x10101010, 0x10111010, 0x11101110, 0x11111110,
+	0x10101010, 0x10111010, 0x11101110, 0x11111110,
+	0x10101010, 0x10111010, 0x11101110, 0x11111110,
+	0x10101010, 0x10111010, 0x11101110, 0x11111110,
+	0x10101010, 0x10111010, 0x11101110, 0x11111110,
+	0x10101010, 0x10111010, 0x11101110, 0x11111110,
+	0x10101010, 0x10111010, 0x11101110, 0x11111110,
+	0x10101010, 0x10111010, 0x11101110, 0x11111110,
+	0x10101010, 0x10111010, 0x11101110, 0x11111110,
+	0x10101010, 0x10111010, 0x11101110, 0x11111110,
+	0x11111111, 0x21112111, 0x21212121, 0x22212221,
+	0x22222222, 0x42224222, 0x42424242, 0x44424442,
+	0x44444444, 0x84448444, 0x84848484, 0x88848884,
+	0x88888888, 0x88888888, 0x88888888, 0x88888888
+};
+
+static const uint8_t detune_table[32][4] = {
+	{ 0, 0, 1, 2 }, { 0, 0, 1, 2 }, { 0, 0, 1, 2 }, { 0, 0, 1, 2 },
+	{ 0, 1, 2, 2 }, { 0, 1, 2, 3 }, { 0, 1, 2, 3 }, { 0, 1, 2, 3 },
+	{ 0, 1, 2, 4 }, { 0, 1, 3, 4 }, { 0, 1, 3, 4 }, { 0, 1, 3, 5 },
+	{ 0, 2, 4, 5 }, { 0, 2, 4, 6 }, { 0, 2, 4, 6 }, { 0, 2, 5, 7 },
+	{ 0, 2, 5, 8 }, { 0, 3, 6, 8 }, { 0, 3, 6, 9 }, { 0, 3, 7, 10 },
+	{ 0, 4, 8, 11 }, { 0, 4, 8, 12 }, { 0, 4, 9, 13 }, { 0, 5, 10, 14 },
+	{ 0, 5, 11, 16 }, { 0, 6, 12, 17 }, { 0, 6, 13, 19 }, { 0, 7, 14, 20 },
+	{ 0, 8, 16, 22 }, { 0, 8, 16, 22 }, { 0, 8, 16, 22 }, { 0, 8, 16, 22 }
+};
+
+// modulation sources of OP2, OP3, OP4 (indices into the output table
+// below) and which of OP1-OP3 reach the output, per algorithm
+#define ALGORITHM(op2in, op3in, op4in, op1out, op2out, op3out) \
+	((op2in) | ((op3in) << 1) | ((op4in) << 4) | ((op1out) << 7) | ((op2out) << 8) | ((op3out) << 9))
+static const uint16_t algorithm_ops[8] = {
+	ALGORITHM(1, 2, 3, 0, 0, 0),	// O1 -> O2 -> O3 -> O4
+	ALGORITHM(0, 5, 3, 0, 0, 0),	// (O1 + O2) -> O3 -> O4
+	ALGORITHM(0, 2, 6, 0, 0, 0),	// (O1 + (O2 -> O3)) -> O4
+	ALGORITHM(1, 0, 7, 0, 0, 0),	// ((O1 -> O2) + O3) -> O4
+	ALGORITHM(1, 0, 3, 0, 1, 0),	// (O1 -> O2) + (O3 -> O4)
+	ALGORITHM(1, 1, 1, 0, 1, 1),	// (O1 -> O2) + (O1 -> O3) + (O1 -> O4)
+	ALGORITHM(1, 0, 0, 0, 1, 1),	// (O1 -> O2) + O3 + O4
+	ALGORITHM(0, 0, 0, 1, 1, 1)		// O1 + O2 + O3 + O4
+};
+
+// register offsets of OP1-OP4 within a block of operator registers
+static const int opn_slot[4] = { 0, 8, 4, 12 };
+static const int opm_slot[4] = { 0, 16, 8, 24 };
+
+static const int opm_dt2_delta[4] = { 0, 384, 500, 608 };
+
+static void build_tables()
+{
+	// both ROMs are exact roundings of these curves
+	for (int i = 0; i < 256; i++)
+	{
+		sin_table[i] = (uint16_t)lround(-log2(sin((i + 0.5)*M_PI/512.0))*256.0);
+		int e = (int)lround((pow(2.0, (255 - i)/256.0) - 1.0)*1024.0);
+		power_table[i] = (uint16_t)((e | 0x400) << 2);
+	}
+	// key code 0x4A, an A at block 4, is 440Hz from a 3.579545MHz clock
+	for (int i = 0; i < 768; i++)
+		opm_phase_table[i] = (uint32_t)lround(440.0*pow(2.0, (i - 512)/768.0)*1048576.0/(3579545.0/64.0)/4.0);
+	tables_ready = true;
+}
+
+static inline int bit(uint32_t value, int n)
+{
+	return (value >> n) & 1;
+}
+
+static inline int reg_op(const fm_chip_t *chip, int ch, int op, int base)
+{
+	if (chip->type == FM_YM2151)
+		return chip->regs[base + opm_slot[op] + ch];
+	return chip->regs[(ch/3)*256 + base + opn_slot[op] + ch%3];
+}
+
+static inline int reg_ch(const fm_chip_t *chip, int ch, int base)
+{
+	if (chip->type == FM_YM2151)
+		return chip->regs[base + ch];
+	return chip->regs[(ch/3)*256 + base + ch%3];
+}
+
+static int effective_rate(int rate, int ksr)
+{
+	if (rate == 0)
+		return 0;
+	return rate + ksr > 63 ? 63 : rate + ksr;
+}
+
+static int detune(int dt, int keycode)
+{
+	int d = detune_table[keycode][dt & 3];
+	return (dt & 4) ? -d : d;
+}
+
+static uint32_t opm_phase_step(int block_freq, int delta)
+{
+	int block = (block_freq >> 10) & 7;
+	// the 4 bit note code has gaps, 12 notes in 16
+	int code = ((block_freq >> 6) & 15) - ((block_freq >> 8) & 3);
+	int eff = ((code << 6) | (block_freq & 63)) + delta;
+
+	if ( (eff < 0) || (eff >= 768) )
+	{
+		int overflow = (eff < 0) ? -1 : eff/768;
+		block += overflow;
+		eff -= overflow*768;
+		if (block < 0)
+		{
+			block = 0;
+			eff = 0;
+		}
+		else if (block > 7)
+		{
+			block = 7;
+			eff = 767;
+		}
+	}
+	uint32_t step = opm_phase_table[eff];
+	return (block < 2) ? step >> (2 - block) : step << (block - 2);
+}
+
+// recompute what the operators of a channel derive from the registers
+static void update_channel(fm_chip_t *chip, int c)
+{
+	fm_channel_t *ch = &chip->ch[c];
+	int block_freq, keycode;
+
+	if (chip->type == FM_YM2151)
+	{
+		block_freq = ((reg_ch(chip, c, 0x28) & 0x7f) << 6) | (reg_ch(chip, c, 0x30) >> 2);
+		keycode = (block_freq >> 8) & 31;
+	}
+	else
+	{
+		static const uint8_t n3[16] = { 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1 };
+		block_freq = ((reg_ch(chip, c, 0xA4) & 0x3f) << 8) | reg_ch(chip, c, 0xA0);
+		keycode = (((block_freq >> 10) & 15) << 1) | n3[(block_freq >> 7) & 15];
+	}
+
+	for (int o = 0; o < 4; o++)
+	{
+		fm_op_t *op = &ch->op[o];
+		int dt_mul, tl, ks_ar, d1r, d2r, sl_rr, dt2 = 0;
+		uint32_t step;
+
+		if (chip->type == FM_YM2151)
+		{
+			dt_mul = reg_op(chip, c, o, 0x40);
+			tl = reg_op(chip, c, o, 0x60);
+			ks_ar = reg_op(chip, c, o, 0x80);
+			d1r = reg_op(chip, c, o, 0xA0);
+			d2r = reg_op(chip, c, o, 0xC0);
+			dt2 = d2r >> 6;
+			sl_rr = reg_op(chip, c, o, 0xE0);
+			step = opm_phase_step(block_freq, opm_dt2_delta[dt2]);
+		}
+		else
+		{
+			dt_mul = reg_op(chip, c, o, 0x30);
+			tl = reg_op(chip, c, o, 0x40);
+			ks_ar = reg_op(chip, c, o, 0x50);
+			d1r = reg_op(chip, c, o, 0x60);
+			d2r = reg_op(chip, c, o, 0x70);
+			sl_rr = reg_op(chip, c, o, 0x80);
+			step = ((uint32_t)((block_freq & 0x7ff) << 1) << ((block_freq >> 11) & 7)) >> 2;
+		}
+
+		// detune, 17 bits on the YM2612, then the multiple where 0 is one half
+		int mul = dt_mul & 15;
+		step += detune((dt_mul >> 4) & 7, keycode);
+		if (chip->type == FM_YM2612)
+			step &= 0x1ffff;
+		op->phase_step = (step*(mul ? mul*2 : 1)) >> 1;
+
+		int ksr = keycode >> ((ks_ar >> 6) ^ 3);
+		op->eg_rate[EG_ATTACK] = effective_rate((ks_ar & 31)*2, ksr);
+		op->eg_rate[EG_DECAY] = effective_rate((d1r & 31)*2, ksr);
+		op->eg_rate[EG_SUSTAIN] = effective_rate((d2r & 31)*2, ksr);
+		op->eg_rate[EG_RELEASE] = effective_rate((sl_rr & 15)*4 + 2, ksr);
+		int sl = sl_rr >> 4;
+		op->eg_sustain = (sl | ((sl + 1) & 0x10)) << 5;
+		op->total_level = (tl & 0x7f) << 3;
+	}
+	chip->dirty[c] = false;
+}
+
+void fm_init(fm_chip_t *chip, int type, int clock)
+{
+	if (!tables_ready)
+		build_tables();
+	memset(chip, 0, sizeof(*chip));
+	chip->type = type;
+	chip->clock = clock;
+	chip->channels = (type == FM_YM2151) ? 8 : 6;
+	chip->rate = clock/((type == FM_YM2151) ? 64 : 144);
+	// both chips power up with the outputs enabled
+	for (int c = 0; c < chip->channels; c++)
+	{
+		if (type == FM_YM2151)
+			chip->regs[0x20 + c] = 0xC0;
+		else
+			chip->regs[(c/3)*256 + 0xB4 + c%3] = 0xC0;
+		for (int o = 0; o < 4; o++)
+		{
+			chip->ch[c].op[o].env_state = EG_RELEASE;
+			chip->ch[c].op[o].env_att = 0x3ff;
+		}
+		chip->dirty[c] = true;
+	}
+}
+
+void fm_write(fm_chip_t *chip, int port, int reg, int value)
+{
+	reg &= 0xff;
+	value &= 0xff;
+
+	if (chip->type == FM_YM2151)
+	{
+		chip->regs[reg] = value;
+		if (reg == 0x08)
+		{
+			fm_channel_t *ch = &chip->ch[value & 7];
+			for (int o = 0; o < 4; o++)
+				ch->op[o].key_live = bit(value, 3 + o);
+		}
+		else if (reg >= 0x20)
+			chip->dirty[reg & 7] = true;
+		return;
+	}
+
+	port &= 1;
+	if ( (port == 0) && (reg < 0x30) )
+	{
+		chip->regs[reg] = value;
+		if (reg == 0x28)
+		{
+			int c = value & 3;
+			if (c == 3)
+				return;
+			c += bit(value, 2)*3;
+			for (int o = 0; o < 4; o++)
+				chip->ch[c].op[o].key_live = bit(value, 4 + o);
+		}
+		else if (reg == 0x2A)
+			chip->dac_data = value;
+		else if (reg == 0x2B)
+			chip->dac_enable = bit(value, 7);
+		return;
+	}
+
+	if ( ((reg & 3) == 3) || (reg < 0x30) )
+		return;
+	// A4-A6 only latch, the A0-A2 write after them takes both
+	if ( (reg >= 0xA4) && (reg <= 0xA6) )
+	{
+		chip->fnum_latch = value;
+		return;
+	}
+	if ( (reg >= 0xA0) && (reg <= 0xA2) )
+		chip->regs[port*256 + reg + 4] = chip->fnum_latch;
+	chip->regs[port*256 + reg] = value;
+	chip->dirty[port*3 + (reg & 3)] = true;
+}
+
+static void clock_envelope(fm_op_t *op, uint32_t env_counter)
+{
+	if ( (op->env_state == EG_ATTACK) && (op->env_att == 0) )
+		op->env_state = EG_DECAY;
+	if ( (op->env_state == EG_DECAY) && (op->env_att >= op->eg_sustain) )
+		op->env_state = EG_SUSTAIN;
+
+	int rate = op->eg_rate[op->env_state];
+	int rate_shift = rate >> 2;
+	env_counter <<= rate_shift;
+	if (env_counter & 0x7ff)
+		return;
+
+	int index = (env_counter >> (rate_shift <= 11 ? 11 : rate_shift)) & 7;
+	int increment = (increment_table[rate] >> (4*index)) & 15;
+	if (op->env_state == EG_ATTACK)
+	{
+		// 62 and 63 only act at key on
+		if (rate < 62)
+			op->env_att += (~op->env_att*increment) >> 4;
+	}
+	else
+	{
+		op->env_att += increment;
+		if (op->env_att >= 0x400)
+			op->env_att = 0x3ff;
+	}
+}
+
+static void clock_op(fm_op_t *op, uint32_t env_counter)
+{
+	if (op->key_live != op->key_state)
+	{
+		op->key_state = op->key_live;
+		if (op->key_state)
+		{
+			if (op->env_state != EG_ATTACK)
+			{
+				op->env_state = EG_ATTACK;
+				op->phase = 0;
+				if (op->eg_rate[EG_ATTACK] >= 62)
+					op->env_att = 0;
+			}
+		}
+		else if (op->env_state < EG_RELEASE)
+			op->env_state = EG_RELEASE;
+	}
+	if ((env_counter & 3) == 0)
+		clock_envelope(op, env_counter >> 2);
+	op->phase = (op->phase + op->phase_step) & 0xfffff;
+}
+
+static inline int attenuation_to_volume(int att)
+{
+	return power_table[att & 0xff] >> (att >> 8);
+}
+
+// 14 bit signed output of an operator at a 10 bit phase
+static int op_volume(const fm_op_t *op, uint32_t phase)
+{
+	if (op->env_att > EG_QUIET)
+		return 0;
+
+	int index = phase & 0xff;
+	if (bit(phase, 8))
+		index = ~index & 0xff;
+	int env = op->env_att + op->total_level;
+	if (env > 0x3ff)
+		env = 0x3ff;
+	int result = attenuation_to_volume(sin_table[index] + (env << 2));
+	return bit(phase, 9) ? -result : result;
+}
+
+static inline int clamp(int v, int lo, int hi)
+{
+	return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// the YM3012 keeps a 10 bit mantissa and a 3 bit exponent
+static int roundtrip_fp(int value)
+{
+	value = clamp(value, -32768, 32767);
+	int scan = value ^ (value >> 31);
+	// one exponent step per bit above bit 8, at least 1
+	int exponent = 1;
+	while ( (exponent < 7) && (scan >> (exponent + 8)) )
+		exponent++;
+	exponent--;
+	return value & ~((1 << exponent) - 1);
+}
+
+static int channel_output(const fm_chip_t *chip, fm_channel_t *ch, int c)
+{
+	int fb = (reg_ch(chip, c, chip->type == FM_YM2151 ? 0x20 : 0xB0) >> 3) & 7;
+	int alg = reg_ch(chip, c, chip->type == FM_YM2151 ? 0x20 : 0xB0) & 7;
+	int rshift = (chip->type == FM_YM2151) ? 0 : 5;
+	int clipmax = (chip->type == FM_YM2151) ? 32767 : 256;
+	uint16_t ops = algorithm_ops[alg];
+	int opout[8], opmod = 0;
+
+	if (fb)
+		opmod = (ch->fb_hist[0] + ch->fb_hist[1]) >> (10 - fb);
+	opout[0] = 0;
+	opout[1] = ch->fb_in = op_volume(&ch->op[0], (ch->op[0].phase >> 10) + opmod);
+	opout[2] = op_volume(&ch->op[1], (ch->op[1].phase >> 10) + (opout[ops & 1] >> 1));
+	opout[5] = opout[1] + opout[2];
+	opout[3] = op_volume(&ch->op[2], (ch->op[2].phase >> 10) + (opout[(ops >> 1) & 7] >> 1));
+	opout[6] = opout[1] + opout[3];
+	opout[7] = opout[2] + opout[3];
+
+	int result = op_volume(&ch->op[3], (ch->op[3].phase >> 10) + (opout[(ops >> 4) & 7] >> 1)) >> rshift;
+	if (bit(ops, 7))
+		result = clamp(result + (opout[1] >> rshift), -clipmax - 1, clipmax);
+	if (bit(ops, 8))
+		result = clamp(result + (opout[2] >> rshift), -clipmax - 1, clipmax);
+	if (bit(ops, 9))
+		result = clamp(result + (opout[3] >> rshift), -clipmax - 1, clipmax);
+	return result;
+}
+
+void fm_clock(fm_chip_t *chip, int *left, int *right)
+{
+	int l = 0, r = 0;
+
+	// the envelope counter skips every fourth count, one step per 3 samples
+	if (((++chip->env_counter) & 3) == 3)
+		chip->env_counter++;
+
+	for (int c = 0; c < chip->channels; c++)
+	{
+		fm_channel_t *ch = &chip->ch[c];
+		if (chip->dirty[c])
+			update_channel(chip, c);
+		ch->fb_hist[0] = ch->fb_hist[1];
+		ch->fb_hist[1] = ch->fb_in;
+		for (int o = 0; o < 4; o++)
+			clock_op(&ch->op[o], chip->env_counter);
+
+		int out;
+		int pan;
+		if (chip->type == FM_YM2151)
+		{
+			out = channel_output(chip, ch, c);
+			pan = reg_ch(chip, c, 0x20);
+			// bit 7 is right, bit 6 left
+			pan = (bit(pan, 6) ? 1 : 0) | (bit(pan, 7) ? 2 : 0);
+		}
+		else
+		{
+			if ( (c == 5) && chip->dac_enable )
+				out = (chip->dac_data - 0x80) << 1;
+			else
+				out = channel_output(chip, ch, c);
+			pan = reg_ch(chip, c, 0xB4);
+			// bit 7 is left, bit 6 right
+			pan = (bit(pan, 7) ? 1 : 0) | (bit(pan, 6) ? 2 : 0);
+		}
+		ch->out = out;
+		if (pan & 1)
+			l += out;
+		if (pan & 2)
+			r += out;
+	}
+
+	if (chip->type == FM_YM2151)
+	{
+		*left = roundtrip_fp(l);
+		*right = roundtrip_fp(r);
+	}
+	else
+	{
+		// 9 bits per channel, six channels fit 16 bits with room
+		*left = l*16;
+		*right = r*16;
+	}
+}
+
+int fm_snapshot(const fm_chip_t *chip, int c, uint8_t *out)
+{
+	int n = 0;
+
+	out[n++] = (uint8_t)chip->type;
+	out[n++] = (uint8_t)c;
+	if (chip->type == FM_YM2151)
+	{
+		for (int base = 0x20; base < 0x40; base += 8)
+			out[n++] = chip->regs[base + c];
+		for (int base = 0x40; base < 0x100; base += 0x20)
+			for (int o = 0; o < 4; o++)
+				out[n++] = (uint8_t)reg_op(chip, c, o, base);
+	}
+	else
+	{
+		out[n++] = (uint8_t)reg_ch(chip, c, 0xA0);
+		out[n++] = (uint8_t)reg_ch(chip, c, 0xA4);
+		out[n++] = (uint8_t)reg_ch(chip, c, 0xB0);
+		out[n++] = (uint8_t)reg_ch(chip, c, 0xB4);
+		for (int base = 0x30; base < 0xA0; base += 0x10)
+			for (int o = 0; o < 4; o++)
+				out[n++] = (uint8_t)reg_op(chip, c, o, base);
+	}
+	// a note that starts while the last one still rings sounds different
+	for (int o = 0; o < 4; o++)
+	{
+		out[n++] = (uint8_t)chip->ch[c].op[o].env_state;
+		out[n++] = (uint8_t)(chip->ch[c].op[o].env_att >> 2);
+	}
+	return n;
+}
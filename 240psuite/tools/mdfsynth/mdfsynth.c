@@ -0,0 +1,633 @@
+/*
+ * 240p Test Suite
+ * MDFourier reference renderer
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * Replays the register writes of an MDFourier run, as a VGM log of the
+ * Genesis (YM2612 and PSG) or X68000 (YM2151) sequence, through models
+ * of the chips and renders what a console should have put out, so a
+ * capture can be checked against it instead of against another console:
+ *
+ *	mdfsynth [-r rate] [-o out.wav] [-s notes.csv] [-c cache] in.vgm
+ *
+ *	-r  output rate, 44100 (default) or 48000
+ *	-o  16 bit stereo WAV of the whole run
+ *	-s  one line per note: when, which channel, its peak and whether
+ *	    the spectrum came from the cache
+ *	-c  spectra cache file, created if missing and added to
+ *
+ * Each chip runs at its own rate and is resampled on its own. Notes are
+ * tracked per channel from key on (FM) or from the volume or period
+ * write that makes a tone audible (PSG) to the next one, on the channel
+ * alone, and their spectra taken at the chip's rate.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "mdfsynth.h"
+
+#define VGM_RATE 44100
+// longest stretch of a note that is analyzed, 2.5s at the YM2612's rate
+#define NOTE_MAX 131072
+
+enum { CHIP_YM2612, CHIP_YM2151, CHIP_PSG, CHIPS };
+static const char *chip_names[CHIPS] = { "ym2612", "ym2151", "psg" };
+
+typedef struct {
+	bool active;
+	long start;				//chip samples
+	uint64_t key;			//state at key on
+	uint8_t *events;		//writes to the channel since, 6 bytes each
+	int event_count;
+	int event_size;
+	float *samples;
+	int count;
+} note_t;
+
+typedef struct {
+	bool present;
+	int rate;
+	long clocks;			//native samples run so far
+	resampler_t *rs;
+	long out_pos;
+	note_t notes[8];
+	int note_count;
+	int cached_count;
+} chip_state_t;
+
+typedef struct {
+	fm_chip_t ym2612;
+	fm_chip_t ym2151;
+	psg_t psg;
+	chip_state_t chip[CHIPS];
+	float *out;
+	long out_size;
+	spectra_t *spectra;
+	FILE *csv;
+	int note_index;
+	const uint8_t *pcm;		//YM2612 data blocks, for the 0x8n commands
+	long pcm_size;
+	long pcm_pos;
+} render_t;
+
+static void usage()
+{
+	printf("mdfsynth [-r rate] [-o out.wav] [-s notes.csv] [-c cache] in.vgm\n");
+}
+
+static uint8_t *load_file(const char *path, long *size)
+{
+	FILE *fp = fopen(path, "rb");
+	if (!fp)
+	{
+		fprintf(stderr, "%s: could not open\n", path);
+		return NULL;
+	}
+	fseek(fp, 0, SEEK_END);
+	*size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	uint8_t *data = malloc(*size ? *size : 1);
+	if (data && (fread(data, 1, *size, fp) != (size_t)*size))
+	{
+		free(data);
+		data = NULL;
+	}
+	fclose(fp);
+	if (!data)
+		fprintf(stderr, "%s: could not read\n", path);
+	return data;
+}
+
+static inline uint32_t get32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void put32(uint8_t *p, uint32_t v)
+{
+	p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static uint64_t fnv64(uint64_t hash, const uint8_t *data, int size)
+{
+	for (int i = 0; i < size; i++)
+		hash = (hash ^ data[i])*0x100000001B3ULL;
+	return hash;
+}
+
+static void note_end(render_t *r, int chip, int channel)
+{
+	chip_state_t *cs = &r->chip[chip];
+	note_t *n = &cs->notes[channel];
+	double peak = 0;
+	float peak_db = 0;
+	bool cached = false;
+	int bins;
+
+	if (!n->active)
+		return;
+	n->active = false;
+
+	// only the writes that land in what is analyzed make a difference
+	int size = spectra_size(n->count);
+	uint64_t key = n->key;
+	for (int i = 0; i < n->event_count; i++)
+		if (get32(n->events + i*6) < (uint32_t)size)
+			key = fnv64(key, n->events + i*6, 6);
+	uint8_t tail[4];
+	put32(tail, (uint32_t)cs->rate);
+	key = fnv64(key, tail, 4);
+
+	bins = spectra_note(r->spectra, key, n->samples, n->count, cs->rate, &peak, &peak_db, &cached);
+	if (!bins)
+		return;
+	cs->note_count++;
+	if (cached)
+		cs->cached_count++;
+	if (r->csv)
+		fprintf(r->csv, "%d,%.6f,%.6f,%s,%d,%016llx,%.2f,%.2f,%d\n", r->note_index,
+			(double)n->start/cs->rate, (double)n->count/cs->rate, chip_names[chip], channel,
+			(unsigned long long)key, peak*cs->rate/(bins*2), peak_db, cached ? 1 : 0);
+	r->note_index++;
+}
+
+static void note_start(render_t *r, int chip, int channel)
+{
+	chip_state_t *cs = &r->chip[chip];
+	note_t *n = &cs->notes[channel];
+	uint8_t snap[64];
+	int snap_len;
+
+	note_end(r, chip, channel);
+	if (!n->samples)
+		n->samples = malloc(sizeof(float)*NOTE_MAX);
+	n->active = n->samples != NULL;
+	n->start = cs->clocks;
+	n->count = 0;
+	n->event_count = 0;
+	if (chip == CHIP_PSG)
+		snap_len = psg_snapshot(&r->psg, channel, snap);
+	else
+		snap_len = fm_snapshot(chip == CHIP_YM2612 ? &r->ym2612 : &r->ym2151, channel, snap);
+	n->key = fnv64(0xCBF29CE484222325ULL, snap, snap_len);
+}
+
+// a key off or a new pitch part way through changes the note, and when
+// it lands too
+static void note_write(render_t *r, int chip, int channel, int reg, int value)
+{
+	note_t *n = &r->chip[chip].notes[channel];
+
+	if (!n->active || (n->count >= NOTE_MAX))
+		return;
+	if (n->event_count == n->event_size)
+	{
+		int size = n->event_size ? n->event_size*2 : 64;
+		uint8_t *grown = realloc(n->events, size*6);
+		if (!grown)
+			return;
+		n->events = grown;
+		n->event_size = size;
+	}
+	uint8_t *event = n->events + n->event_count*6;
+	put32(event, (uint32_t)n->count);
+	event[4] = (uint8_t)reg;
+	event[5] = (uint8_t)value;
+	n->event_count++;
+}
+
+static inline void note_sample(chip_state_t *cs, int channel, float value)
+{
+	note_t *n = &cs->notes[channel];
+	if (n->active && (n->count < NOTE_MAX))
+		n->samples[n->count++] = value;
+}
+
+// runs every chip up to a point in VGM time
+static void run_until(render_t *r, long vgm_pos)
+{
+	chip_state_t *cs;
+	int left, right;
+
+	cs = &r->chip[CHIP_YM2612];
+	if (cs->present)
+	{
+		long target = (long)((int64_t)vgm_pos*cs->rate/VGM_RATE);
+		for (; cs->clocks < target; cs->clocks++)
+		{
+			fm_clock(&r->ym2612, &left, &right);
+			for (int c = 0; c < 6; c++)
+				note_sample(cs, c, r->ym2612.ch[c].out/256.0f);
+			resampler_push(cs->rs, left/32768.0f, right/32768.0f, &r->out, &r->out_size, &cs->out_pos);
+		}
+	}
+
+	cs = &r->chip[CHIP_YM2151];
+	if (cs->present)
+	{
+		long target = (long)((int64_t)vgm_pos*cs->rate/VGM_RATE);
+		for (; cs->clocks < target; cs->clocks++)
+		{
+			fm_clock(&r->ym2151, &left, &right);
+			for (int c = 0; c < 8; c++)
+				note_sample(cs, c, r->ym2151.ch[c].out/8192.0f);
+			resampler_push(cs->rs, left/32768.0f, right/32768.0f, &r->out, &r->out_size, &cs->out_pos);
+		}
+	}
+
+	cs = &r->chip[CHIP_PSG];
+	if (cs->present)
+	{
+		long target = (long)((int64_t)vgm_pos*cs->rate/VGM_RATE);
+		for (; cs->clocks < target; cs->clocks++)
+		{
+			float sum = psg_clock(&r->psg)/32768.0f;
+			for (int c = 0; c < 4; c++)
+				note_sample(cs, c, r->psg.ch_out[c]/2048.0f);
+			resampler_push(cs->rs, sum, sum, &r->out, &r->out_size, &cs->out_pos);
+		}
+	}
+}
+
+static void write_ym2612(render_t *r, int port, int reg, int value)
+{
+	fm_chip_t *chip = &r->ym2612;
+
+	if ( (port == 0) && (reg == 0x28) && ((value & 3) != 3) )
+	{
+		int c = (value & 3) + ((value & 4) ? 3 : 0);
+		bool was_on = false;
+		for (int o = 0; o < 4; o++)
+			was_on |= chip->ch[c].op[o].key_live;
+		if ( !was_on && (value & 0xF0) )
+			note_start(r, CHIP_YM2612, c);
+		else
+			note_write(r, CHIP_YM2612, c, reg, value);
+	}
+	else if ( (port == 0) && (reg == 0x2A) )
+		note_write(r, CHIP_YM2612, 5, reg, value);
+	else if ( (reg >= 0x30) && ((reg & 3) != 3) )
+		note_write(r, CHIP_YM2612, port*3 + (reg & 3), reg, value);
+	fm_write(chip, port, reg, value);
+}
+
+static void write_ym2151(render_t *r, int reg, int value)
+{
+	fm_chip_t *chip = &r->ym2151;
+
+	if (reg == 0x08)
+	{
+		int c = value & 7;
+		bool was_on = false;
+		for (int o = 0; o < 4; o++)
+			was_on |= chip->ch[c].op[o].key_live;
+		if ( !was_on && (value & 0x78) )
+			note_start(r, CHIP_YM2151, c);
+		else
+			note_write(r, CHIP_YM2151, c, reg, value);
+	}
+	else if (reg >= 0x20)
+		note_write(r, CHIP_YM2151, reg & 7, reg, value);
+	fm_write(chip, 0, reg, value);
+}
+
+static void write_psg(render_t *r, int value)
+{
+	psg_t *psg = &r->psg;
+	int volume[4], period[4];
+
+	memcpy(volume, psg->volume, sizeof(volume));
+	memcpy(period, psg->period, sizeof(period));
+	psg_write(psg, value);
+	for (int c = 0; c < 4; c++)
+	{
+		if (psg->volume[c] == 15)
+		{
+			if (volume[c] != 15)
+				note_end(r, CHIP_PSG, c);
+		}
+		else if ( (volume[c] == 15) || (period[c] != psg->period[c]) )
+			note_start(r, CHIP_PSG, c);
+		else if (volume[c] != psg->volume[c])
+			note_write(r, CHIP_PSG, c, 0x10 | c, psg->volume[c]);
+	}
+}
+
+static int play(render_t *r, const uint8_t *vgm, long size, long *length)
+{
+	uint32_t version = get32(vgm + 0x08);
+	long pos = 0x40, t = 0;
+
+	if ( (version >= 0x150) && get32(vgm + 0x34) )
+		pos = 0x34 + get32(vgm + 0x34);
+
+	while (pos < size)
+	{
+		int cmd = vgm[pos];
+		if ( (cmd >= 0x70) && (cmd <= 0x7F) )
+		{
+			t += (cmd & 15) + 1;
+			run_until(r, t);
+			pos++;
+			continue;
+		}
+		if ( (cmd >= 0x80) && (cmd <= 0x8F) )
+		{
+			if (r->pcm_pos < r->pcm_size)
+				write_ym2612(r, 0, 0x2A, r->pcm[r->pcm_pos++]);
+			t += cmd & 15;
+			run_until(r, t);
+			pos++;
+			continue;
+		}
+		switch (cmd)
+		{
+			case 0x4F:	// Game Gear stereo, not on the Mega Drive
+				pos += 2;
+				break;
+			case 0x50:
+				if (pos + 1 >= size)
+					goto truncated;
+				write_psg(r, vgm[pos + 1]);
+				pos += 2;
+				break;
+			case 0x52:
+			case 0x53:
+				if (pos + 2 >= size)
+					goto truncated;
+				write_ym2612(r, cmd & 1, vgm[pos + 1], vgm[pos + 2]);
+				pos += 3;
+				break;
+			case 0x54:
+				if (pos + 2 >= size)
+					goto truncated;
+				write_ym2151(r, vgm[pos + 1], vgm[pos + 2]);
+				pos += 3;
+				break;
+			case 0x61:
+				if (pos + 2 >= size)
+					goto truncated;
+				t += vgm[pos + 1] | (vgm[pos + 2] << 8);
+				run_until(r, t);
+				pos += 3;
+				break;
+			case 0x62:
+				t += 735;
+				run_until(r, t);
+				pos++;
+				break;
+			case 0x63:
+				t += 882;
+				run_until(r, t);
+				pos++;
+				break;
+			case 0x66:
+				*length = t;
+				return 0;
+			case 0x67:
+			{
+				if (pos + 6 >= size)
+					goto truncated;
+				long block = get32(vgm + pos + 3) & 0x7FFFFFFF;
+				if (pos + 7 + block > size)
+					goto truncated;
+				// only the first YM2612 PCM block, as the logs have one
+				if ( (vgm[pos + 2] == 0x00) && !r->pcm )
+				{
+					r->pcm = vgm + pos + 7;
+					r->pcm_size = block;
+				}
+				pos += 7 + block;
+				break;
+			}
+			case 0xE0:
+				if (pos + 4 >= size)
+					goto truncated;
+				r->pcm_pos = get32(vgm + pos + 1);
+				pos += 5;
+				break;
+			default:
+				// other chips' writes, by the lengths the format reserves
+				if ( (cmd >= 0x30) && (cmd <= 0x3F) )
+					pos += 2;
+				else if ( (cmd >= 0x40) && (cmd <= 0x5F) )
+					pos += 3;
+				else if ( (cmd >= 0xA0) && (cmd <= 0xBF) )
+					pos += 3;
+				else if ( (cmd >= 0xC0) && (cmd <= 0xDF) )
+					pos += 4;
+				else if ( cmd >= 0xE1 )
+					pos += 5;
+				else
+				{
+					fprintf(stderr, "unknown VGM command %02X at %lX\n", cmd, pos);
+					return -1;
+				}
+				break;
+		}
+	}
+
+truncated:
+	fprintf(stderr, "VGM data ends without an end command\n");
+	*length = t;
+	return 0;
+}
+
+static int save_wav(const char *path, const float *samples, long count, int rate)
+{
+	uint8_t header[44];
+	int clipped = 0;
+
+	memcpy(header, "RIFF", 4);
+	put32(header + 4, (uint32_t)(36 + count*4));
+	memcpy(header + 8, "WAVEfmt ", 8);
+	put32(header + 16, 16);
+	header[20] = 1; header[21] = 0;
+	header[22] = 2; header[23] = 0;
+	put32(header + 24, rate);
+	put32(header + 28, rate*4);
+	header[32] = 4; header[33] = 0;
+	header[34] = 16; header[35] = 0;
+	memcpy(header + 36, "data", 4);
+	put32(header + 40, (uint32_t)(count*4));
+
+	FILE *fp = fopen(path, "wb");
+	if (!fp)
+	{
+		fprintf(stderr, "%s: could not write\n", path);
+		return -1;
+	}
+	fwrite(header, 1, sizeof(header), fp);
+	for (long i = 0; i < count*2; i++)
+	{
+		long v = lrintf(samples[i]*32768.0f);
+		if ( (v > 32767) || (v < -32768) )
+		{
+			v = (v > 0) ? 32767 : -32768;
+			clipped++;
+		}
+		uint8_t p[2] = { (uint8_t)v, (uint8_t)(v >> 8) };
+		fwrite(p, 1, 2, fp);
+	}
+	if (fclose(fp))
+	{
+		fprintf(stderr, "%s: could not write\n", path);
+		return -1;
+	}
+	if (clipped)
+		fprintf(stderr, "%s: %d samples clipped\n", path, clipped);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const char *wav_path = NULL, *csv_path = NULL, *cache_path = NULL;
+	int rate = 44100;
+	int i;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if ( (strcmp(argv[i], "-r") == 0) && (i + 1 < argc) )
+			rate = (int)strtol(argv[++i], NULL, 0);
+		else if ( (strcmp(argv[i], "-o") == 0) && (i + 1 < argc) )
+			wav_path = argv[++i];
+		else if ( (strcmp(argv[i], "-s") == 0) && (i + 1 < argc) )
+			csv_path = argv[++i];
+		else if ( (strcmp(argv[i], "-c") == 0) && (i + 1 < argc) )
+			cache_path = argv[++i];
+		else
+		{
+			usage();
+			return 2;
+		}
+	}
+	if ( (i != argc - 1) || ((rate != 44100) && (rate != 48000)) )
+	{
+		usage();
+		return 2;
+	}
+
+	long size;
+	uint8_t *vgm = load_file(argv[i], &size);
+	if (!vgm)
+		return 1;
+	if ( (size < 0x40) || memcmp(vgm, "Vgm ", 4) )
+	{
+		fprintf(stderr, "%s: not a VGM file%s\n", argv[i],
+			((size > 2) && (vgm[0] == 0x1F) && (vgm[1] == 0x8B)) ? ", gunzip it first" : "");
+		return 1;
+	}
+
+	render_t *r = calloc(1, sizeof(render_t));
+	uint32_t version = get32(vgm + 0x08);
+	uint32_t psg_clock = get32(vgm + 0x0C) & 0x3FFFFFFF;
+	uint32_t ym2612_clock = (version >= 0x110) ? get32(vgm + 0x2C) & 0x3FFFFFFF : 0;
+	uint32_t ym2151_clock = (version >= 0x110) ? get32(vgm + 0x30) & 0x3FFFFFFF : 0;
+
+	if (ym2612_clock)
+	{
+		fm_init(&r->ym2612, FM_YM2612, ym2612_clock);
+		r->chip[CHIP_YM2612].rate = r->ym2612.rate;
+	}
+	if (ym2151_clock)
+	{
+		fm_init(&r->ym2151, FM_YM2151, ym2151_clock);
+		r->chip[CHIP_YM2151].rate = r->ym2151.rate;
+	}
+	if (psg_clock)
+	{
+		psg_init(&r->psg, psg_clock);
+		r->chip[CHIP_PSG].rate = r->psg.rate;
+	}
+	for (int c = 0; c < CHIPS; c++)
+	{
+		chip_state_t *cs = &r->chip[c];
+		if (!cs->rate)
+			continue;
+		cs->present = true;
+		cs->rs = resampler_new(cs->rate, rate);
+		if (!cs->rs)
+		{
+			fprintf(stderr, "out of memory\n");
+			return 1;
+		}
+	}
+	if (!r->chip[CHIP_YM2612].present && !r->chip[CHIP_YM2151].present && !r->chip[CHIP_PSG].present)
+	{
+		fprintf(stderr, "%s: no YM2612, YM2151 or PSG in it\n", argv[i]);
+		return 1;
+	}
+
+	r->spectra = spectra_open(cache_path);
+	if (csv_path)
+	{
+		r->csv = fopen(csv_path, "w");
+		if (!r->csv)
+		{
+			fprintf(stderr, "%s: could not write\n", csv_path);
+			return 1;
+		}
+		fprintf(r->csv, "note,start_s,length_s,chip,channel,key,peak_hz,peak_db,cached\n");
+	}
+
+	clock_t begin = clock();
+	long length = 0;
+	if (play(r, vgm, size, &length))
+		return 1;
+
+	// close the notes still going and flush the resamplers
+	long out_count = (long)((int64_t)length*rate/VGM_RATE);
+	for (int c = 0; c < CHIPS; c++)
+	{
+		chip_state_t *cs = &r->chip[c];
+		if (!cs->present)
+			continue;
+		for (int ch = 0; ch < 8; ch++)
+			note_end(r, c, ch);
+		while (cs->out_pos < out_count)
+			resampler_push(cs->rs, 0, 0, &r->out, &r->out_size, &cs->out_pos);
+	}
+	double seconds = (double)(clock() - begin)/CLOCKS_PER_SEC;
+
+	int status = 0;
+	if (wav_path && (!r->out || save_wav(wav_path, r->out, out_count, rate)))
+		status = 1;
+	if (r->csv && fclose(r->csv))
+	{
+		fprintf(stderr, "%s: could not write\n", csv_path);
+		status = 1;
+	}
+	if (spectra_close(r->spectra))
+		status = 1;
+
+	printf("%.2fs of audio in %.2fs (%.0fx)\n", (double)length/VGM_RATE, seconds,
+		seconds > 0 ? (double)length/VGM_RATE/seconds : 0.0);
+	for (int c = 0; c < CHIPS; c++)
+	{
+		chip_state_t *cs = &r->chip[c];
+		if (cs->present)
+			printf("%-7s %d Hz, %d notes, %d spectra from the cache\n", chip_names[c],
+				cs->rate, cs->note_count, cs->cached_count);
+	}
+	return status;
+}
@@ -0,0 +1,93 @@
+#ifndef MDFSYNTH_H
+#define MDFSYNTH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FM_YM2612 0
+#define FM_YM2151 1
+
+// One FM operator, in algorithm order (OP1-OP4, M1 C1 M2 C2 on the OPM)
+typedef struct {
+	uint32_t phase;			//20 bits, the top 10 index the sine
+	uint32_t phase_step;
+	int env_state;
+	int env_att;			//10 bit attenuation
+	int key_live;			//as last written
+	int key_state;			//as the envelope has seen it
+	int eg_rate[5];			//effective rates by state
+	int eg_sustain;
+	int total_level;		//TL << 3
+} fm_op_t;
+
+typedef struct {
+	fm_op_t op[4];
+	int fb_hist[2];
+	int fb_in;
+	int out;				//last output, before panning
+} fm_channel_t;
+
+typedef struct {
+	int type;
+	int clock;
+	int channels;
+	int rate;				//native sample rate, clock/144 or clock/64
+	uint8_t regs[512];		//as written, two parts on the YM2612
+	int fnum_latch;			//YM2612 A4-A6
+	int dac_enable;
+	int dac_data;
+	bool dirty[8];			//channel parameters to recompute
+	uint32_t env_counter;
+	fm_channel_t ch[8];
+} fm_chip_t;
+
+// fm.c. Register level models of the YM2612 and YM2151: the phase
+// generator, envelope generator and operator run on the chips' own
+// integer tables at their native rate. The LFO, noise, SSG-EG, CSM and
+// channel 3 special mode are not modelled.
+void fm_init(fm_chip_t *chip, int type, int clock);
+void fm_write(fm_chip_t *chip, int port, int reg, int value);
+// one native sample, 16 bit left and right
+void fm_clock(fm_chip_t *chip, int *left, int *right);
+// channel state a note's sound depends on, for the spectra cache
+int fm_snapshot(const fm_chip_t *chip, int channel, uint8_t *out);
+
+typedef struct {
+	int clock;
+	int rate;				//clock/16
+	int latch;
+	int period[4];
+	int volume[4];
+	int counter[4];
+	int output[4];
+	uint16_t lfsr;
+	int noise_out;
+	int ch_out[4];			//last output per channel
+} psg_t;
+
+// psg.c, the SN76489 in the Mega Drive VDP (16 bit noise register)
+void psg_init(psg_t *psg, int clock);
+void psg_write(psg_t *psg, int value);
+int psg_clock(psg_t *psg);
+int psg_snapshot(const psg_t *psg, int channel, uint8_t *out);
+
+// resample.c, windowed sinc from a chip's rate to the output rate
+typedef struct resampler resampler_t;
+resampler_t *resampler_new(int in_rate, int out_rate);
+// adds the output samples this input completes to out, at *out_pos
+void resampler_push(resampler_t *rs, float left, float right, float **out, long *out_size, long *out_pos);
+void resampler_free(resampler_t *rs);
+
+// spectra.c
+typedef struct spectra spectra_t;
+spectra_t *spectra_open(const char *cache_path);
+// magnitude spectrum of a note in dB, from the cache when the key is known;
+// returns the bin count (size/2) and sets *peak, in bins between the two
+// closest, or 0 if too short
+int spectra_note(spectra_t *sp, uint64_t key, const float *samples, int count, int rate,
+		double *peak, float *peak_db, bool *cached);
+// how many samples of a note that long are analyzed
+int spectra_size(int count);
+int spectra_close(spectra_t *sp);
+
+#endif /* !MDFSYNTH_H */
@@ -0,0 +1,134 @@
+/*
+ * 240p Test Suite
+ * SN76489 model for the MDFourier reference renderer
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * The Sega variant: a 16 bit noise shift register tapped at bits 0 and 3
+ * for white noise, and tone periods of 0 behaving as 1. Counters run at
+ * clock/16, a tone flips its output each time its counter runs out.
+ * Attenuation is 2dB per step and 15 is off.
+ */
+
+#include <string.h>
+#include <math.h>
+#include "mdfsynth.h"
+
+// one channel at full volume, against 4096 for a YM2612 channel
+#define PSG_FULL 2048
+
+static int volume_table[16];
+
+void psg_init(psg_t *psg, int clock)
+{
+	memset(psg, 0, sizeof(*psg));
+	psg->clock = clock;
+	psg->rate = clock/16;
+	for (int i = 0; i < 4; i++)
+	{
+		psg->volume[i] = 15;
+		psg->output[i] = 1;
+	}
+	psg->lfsr = 0x8000;
+	for (int i = 0; i < 15; i++)
+		volume_table[i] = (int)lround(PSG_FULL*pow(10.0, -2.0*i/20.0));
+	volume_table[15] = 0;
+}
+
+void psg_write(psg_t *psg, int value)
+{
+	int reg;
+
+	if (value & 0x80)
+	{
+		psg->latch = reg = (value >> 4) & 7;
+		if (reg & 1)
+			psg->volume[reg >> 1] = value & 15;
+		else if (reg == 6)
+		{
+			psg->period[3] = value & 7;
+			psg->lfsr = 0x8000;
+		}
+		else
+			psg->period[reg >> 1] = (psg->period[reg >> 1] & 0x3f0) | (value & 15);
+		return;
+	}
+
+	reg = psg->latch;
+	if (reg & 1)
+		psg->volume[reg >> 1] = value & 15;
+	else if (reg == 6)
+	{
+		psg->period[3] = value & 7;
+		psg->lfsr = 0x8000;
+	}
+	else
+		psg->period[reg >> 1] = (psg->period[reg >> 1] & 15) | ((value & 0x3f) << 4);
+}
+
+int psg_clock(psg_t *psg)
+{
+	int sum = 0;
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (--psg->counter[i] <= 0)
+		{
+			psg->counter[i] = psg->period[i] ? psg->period[i] : 1;
+			// at 1 the output stays up, it is how the chip plays samples
+			psg->output[i] = (psg->period[i] <= 1) ? 1 : !psg->output[i];
+		}
+		psg->ch_out[i] = psg->output[i] ? volume_table[psg->volume[i]] : -volume_table[psg->volume[i]];
+		sum += psg->ch_out[i];
+	}
+
+	// noise clocks off 16, 32 or 64, or the third tone channel
+	if (--psg->counter[3] <= 0)
+	{
+		int rate = psg->period[3] & 3;
+		psg->counter[3] = (rate == 3) ? (psg->period[2] ? psg->period[2] : 1) : (0x10 << rate);
+		psg->output[3] = !psg->output[3];
+		if (psg->output[3])
+		{
+			int feedback = (psg->period[3] & 4) ? ((psg->lfsr ^ (psg->lfsr >> 3)) & 1) : (psg->lfsr & 1);
+			psg->lfsr = (uint16_t)((psg->lfsr >> 1) | (feedback << 15));
+		}
+	}
+	psg->ch_out[3] = (psg->lfsr & 1) ? volume_table[psg->volume[3]] : -volume_table[psg->volume[3]];
+	sum += psg->ch_out[3];
+	return sum;
+}
+
+int psg_snapshot(const psg_t *psg, int channel, uint8_t *out)
+{
+	int n = 0;
+
+	out[n++] = 0xFF;
+	out[n++] = (uint8_t)channel;
+	out[n++] = (uint8_t)psg->volume[channel];
+	out[n++] = (uint8_t)psg->period[channel];
+	out[n++] = (uint8_t)(psg->period[channel] >> 8);
+	// noise driven by the third tone
+	if ( (channel == 3) && ((psg->period[3] & 3) == 3) )
+	{
+		out[n++] = (uint8_t)psg->period[2];
+		out[n++] = (uint8_t)(psg->period[2] >> 8);
+	}
+	return n;
+}
@@ -0,0 +1,136 @@
+/*
+ * 240p Test Suite
+ * Band limited resampling for the MDFourier reference renderer
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * Blackman windowed sinc, cut at 0.45 of the lower of the two rates so
+ * the chips' images above the output Nyquist don't fold back into the
+ * reference. The kernel is tabulated at 256 phases per input sample and
+ * interpolated linearly. Output sample k sits at input time k*in/out.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "mdfsynth.h"
+
+#define RS_PHASES 256
+#define RS_ZERO_CROSSINGS 16
+
+struct resampler {
+	double step;			//input samples per output sample
+	double next;			//input time of the next output sample
+	int half;				//kernel half width, input samples
+	float *kernel;			//half*RS_PHASES + 2 entries, one side
+	int hist_size;			//power of two
+	float *hist[2];
+	long count;				//input samples pushed
+};
+
+resampler_t *resampler_new(int in_rate, int out_rate)
+{
+	resampler_t *rs = calloc(1, sizeof(resampler_t));
+	if (!rs)
+		return NULL;
+
+	rs->step = (double)in_rate/out_rate;
+	double cutoff = 0.45*(out_rate < in_rate ? (double)out_rate/in_rate : 1.0)*2.0;	//of the input Nyquist
+	rs->half = (int)ceil(RS_ZERO_CROSSINGS/cutoff);
+	rs->kernel = malloc(sizeof(float)*(rs->half*RS_PHASES + 2));
+	for (rs->hist_size = 1; rs->hist_size < 2*rs->half + 2; rs->hist_size <<= 1)
+		;
+	rs->hist[0] = calloc(rs->hist_size, sizeof(float));
+	rs->hist[1] = calloc(rs->hist_size, sizeof(float));
+	if (!rs->kernel || !rs->hist[0] || !rs->hist[1])
+	{
+		resampler_free(rs);
+		return NULL;
+	}
+
+	for (int i = 0; i <= rs->half*RS_PHASES + 1; i++)
+	{
+		double t = (double)i/RS_PHASES;
+		double x = M_PI*cutoff*t;
+		double sinc = (i == 0) ? 1.0 : sin(x)/x;
+		double w = (t >= rs->half) ? 0.0 : 0.42 + 0.5*cos(M_PI*t/rs->half) + 0.08*cos(2*M_PI*t/rs->half);
+		rs->kernel[i] = (float)(cutoff*sinc*w);
+	}
+	return rs;
+}
+
+static inline float kernel_at(const resampler_t *rs, double t)
+{
+	double pos = fabs(t)*RS_PHASES;
+	int i = (int)pos;
+	if (i >= rs->half*RS_PHASES)
+		return 0.0f;
+	float frac = (float)(pos - i);
+	return rs->kernel[i] + (rs->kernel[i + 1] - rs->kernel[i])*frac;
+}
+
+void resampler_push(resampler_t *rs, float left, float right, float **out, long *out_size, long *out_pos)
+{
+	int mask = rs->hist_size - 1;
+
+	rs->hist[0][rs->count & mask] = left;
+	rs->hist[1][rs->count & mask] = right;
+	rs->count++;
+
+	// an output sample needs input up to half a kernel past it
+	while (rs->next + rs->half <= rs->count - 1)
+	{
+		long first = (long)floor(rs->next) - rs->half + 1;
+		float l = 0, r = 0;
+
+		for (long n = first; n < first + 2*rs->half; n++)
+		{
+			if (n < 0)
+				continue;
+			float k = kernel_at(rs, n - rs->next);
+			l += rs->hist[0][n & mask]*k;
+			r += rs->hist[1][n & mask]*k;
+		}
+
+		if (*out_pos >= *out_size)
+		{
+			long size = *out_size ? *out_size*2 : 1 << 20;
+			float *grown = realloc(*out, sizeof(float)*2*size);
+			if (!grown)
+				return;
+			for (long i = *out_size*2; i < size*2; i++)
+				grown[i] = 0;
+			*out = grown;
+			*out_size = size;
+		}
+		(*out)[*out_pos*2] += l;
+		(*out)[*out_pos*2 + 1] += r;
+		(*out_pos)++;
+		rs->next += rs->step;
+	}
+}
+
+void resampler_free(resampler_t *rs)
+{
+	if (!rs)
+		return;
+	free(rs->kernel);
+	free(rs->hist[0]);
+	free(rs->hist[1]);
+	free(rs);
+}
@@ -0,0 +1,280 @@
+/*
+ * 240p Test Suite
+ * Per note spectra for the MDFourier reference renderer
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * A note is one channel on its own, at the chip's rate, from its key on
+ * to the next. Its spectrum is a Hann windowed FFT over the largest power
+ * of two that fits, as dB against a full scale sine. The same register
+ * state played for the same length always gives the same samples, so the
+ * spectra are kept in a cache file by a hash of both and the MDFourier
+ * sequences, which repeat the same notes over and over in every run,
+ * only pay for each once:
+ *
+ *	"MDFS" 1, then per entry: key (8), rate (4), size (4), size/2 floats
+ *
+ * All little endian, as the hosts this runs on are.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mdfsynth.h"
+
+#define SPECTRA_MAGIC "MDFS\1\0\0\0"
+#define SPECTRA_MIN 256
+#define SPECTRA_MAX 65536
+
+typedef struct {
+	uint64_t key;
+	int rate;
+	int bins;
+	float *db;
+} spectrum_t;
+
+struct spectra {
+	char *path;
+	spectrum_t *entries;	//open addressing, power of two
+	int size;
+	int count;
+	int loaded;				//entries read from the file, written back after them
+	uint64_t *order;		//keys in the order they were added
+};
+
+// first free slot for the key
+static int slot(spectra_t *sp, uint64_t key)
+{
+	int i = (int)(key & (sp->size - 1));
+	while (sp->entries[i].db)
+		i = (i + 1) & (sp->size - 1);
+	return i;
+}
+
+// order and count stay as they are, the cache file is written in that order
+static void grow(spectra_t *sp)
+{
+	spectrum_t *old = sp->entries;
+	int old_size = sp->size;
+
+	sp->size = old_size ? old_size*2 : 256;
+	sp->entries = calloc(sp->size, sizeof(spectrum_t));
+	sp->order = realloc(sp->order, sizeof(uint64_t)*sp->size);
+	for (int i = 0; i < old_size; i++)
+		if (old[i].db)
+			sp->entries[slot(sp, old[i].key)] = old[i];
+	free(old);
+}
+
+static spectrum_t *find(spectra_t *sp, uint64_t key)
+{
+	if (!sp->size)
+		return NULL;
+	for (int i = (int)(key & (sp->size - 1)); sp->entries[i].db; i = (i + 1) & (sp->size - 1))
+		if (sp->entries[i].key == key)
+			return &sp->entries[i];
+	return NULL;
+}
+
+static spectrum_t *insert(spectra_t *sp, uint64_t key, int rate, int bins, float *db)
+{
+	if ( (sp->count + 1)*4 > sp->size*3 )
+		grow(sp);
+	spectrum_t *s = &sp->entries[slot(sp, key)];
+	s->key = key;
+	s->rate = rate;
+	s->bins = bins;
+	s->db = db;
+	sp->order[sp->count++] = key;
+	return s;
+}
+
+spectra_t *spectra_open(const char *cache_path)
+{
+	spectra_t *sp = calloc(1, sizeof(spectra_t));
+	if (!sp)
+		return NULL;
+	grow(sp);
+	if (!cache_path)
+		return sp;
+	sp->path = strdup(cache_path);
+
+	FILE *fp = fopen(cache_path, "rb");
+	if (!fp)
+		return sp;
+	char magic[8];
+	if ( (fread(magic, 1, 8, fp) != 8) || memcmp(magic, SPECTRA_MAGIC, 8) )
+	{
+		fprintf(stderr, "%s: not a spectra cache, it will be rewritten\n", cache_path);
+		fclose(fp);
+		return sp;
+	}
+	for (;;)
+	{
+		uint64_t key;
+		uint32_t rate, size;
+		if ( (fread(&key, 8, 1, fp) != 1) || (fread(&rate, 4, 1, fp) != 1) || (fread(&size, 4, 1, fp) != 1) )
+			break;
+		if ( (size < SPECTRA_MIN) || (size > SPECTRA_MAX) )
+			break;
+		float *db = malloc(sizeof(float)*size/2);
+		if (!db || (fread(db, sizeof(float), size/2, fp) != size/2))
+		{
+			free(db);
+			break;
+		}
+		if (!find(sp, key))
+			insert(sp, key, (int)rate, (int)size/2, db);
+		else
+			free(db);
+	}
+	fclose(fp);
+	sp->loaded = sp->count;
+	return sp;
+}
+
+// in place radix 2
+static void fft(float *re, float *im, int n)
+{
+	for (int i = 1, j = 0; i < n; i++)
+	{
+		int b = n >> 1;
+		for (; j & b; b >>= 1)
+			j ^= b;
+		j |= b;
+		if (i < j)
+		{
+			float t = re[i]; re[i] = re[j]; re[j] = t;
+			t = im[i]; im[i] = im[j]; im[j] = t;
+		}
+	}
+	for (int len = 2; len <= n; len <<= 1)
+	{
+		double a = -2*M_PI/len;
+		for (int i = 0; i < n; i += len)
+			for (int k = 0; k < len/2; k++)
+			{
+				float wr = (float)cos(a*k), wi = (float)sin(a*k);
+				float xr = re[i + k + len/2]*wr - im[i + k + len/2]*wi;
+				float xi = re[i + k + len/2]*wi + im[i + k + len/2]*wr;
+				re[i + k + len/2] = re[i + k] - xr;
+				im[i + k + len/2] = im[i + k] - xi;
+				re[i + k] += xr;
+				im[i + k] += xi;
+			}
+	}
+}
+
+int spectra_size(int count)
+{
+	int size = SPECTRA_MIN;
+
+	if (count < SPECTRA_MIN)
+		return 0;
+	while ( (size*2 <= count) && (size*2 <= SPECTRA_MAX) )
+		size *= 2;
+	return size;
+}
+
+int spectra_note(spectra_t *sp, uint64_t key, const float *samples, int count, int rate,
+		double *peak, float *peak_db, bool *cached)
+{
+	int size = spectra_size(count), bin = 1;
+	spectrum_t *s;
+
+	if (!size)
+		return 0;
+
+	// the key covers the note, not how it is analyzed
+	key ^= (uint64_t)size*0x9E3779B97F4A7C15ULL;
+	*cached = (s = find(sp, key)) != NULL;
+	if (!s)
+	{
+		float *re = malloc(sizeof(float)*size), *im = calloc(size, sizeof(float));
+		float *db = malloc(sizeof(float)*size/2);
+		if (!re || !im || !db)
+			return 0;
+		for (int i = 0; i < size; i++)
+			re[i] = samples[i]*(float)(0.5 - 0.5*cos(2*M_PI*i/size));
+		fft(re, im, size);
+		// a full scale sine comes out at size/4 with the Hann window
+		for (int i = 0; i < size/2; i++)
+		{
+			double mag = sqrt((double)re[i]*re[i] + (double)im[i]*im[i])/(size/4.0);
+			db[i] = (float)(20*log10(mag > 1e-10 ? mag : 1e-10));
+		}
+		free(re);
+		free(im);
+		s = insert(sp, key, rate, size/2, db);
+	}
+
+	for (int i = 2; i < s->bins; i++)
+		if (s->db[i] > s->db[bin])
+			bin = i;
+	*peak = bin;
+	*peak_db = s->db[bin];
+	// the Hann window's main lobe is close to a parabola in dB
+	if (bin + 1 < s->bins)
+	{
+		double a = s->db[bin - 1], b = s->db[bin], c = s->db[bin + 1];
+		if (a - 2*b + c < 0)
+			*peak += 0.5*(a - c)/(a - 2*b + c);
+	}
+	return s->bins;
+}
+
+int spectra_close(spectra_t *sp)
+{
+	int status = 0;
+
+	if (sp->path && (sp->count > sp->loaded))
+	{
+		FILE *fp = fopen(sp->path, sp->loaded ? "ab" : "wb");
+		if (!fp)
+		{
+			fprintf(stderr, "%s: could not write\n", sp->path);
+			status = -1;
+		}
+		else
+		{
+			if (!sp->loaded)
+				fwrite(SPECTRA_MAGIC, 1, 8, fp);
+			for (int i = sp->loaded; i < sp->count; i++)
+			{
+				spectrum_t *s = find(sp, sp->order[i]);
+				uint32_t rate = (uint32_t)s->rate, size = (uint32_t)s->bins*2;
+				fwrite(&s->key, 8, 1, fp);
+				fwrite(&rate, 4, 1, fp);
+				fwrite(&size, 4, 1, fp);
+				fwrite(s->db, sizeof(float), s->bins, fp);
+			}
+			if (fclose(fp))
+				status = -1;
+		}
+	}
+
+	for (int i = 0; i < sp->size; i++)
+		free(sp->entries[i].db);
+	free(sp->entries);
+	free(sp->order);
+	free(sp->path);
+	free(sp);
+	return status;
+}
@@ -0,0 +1,37 @@
+/*
+ * 240p Test Suite
+ * What each port supplies to the MDFourier register trace
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+#ifndef HOST_H
+#define HOST_H
+
+extern const char *host_tool;		// program name
+extern const char *host_usage;		// the port's own flags, for usage()
+
+// takes the port's own flags at argv[*i], returns 0 if it isn't one
+int host_option(int argc, char **argv, int *i);
+double host_frame_rate();
+int host_pal();
+// runs the sequence with the trace on and vblanks at frame_rate,
+// 0 when it went through
+int host_run(int framelen, double frame_rate);
+
+#endif
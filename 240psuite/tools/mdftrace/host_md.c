@@ -0,0 +1,77 @@
+/*
+ * 240p Test Suite
+ * The Genesis MDFourier sequence on a PC
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+// Built with Genesis/240p/mdfourier.c and mdftrace.c. What the menu
+// around the sequence needs from the rest of the suite is stubbed here,
+// StopPSG() is main.c's as it writes to the PSG.
+
+#include <string.h>
+#include "mdfourier.h"
+#include "host.h"
+
+const char *host_tool = "mdftrace-md";
+const char *host_usage = "[-p] ";
+
+u8 intCancel = 0;
+u8 joytype = 0;
+
+void StopPSG()
+{
+	PSG_setEnvelope(0, PSG_ENVELOPE_MIN);
+	PSG_setEnvelope(1, PSG_ENVELOPE_MIN);
+	PSG_setEnvelope(2, PSG_ENVELOPE_MIN);
+	PSG_setEnvelope(3, PSG_ENVELOPE_MIN);
+}
+
+void VBlankIntCallback() {}
+u16 DrawMainBG() { return 0; }
+void DrawHelpText() {}
+u8 CheckHelpAndVO(u16 *buttons, u16 *pressedButtons, int option) { return 0; }
+void VDP_Start() {}
+void VDP_End() {}
+void FadeAndCleanUp() {}
+
+int host_option(int argc, char **argv, int *i)
+{
+	if (strcmp(argv[*i], "-p") == 0)
+	{
+		mdf_host_pal = 1;
+		return 1;
+	}
+	return 0;
+}
+
+double host_frame_rate()
+{
+	return mdf_host_pal ? 49.701459 : 59.922743;
+}
+
+int host_pal()
+{
+	return mdf_host_pal;
+}
+
+int host_run(int framelen, double frame_rate)
+{
+	ExececuteMDF(framelen);
+	return intCancel == 2;
+}
@@ -0,0 +1,107 @@
+/*
+ * 240p Test Suite
+ * The X68000 MDFourier sequence on a PC
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+// Built with X68000/MDFourier CLI's mdfourier.c, ym2151.c, MSM6258.c,
+// mdftrace.c and host/mdfhost.c, without a backend: the trace only needs
+// the DMA to take as long as it does on the console.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "types.h"
+#include "ym2151.h"
+#include "MSM6258.h"
+#include "mdfourier.h"
+#include "host.h"
+
+// as main.c loads sweep.pcm
+#define ADPCM_SIZE		39061
+
+const char *host_tool = "mdftrace-x68k";
+const char *host_usage = "[-a sweep.pcm] ";
+
+static const char	*adpcm_path = NULL;
+
+int host_option(int argc, char **argv, int *i)
+{
+	if ( (strcmp(argv[*i], "-a") == 0) && (*i + 1 < argc) )
+	{
+		adpcm_path = argv[++*i];
+		return 1;
+	}
+	return 0;
+}
+
+// 31kHz, 512x512
+double host_frame_rate()
+{
+	return 55.458;
+}
+
+int host_pal()
+{
+	return 0;
+}
+
+int host_run(int framelen, double frame_rate)
+{
+	u8 *adpcm = NULL;
+	long size = ADPCM_SIZE;
+
+	if (adpcm_path)
+	{
+		FILE *fp = fopen(adpcm_path, "rb");
+
+		if (!fp)
+		{
+			fprintf(stderr, "%s: could not open\n", adpcm_path);
+			return 1;
+		}
+		fseek(fp, 0, SEEK_END);
+		size = ftell(fp);
+		fseek(fp, 0, SEEK_SET);
+		// the DMA count is 16 bits
+		if ( (size <= 0) || (size > 0xFFFF) )
+		{
+			fprintf(stderr, "%s: %ld bytes, the DMA takes up to 65535\n", adpcm_path, size);
+			fclose(fp);
+			return 1;
+		}
+		adpcm = malloc(size);
+		if (!adpcm || (fread(adpcm, 1, size, fp) != (size_t)size))
+		{
+			fprintf(stderr, "%s: could not read\n", adpcm_path);
+			free(adpcm);
+			fclose(fp);
+			return 1;
+		}
+		fclose(fp);
+	}
+	else
+		adpcm = calloc(size, 1);
+	if (!adpcm)
+		return 1;
+
+	mdf_host_init(NULL, frame_rate, 1);
+	ExecuteMDF(framelen, adpcm, (u16)size);
+	free(adpcm);
+	return 0;
+}
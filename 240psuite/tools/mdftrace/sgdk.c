@@ -0,0 +1,69 @@
+/*
+ * 240p Test Suite
+ * SGDK calls the MDFourier sequence makes, as no-ops on a PC
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+// The trace is taken in the Genesis mdftrace.c, around these, so they
+// only need to be there. The vblank callback still runs, it is where
+// the sequence looks for START.
+
+#include <stdio.h>
+#include "genesis.h"
+
+u8 mdf_host_pal = 0;
+
+static _voidCallback *vint_callback = NULL;
+
+void YM2612_reset() {}
+void YM2612_writeReg(const u16 part, const u8 reg, const u8 data) {}
+void YM2612_disableDAC() {}
+void PSG_init() {}
+void PSG_setFrequency(u8 channel, u16 value) {}
+void PSG_setEnvelope(u8 channel, u8 value) {}
+void PSG_setNoise(u8 type, u8 frequency) {}
+void Z80_requestBus(u16 wait) {}
+void Z80_releaseBus() {}
+
+void SYS_disableInts() {}
+void SYS_enableInts() {}
+
+void SYS_setVIntCallback(_voidCallback *CB)
+{
+	vint_callback = CB;
+}
+
+void VDP_waitVSync()
+{
+	if (vint_callback)
+		vint_callback();
+}
+
+void VDP_drawTextBG(u16 plan, const char *str, u16 flags, u16 x, u16 y) {}
+void VDP_clearTileMapRect(u16 plan, u16 x, u16 y, u16 w, u16 h) {}
+
+u16 JOY_readJoypad(u16 joy)
+{
+	return 0;
+}
+
+void intToHex(u32 value, char *str, u16 minsize)
+{
+	sprintf(str, "%0*X", minsize, value);
+}
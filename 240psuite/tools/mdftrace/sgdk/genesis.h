@@ -0,0 +1,88 @@
+/*
+ * 240p Test Suite
+ * Host stand-in for the parts of SGDK 1.11 used by the MDFourier sequence
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+#ifndef MDFTRACE_GENESIS_H
+#define MDFTRACE_GENESIS_H
+
+#include <stdint.h>
+#include "types.h"
+
+// Same values as SGDK, the traced writes are rebuilt from them
+#define IS_PALSYSTEM				mdf_host_pal
+extern u8 mdf_host_pal;
+
+#define PSG_ENVELOPE_MIN			15
+#define PSG_ENVELOPE_MAX			0
+#define PSG_NOISE_TYPE_PERIODIC		0
+#define PSG_NOISE_TYPE_WHITE		4
+#define PSG_NOISE_FREQ_CLOCK2		0
+#define PSG_NOISE_FREQ_CLOCK4		1
+#define PSG_NOISE_FREQ_CLOCK8		2
+#define PSG_NOISE_FREQ_TONE3		3
+
+#define JOY_1						0x0000
+#define JOY_ALL						0xFFFF
+#define JOY_TYPE_PAD6				0x02
+
+#define BUTTON_UP					0x0001
+#define BUTTON_DOWN					0x0002
+#define BUTTON_LEFT					0x0004
+#define BUTTON_RIGHT				0x0008
+#define BUTTON_A					0x0040
+#define BUTTON_B					0x0010
+#define BUTTON_C					0x0020
+#define BUTTON_START				0x0080
+#define BUTTON_X					0x0400
+#define BUTTON_Y					0x0200
+#define BUTTON_Z					0x0100
+#define BUTTON_MODE					0x0800
+
+#define PAL0						0
+#define PAL1						1
+#define PAL2						2
+#define PAL3						3
+#define APLAN						0
+#define BPLAN						1
+#define TILE_ATTR(pal, prio, flipV, flipH)	(((flipH) << 11) + ((flipV) << 12) + ((pal) << 13) + ((prio) << 15))
+
+typedef void _voidCallback();
+
+void YM2612_reset();
+void YM2612_writeReg(const u16 part, const u8 reg, const u8 data);
+void YM2612_disableDAC();
+void PSG_init();
+void PSG_setFrequency(u8 channel, u16 value);
+void PSG_setEnvelope(u8 channel, u8 value);
+void PSG_setNoise(u8 type, u8 frequency);
+void Z80_requestBus(u16 wait);
+void Z80_releaseBus();
+
+void SYS_disableInts();
+void SYS_enableInts();
+void SYS_setVIntCallback(_voidCallback *CB);
+void VDP_waitVSync();
+void VDP_drawTextBG(u16 plan, const char *str, u16 flags, u16 x, u16 y);
+void VDP_clearTileMapRect(u16 plan, u16 x, u16 y, u16 w, u16 h);
+u16 JOY_readJoypad(u16 joy);
+void intToHex(u32 value, char *str, u16 minsize);
+
+#endif
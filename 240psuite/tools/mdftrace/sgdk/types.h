@@ -0,0 +1,39 @@
+/*
+ * 240p Test Suite
+ * Host stand-in for the SGDK types
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+#ifndef MDFTRACE_TYPES_H
+#define MDFTRACE_TYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int8_t				s8;
+typedef int16_t				s16;
+typedef int32_t				s32;
+typedef uint8_t				u8;
+typedef uint16_t			u16;
+typedef uint32_t			u32;
+typedef volatile uint8_t	vu8;
+typedef volatile uint16_t	vu16;
+typedef volatile uint32_t	vu32;
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * 240p Test Suite
+ * MDFourier register trace on a PC
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+/*
+ * Runs a port's MDFourier sequence on a PC, built from the port's own
+ * sources with MDF_TRACE, and saves the register writes it makes:
+ *
+ *	mdftrace-md   [-p] [-l frames] [-r hz] [-t trace.txt] [-o out.vgm]
+ *	mdftrace-x68k [-a sweep.pcm] [-l frames] [-r hz] [-t trace.txt] [-o out.vgm]
+ *
+ *	-p  PAL Genesis, the PSG dividers and the frame rate change with it
+ *	-a  ADPCM to play, the DMA is timed by its size (silence otherwise)
+ *	-l  frames per note, 20 as the menus use
+ *	-r  frame rate the waits are counted in, the console's by default
+ *	-t  one line per write: frame, chip, register and value
+ *	-o  VGM 1.61 log, mdfsynth renders it
+ *
+ * It always prints how long the sequence ran and how many writes it made,
+ * so two ports, or a port before and after a change, can be compared.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vgm.h"
+#include "host.h"
+
+static const char *chip_names[] = { "ym2612", "ym2612b", "psg", "ym2151", "msm6258" };
+
+static void usage()
+{
+	fprintf(stderr, "usage: %s %s[-l frames] [-r hz] [-t trace.txt] [-o out.vgm]\n", host_tool, host_usage);
+}
+
+static int dump(const char *path, const mdf_trace_entry *trace, int count)
+{
+	FILE *fp = fopen(path, "w");
+
+	if (!fp)
+	{
+		fprintf(stderr, "%s: could not create\n", path);
+		return -1;
+	}
+	for (int i = 0; i < count; i++)
+		fprintf(fp, "%5u %-8s %02X %02X\n", trace[i].frame,
+			trace[i].chip <= MDF_TRACE_MSM6258 ? chip_names[trace[i].chip] : "?",
+			trace[i].reg, trace[i].value);
+	if (fclose(fp))
+	{
+		fprintf(stderr, "%s: could not write\n", path);
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const char *vgm_path = NULL, *dump_path = NULL;
+	double frame_rate = 0;
+	int i, framelen = 20, busiest = 0, status = 0;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if ( (strcmp(argv[i], "-l") == 0) && (i + 1 < argc) )
+			framelen = atoi(argv[++i]);
+		else if ( (strcmp(argv[i], "-r") == 0) && (i + 1 < argc) )
+			frame_rate = atof(argv[++i]);
+		else if ( (strcmp(argv[i], "-t") == 0) && (i + 1 < argc) )
+			dump_path = argv[++i];
+		else if ( (strcmp(argv[i], "-o") == 0) && (i + 1 < argc) )
+			vgm_path = argv[++i];
+		else if (!host_option(argc, argv, &i))
+		{
+			usage();
+			return 1;
+		}
+	}
+	if ( (i != argc) || (framelen < 5) || (framelen > 255) || (frame_rate < 0) )
+	{
+		usage();
+		return 1;
+	}
+	if (!frame_rate)
+		frame_rate = host_frame_rate();
+
+	if (host_run(framelen, frame_rate))
+		return 1;
+
+	for (i = 0; i < mdf_trace_count; )
+	{
+		int j = i;
+
+		while ( (j < mdf_trace_count) && (mdf_trace[j].frame == mdf_trace[i].frame) )
+			j++;
+		if (j - i > busiest)
+			busiest = j - i;
+		i = j;
+	}
+	printf("%s: %d frames, %.3fs at %.6fHz\n", host_tool, mdf_trace_frame, mdf_trace_frame/frame_rate, frame_rate);
+	printf("%d writes, at most %d in a frame, %d lost\n", mdf_trace_count, busiest, mdf_trace_lost);
+	if (mdf_trace_lost)
+		fprintf(stderr, "the trace is short, build with a larger MDF_TRACE_SIZE\n");
+
+	if (dump_path && dump(dump_path, mdf_trace, mdf_trace_count))
+		status = 1;
+	if (vgm_path && vgm_save(vgm_path, mdf_trace, mdf_trace_count, mdf_trace_frame, frame_rate, host_pal()))
+		status = 1;
+	return status;
+}
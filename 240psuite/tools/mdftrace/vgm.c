@@ -0,0 +1,170 @@
+/*
+ * 240p Test Suite
+ * VGM output for the MDFourier register trace
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+/*
+ * Only the chips the trace has writes for get a clock in the header:
+ *
+ *	YM2612		7670453 (NTSC) or 7600489 (PAL), 0x52 and 0x53
+ *	SN76489		3579545 (NTSC) or 3546893 (PAL), 0x50, Sega noise taps
+ *	YM2151		4000000, 0x54
+ *	OKIM6258	8000000 at /512, 0xB7
+ *
+ * The MSM6258 gets its control, pan and divider writes as the X68000
+ * makes them, but not the samples: those reach it by DMA and there is no
+ * stream of them in the trace. Waits are rounded from the start of the
+ * log so they don't drift over the run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "vgm.h"
+
+#define VGM_HEADER_SIZE	0x100
+
+static void put32(unsigned char *p, unsigned int v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+	p[2] = (v >> 16) & 0xFF;
+	p[3] = (v >> 24) & 0xFF;
+}
+
+static long frame_sample(int frame, double frame_rate)
+{
+	return lround(frame*VGM_RATE/frame_rate);
+}
+
+static void wait(FILE *fp, long samples)
+{
+	while (samples > 0)
+	{
+		long n = samples > 0xFFFF ? 0xFFFF : samples;
+
+		if (n == 735)
+			fputc(0x62, fp);
+		else if (n == 882)
+			fputc(0x63, fp);
+		else if (n <= 16)
+			fputc(0x70 + n - 1, fp);
+		else
+		{
+			fputc(0x61, fp);
+			fputc(n & 0xFF, fp);
+			fputc(n >> 8, fp);
+		}
+		samples -= n;
+	}
+}
+
+int vgm_save(const char *path, const mdf_trace_entry *trace, int count,
+		int frames, double frame_rate, int pal)
+{
+	unsigned char header[VGM_HEADER_SIZE];
+	int used[MDF_TRACE_MSM6258 + 1] = { 0 };
+	long now = 0, size = 0;
+	FILE *fp = NULL;
+
+	fp = fopen(path, "wb");
+	if (!fp)
+	{
+		fprintf(stderr, "%s: could not create\n", path);
+		return -1;
+	}
+
+	for (int i = 0; i < count; i++)
+		if (trace[i].chip <= MDF_TRACE_MSM6258)
+			used[trace[i].chip] = 1;
+
+	memset(header, 0, sizeof(header));
+	fwrite(header, 1, sizeof(header), fp);
+
+	for (int i = 0; i < count; i++)
+	{
+		long at = frame_sample(trace[i].frame, frame_rate);
+
+		wait(fp, at - now);
+		now = at;
+		switch (trace[i].chip)
+		{
+			case MDF_TRACE_YM2612:
+			case MDF_TRACE_YM2612_B:
+				fputc(trace[i].chip == MDF_TRACE_YM2612 ? 0x52 : 0x53, fp);
+				fputc(trace[i].reg, fp);
+				fputc(trace[i].value, fp);
+				break;
+			case MDF_TRACE_PSG:
+				fputc(0x50, fp);
+				fputc(trace[i].value, fp);
+				break;
+			case MDF_TRACE_YM2151:
+				fputc(0x54, fp);
+				fputc(trace[i].reg, fp);
+				fputc(trace[i].value, fp);
+				break;
+			case MDF_TRACE_MSM6258:
+				fputc(0xB7, fp);
+				fputc(trace[i].reg, fp);
+				fputc(trace[i].value, fp);
+				break;
+		}
+	}
+	if (frame_sample(frames, frame_rate) > now)
+	{
+		wait(fp, frame_sample(frames, frame_rate) - now);
+		now = frame_sample(frames, frame_rate);
+	}
+	fputc(0x66, fp);
+	size = ftell(fp);
+
+	memcpy(header, "Vgm ", 4);
+	put32(header + 0x04, (unsigned int)(size - 4));
+	put32(header + 0x08, 0x161);
+	if (used[MDF_TRACE_PSG])
+	{
+		put32(header + 0x0C, pal ? 3546893 : 3579545);
+		header[0x28] = 0x09;		// feedback taps
+		header[0x2A] = 16;			// shift register width
+	}
+	put32(header + 0x18, (unsigned int)now);
+	put32(header + 0x24, (unsigned int)lround(frame_rate));
+	if (used[MDF_TRACE_YM2612] || used[MDF_TRACE_YM2612_B])
+		put32(header + 0x2C, pal ? 7600489 : 7670453);
+	if (used[MDF_TRACE_YM2151])
+		put32(header + 0x30, 4000000);
+	put32(header + 0x34, VGM_HEADER_SIZE - 0x34);
+	if (used[MDF_TRACE_MSM6258])
+	{
+		put32(header + 0x90, 8000000);
+		header[0x94] = 0x02;		// divider 512, 15.6kHz
+	}
+
+	fseek(fp, 0, SEEK_SET);
+	fwrite(header, 1, sizeof(header), fp);
+	if (fclose(fp))
+	{
+		fprintf(stderr, "%s: could not write\n", path);
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,37 @@
+/*
+ * 240p Test Suite
+ * VGM output for the MDFourier register trace
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+#ifndef VGM_H
+#define VGM_H
+
+// the port's own, by the include path
+#include "mdftrace.h"
+
+#define VGM_RATE	44100
+
+// Writes a VGM 1.61 log of the trace, each entry waited to the start of
+// its frame. frames is where the log ends. The clocks are the console's,
+// pal only changes the Genesis ones.
+int vgm_save(const char *path, const mdf_trace_entry *trace, int count,
+		int frames, double frame_rate, int pal);
+
+#endif
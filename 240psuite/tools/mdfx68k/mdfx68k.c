@@ -0,0 +1,153 @@
+/*
+ * 240p Test Suite
+ * The X68000 MDFourier CLI on a PC
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+/*
+ * Builds X68000/MDFourier CLI as it is, main() and all, against the host
+ * layer in its host/ directory and runs it faster than real time:
+ *
+ *	mdfx68k [-b synth|none] [-r rate] [-o out.wav] [-e] [-d dir]
+ *
+ *	-b  backend, synth (default) renders the YM2151 and MSM6258,
+ *	    none only runs the timing and is the quickest
+ *	-r  output rate, 44100 or 48000 (default)
+ *	-o  16 bit stereo WAV of the run, synth only
+ *	-e  the ADPCM DMA playback test, as ESC at the prompt
+ *	-d  where sweep.pcm is, main() loads it from the current directory
+ *
+ * After the run it prints how long it took against how long it plays,
+ * and checks the frames adpcm_dma_wait_complete_vblank() counted against
+ * the ones the DMA should have taken for the ADPCM that was loaded. It
+ * exits with 2 if they differ, so a timing regression fails a script.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+#include "types.h"
+#include "MSM6258.h"
+#include "mdfx68k.h"
+
+// 31kHz, 512x512
+#define X68K_FRAME_RATE	55.458
+
+// main.c's main(), built as this
+int x68k_main();
+// mdfourier.c
+extern int adcpm_dma_frames;
+extern int video_count;
+
+static void usage()
+{
+	fprintf(stderr, "usage: mdfx68k [-b synth|none] [-r rate] [-o out.wav] [-e] [-d dir]\n");
+}
+
+static double now()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+int main(int argc, char **argv)
+{
+	const mdf_backend *backend = &synth_backend;
+	const char *wav_path = NULL, *dir = NULL;
+	int i, rate = 48000, input = 1, expected = 0, status = 0;
+	double begin, seconds;
+	long frames;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if ( (strcmp(argv[i], "-b") == 0) && (i + 1 < argc) )
+		{
+			i++;
+			if (strcmp(argv[i], "synth") == 0)
+				backend = &synth_backend;
+			else if (strcmp(argv[i], "none") == 0)
+				backend = NULL;
+			else
+			{
+				usage();
+				return 1;
+			}
+		}
+		else if ( (strcmp(argv[i], "-r") == 0) && (i + 1 < argc) )
+			rate = atoi(argv[++i]);
+		else if ( (strcmp(argv[i], "-o") == 0) && (i + 1 < argc) )
+			wav_path = argv[++i];
+		else if (strcmp(argv[i], "-e") == 0)
+			input = -1;
+		else if ( (strcmp(argv[i], "-d") == 0) && (i + 1 < argc) )
+			dir = argv[++i];
+		else
+		{
+			usage();
+			return 1;
+		}
+	}
+	if ( (i != argc) || ((rate != 44100) && (rate != 48000)) || (wav_path && !backend) )
+	{
+		usage();
+		return 1;
+	}
+
+	// the WAV is opened where it was asked for, before moving to sweep.pcm
+	if (backend && synth_open(wav_path, rate, X68K_FRAME_RATE))
+		return 1;
+	if (dir && chdir(dir))
+	{
+		fprintf(stderr, "%s: could not change to it\n", dir);
+		return 1;
+	}
+
+	mdf_host_init(backend, X68K_FRAME_RATE, input);
+	begin = now();
+	x68k_main();
+	frames = mdf_host_frames();
+	if (backend && synth_close(frames))
+		status = 1;
+	seconds = now() - begin;
+
+	if (!mdf_host_dma.mtc)
+	{
+		fprintf(stderr, "mdfx68k: the sequence did not run\n");
+		return 1;
+	}
+
+	// the DMA ends on the first vblank after the MSM6258 took the last
+	// byte, at 8MHz/512 as Prepare_ADPCM_DMA() sets it
+	expected = (int)ceil(mdf_host_dma.mtc*2.0/15625*X68K_FRAME_RATE);
+	printf("\n%s: %.2fs of audio in %.2fs (%.0fx), %ld frames, %d counted by the sequence\n",
+		backend ? backend->name : "none", frames/X68K_FRAME_RATE, seconds,
+		seconds > 0 ? frames/X68K_FRAME_RATE/seconds : 0.0, frames, video_count);
+	printf("ADPCM DMA: %d frames counted, %d for %d bytes\n", adcpm_dma_frames, expected, mdf_host_dma.mtc);
+	if (adcpm_dma_frames != expected)
+	{
+		fprintf(stderr, "mdfx68k: adpcm_dma_wait_complete_vblank() is off by %d frames\n", adcpm_dma_frames - expected);
+		status = 2;
+	}
+	return status;
+}
@@ -0,0 +1,35 @@
+/*
+ * 240p Test Suite
+ * The X68000 MDFourier CLI on a PC
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+#ifndef MDFX68K_H
+#define MDFX68K_H
+
+#include "mdfhost.h"
+
+// synth.c, the YM2151 and MSM6258 in software, written to a WAV as the
+// frames come. path can be NULL to only render.
+extern const mdf_backend synth_backend;
+int synth_open(const char *path, int rate, double frame_rate);
+// the output up to the last frame, returns 0 if it was all written
+int synth_close(long frames);
+
+#endif
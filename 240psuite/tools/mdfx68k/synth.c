@@ -0,0 +1,219 @@
+/*
+ * 240p Test Suite
+ * YM2151 and MSM6258 backend for the X68000 MDFourier CLI
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+
+/*
+ * The YM2151 is mdfsynth's model at 4MHz/64, the MSM6258 the decoder from
+ * tools/adpcm at whatever rate the host layer gives. Each one goes
+ * through its own resampler into the same buffer, and what both have
+ * reached is written out after every frame, so memory stays at a few
+ * frames however long the run is. The ADPCM is mixed at half scale, as
+ * on the console it is well under the FM.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mdfsynth.h"
+#include "adpcm.h"
+#include "mdfx68k.h"
+
+#define YM2151_CLOCK	4000000
+#define ADPCM_GAIN		0.5f
+
+static fm_chip_t			ym2151;
+static const adpcm_chip_t	*msm6258 = NULL;
+static adpcm_state_t		adpcm_state;
+
+static resampler_t	*fm_rs = NULL, *adpcm_rs = NULL;
+static int			adpcm_rate = 0;
+static double		fm_time = 0, frame_rate = 0;
+static int			out_rate = 0;
+
+static float		*out = NULL;
+static long			out_size = 0, fm_pos = 0, adpcm_pos = 0;
+
+static FILE			*wav = NULL;
+static const char	*wav_path = NULL;
+static long			wav_count = 0;
+static int			clipped = 0;
+
+static void put32(unsigned char *p, unsigned int v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+	p[2] = (v >> 16) & 0xFF;
+	p[3] = (v >> 24) & 0xFF;
+}
+
+static void wav_header(unsigned char *header, long count)
+{
+	memcpy(header, "RIFF", 4);
+	put32(header + 4, (unsigned int)(36 + count*4));
+	memcpy(header + 8, "WAVEfmt ", 8);
+	put32(header + 16, 16);
+	header[20] = 1; header[21] = 0;
+	header[22] = 2; header[23] = 0;
+	put32(header + 24, out_rate);
+	put32(header + 28, out_rate*4);
+	header[32] = 4; header[33] = 0;
+	header[34] = 16; header[35] = 0;
+	memcpy(header + 36, "data", 4);
+	put32(header + 40, (unsigned int)(count*4));
+}
+
+// writes the first count output samples and moves the rest down
+static void flush(long count)
+{
+	if (count <= 0)
+		return;
+	if (wav)
+	{
+		for (long i = 0; i < count*2; i++)
+		{
+			long v = lrintf(out[i]*32768.0f);
+			if ( (v > 32767) || (v < -32768) )
+			{
+				v = (v > 0) ? 32767 : -32768;
+				clipped++;
+			}
+			fputc(v & 0xFF, wav);
+			fputc((v >> 8) & 0xFF, wav);
+		}
+	}
+	wav_count += count;
+	memmove(out, out + count*2, sizeof(float)*(out_size - count)*2);
+	memset(out + (out_size - count)*2, 0, sizeof(float)*count*2);
+	fm_pos -= count;
+	adpcm_pos -= count;
+}
+
+static void synth_ym2151(unsigned char reg, unsigned char data)
+{
+	fm_write(&ym2151, 0, reg, data);
+}
+
+static void synth_frame(const unsigned char *adpcm, long nibble, int nibbles, int samples, int rate)
+{
+	int left, right, count;
+
+	count = (int)((long)(fm_time + ym2151.rate/frame_rate) - (long)fm_time);
+	fm_time += ym2151.rate/frame_rate;
+	for (int i = 0; i < count; i++)
+	{
+		fm_clock(&ym2151, &left, &right);
+		resampler_push(fm_rs, left/32768.0f, right/32768.0f, &out, &out_size, &fm_pos);
+	}
+
+	// the divider only changes between runs, a new one starts where the last stopped
+	if (rate != adpcm_rate)
+	{
+		resampler_free(adpcm_rs);
+		adpcm_rs = resampler_new(rate, out_rate);
+		adpcm_rate = rate;
+	}
+	for (int i = 0; i < samples; i++)
+	{
+		float value = 0;
+
+		if (adpcm && (i < nibbles))
+		{
+			long n = nibble + i;
+			int shift = ((n & 1) == !msm6258->high_first) ? 4 : 0;
+			bool clamp;
+
+			if (!n)
+				adpcm_reset(&adpcm_state);
+			int signal = adpcm_decode_nibble(msm6258, &adpcm_state, (adpcm[n >> 1] >> shift) & 0x0F, &clamp);
+			value = adpcm_output(msm6258, signal)/32768.0f*ADPCM_GAIN;
+		}
+		resampler_push(adpcm_rs, value, value, &out, &out_size, &adpcm_pos);
+	}
+
+	flush(fm_pos < adpcm_pos ? fm_pos : adpcm_pos);
+}
+
+const mdf_backend synth_backend = { "synth", synth_ym2151, synth_frame };
+
+int synth_open(const char *path, int rate, double vblank_rate)
+{
+	unsigned char header[44];
+
+	fm_init(&ym2151, FM_YM2151, YM2151_CLOCK);
+	msm6258 = adpcm_chip_find("x68k");
+	adpcm_reset(&adpcm_state);
+	out_rate = rate;
+	frame_rate = vblank_rate;
+	fm_rs = resampler_new(ym2151.rate, rate);
+	if (!msm6258 || !fm_rs)
+		return -1;
+
+	wav_path = path;
+	if (path)
+	{
+		wav = fopen(path, "wb");
+		if (!wav)
+		{
+			fprintf(stderr, "%s: could not create\n", path);
+			return -1;
+		}
+		wav_header(header, 0);
+		fwrite(header, 1, sizeof(header), wav);
+	}
+	return 0;
+}
+
+int synth_close(long frames)
+{
+	long target = (long)(frames*out_rate/frame_rate);
+	unsigned char header[44];
+	int status = 0;
+
+	// the resamplers are half a kernel behind, push silence through them
+	while ( (wav_count + fm_pos < target) || (adpcm_rs && (wav_count + adpcm_pos < target)) )
+	{
+		if (wav_count + fm_pos < target)
+			resampler_push(fm_rs, 0, 0, &out, &out_size, &fm_pos);
+		if (adpcm_rs && (wav_count + adpcm_pos < target))
+			resampler_push(adpcm_rs, 0, 0, &out, &out_size, &adpcm_pos);
+	}
+	if (target > wav_count)
+		flush(target - wav_count);
+
+	if (wav)
+	{
+		wav_header(header, wav_count);
+		fseek(wav, 0, SEEK_SET);
+		fwrite(header, 1, sizeof(header), wav);
+		if (fclose(wav))
+		{
+			fprintf(stderr, "%s: could not write\n", wav_path);
+			status = -1;
+		}
+		if (clipped)
+			fprintf(stderr, "%s: %d samples clipped\n", wav_path, clipped);
+	}
+	resampler_free(fm_rs);
+	resampler_free(adpcm_rs);
+	free(out);
+	return status;
+}
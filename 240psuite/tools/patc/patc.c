@@ -0,0 +1,459 @@
+/*
+ * 240p Test Suite
+ * Pattern description language compiler
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * Compiles .pat files into C tables for one console:
+ *
+ *	patc -t saturn [-o out.c] file.pat...
+ *		resolution independent op tables, walked by pattern_table.c and
+ *		declared in pattern_table.h
+ *	patc -t quads -r 320x240 [-o out.h] file.pat...
+ *		quad lists for the 3D consoles (Dreamcast, Wii, N64). Hidden
+ *		quads are dropped and everything is clipped to the screen
+ *	patc -t snes|pce|neogeo -r 256x224 [-b base] [-o out.h] file.pat...
+ *		4bpp tiles, deduplicated, and a tilemap in that console's format.
+ *		base is added to the tile numbers
+ *	patc -p NAME -r 320x240 -o out.pgm file.pat...
+ *		preview, the color index times 16 as gray
+ *
+ * A .pat file holds patterns:
+ *
+ *	pattern ebu
+ *	  for i 0 8
+ *	    rect W*i/8 0 W*(i+1)/8 H i+1
+ *	  end
+ *	end
+ *
+ * Statements are rect, line, dots (with x and y steps), gradient (two
+ * colors, h or v), text and for loops. Coordinates are W or H times a
+ * fraction plus pixels, computed the way the hand-written C does it,
+ * (W*a)/b+c. Colors are palette indices, 0-15 for the 4bpp targets
+ * and 0-255 for quads and previews. Expressions have no spaces and
+ * follow C: + - * / % comparisons and ?:.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "patc.h"
+
+typedef enum {
+	TARGET_NONE,
+	TARGET_SATURN,
+	TARGET_QUADS,
+	TARGET_SNES,
+	TARGET_PCE,
+	TARGET_NEOGEO,
+} target_t;
+
+static void usage()
+{
+	printf("patc -t saturn [-o out.c] file.pat...\n");
+	printf("patc -t quads -r WxH [-o out.h] file.pat...\n");
+	printf("patc -t snes|pce|neogeo -r WxH [-b base] [-o out.h] file.pat...\n");
+	printf("patc -p pattern -r WxH -o out.pgm file.pat...\n");
+}
+
+static void emit_header(FILE *out, int argc, char **argv, int first_file)
+{
+	fprintf(out, "// generated by patc from");
+	for (int i = first_file; i < argc; i++)
+		fprintf(out, " %s", argv[i]);
+	fprintf(out, ", do not edit\n\n");
+}
+
+static void emit_text(FILE *out, const char *text)
+{
+	fputc('"', out);
+	for (const char *p = text; *p; p++)
+	{
+		if ( (*p == '"') || (*p == '\\') )
+			fputc('\\', out);
+		fputc(*p, out);
+	}
+	fputc('"', out);
+}
+
+//---------------------------------------------- saturn ---------------------------------------------------
+static const char *saturn_size(int size)
+{
+	return (size == PATC_SIZE_W) ? "PATTERN_TABLE_SIZE_W" : (size == PATC_SIZE_H) ? "PATTERN_TABLE_SIZE_H" : "PATTERN_TABLE_SIZE_PIXELS";
+}
+
+static void saturn_coord(FILE *out, const patc_coord_t *coord)
+{
+	fprintf(out, "{%s,%d,%d,%d}", saturn_size(coord->size), coord->num, coord->den, coord->add);
+}
+
+static void emit_saturn(FILE *out, const patc_program_t *program)
+{
+	static const char *types[] = { "PATTERN_TABLE_END", "PATTERN_TABLE_RECT", "PATTERN_TABLE_LINE",
+								   "PATTERN_TABLE_DOTS", "PATTERN_TABLE_GRADIENT", "PATTERN_TABLE_TEXT" };
+	fprintf(out, "#include <stdlib.h>\n#include <stdbool.h>\n#include <yaul.h>\n#include \"video.h\"\n#include \"pattern_table.h\"\n\n");
+	for (int p = 0; p < program->pattern_count; p++)
+	{
+		const patc_pattern_t *pattern = &program->patterns[p];
+		fprintf(out, "const pattern_table_op_t pattern_table_%s[] = {\n", pattern->name);
+		for (int i = 0; i < pattern->count; i++)
+		{
+			const patc_op_t *op = &program->ops[pattern->first + i];
+			fprintf(out, "\t{ %s, %d, %d, %d, %d, %d, ", types[op->type], op->color, op->color2,
+					op->step_x, op->step_y, op->flags);
+			saturn_coord(out, &op->x0);
+			fprintf(out, ", ");
+			saturn_coord(out, &op->y0);
+			fprintf(out, ", ");
+			saturn_coord(out, &op->x1);
+			fprintf(out, ", ");
+			saturn_coord(out, &op->y1);
+			fprintf(out, ", ");
+			if (op->type == PATC_OP_TEXT)
+				emit_text(out, op->text);
+			else
+				fprintf(out, "NULL");
+			fprintf(out, " },\n");
+		}
+		fprintf(out, "\t{ PATTERN_TABLE_END },\n};\n\n");
+	}
+}
+
+//---------------------------------------------- quads ----------------------------------------------------
+typedef struct {
+	int type;
+	int x0, y0, x1, y1;
+	int color, color2;
+	int step_x, step_y;
+	const char *text;
+} patc_quad_t;
+
+static bool quad_opaque(const patc_quad_t *q)
+{
+	return (q->type == PATC_OP_RECT) || (q->type == PATC_OP_GRADIENT);
+}
+
+static bool quad_covers(const patc_quad_t *outer, const patc_quad_t *inner)
+{
+	return quad_opaque(outer) && (inner->type != PATC_OP_TEXT) &&
+		   (outer->x0 <= inner->x0) && (outer->y0 <= inner->y0) &&
+		   (outer->x1 >= inner->x1) && (outer->y1 >= inner->y1);
+}
+
+static int min_int(int a, int b) { return (a < b) ? a : b; }
+static int max_int(int a, int b) { return (a > b) ? a : b; }
+
+static void emit_quads(FILE *out, const patc_program_t *program, int width, int height)
+{
+	static const char *types[] = { "PATC_QUAD_END", "PATC_QUAD_RECT", "PATC_QUAD_LINE",
+								   "PATC_QUAD_DOTS", "PATC_QUAD_GRADIENT", "PATC_QUAD_TEXT" };
+	fprintf(out, "#ifndef PATC_QUAD_DEFINED\n#define PATC_QUAD_DEFINED\n");
+	fprintf(out, "enum { PATC_QUAD_END, PATC_QUAD_RECT, PATC_QUAD_LINE, PATC_QUAD_DOTS, PATC_QUAD_GRADIENT, PATC_QUAD_TEXT };\n\n");
+	fprintf(out, "// rect and dots are x0 <= x < x1, lines include both ends. A gradient\n");
+	fprintf(out, "// goes from color to color2, vertically if step_y is 1\n");
+	fprintf(out, "typedef struct {\n\tunsigned char type, color, color2, step_x, step_y;\n");
+	fprintf(out, "\tshort x0, y0, x1, y1;\n\tconst char *text;\n} patc_quad_t;\n#endif\n\n");
+
+	patc_quad_t *quads = malloc(PATC_MAX_OPS * sizeof(patc_quad_t));
+	for (int p = 0; p < program->pattern_count; p++)
+	{
+		const patc_pattern_t *pattern = &program->patterns[p];
+		int count = 0;
+		for (int i = 0; i < pattern->count; i++)
+		{
+			const patc_op_t *op = &program->ops[pattern->first + i];
+			patc_quad_t *q = &quads[count];
+			q->type = op->type;
+			q->x0 = patc_coord_eval(&op->x0, width, height);
+			q->y0 = patc_coord_eval(&op->y0, width, height);
+			q->x1 = patc_coord_eval(&op->x1, width, height);
+			q->y1 = patc_coord_eval(&op->y1, width, height);
+			q->color = op->color;
+			q->color2 = op->color2;
+			q->step_x = op->step_x;
+			q->step_y = (op->type == PATC_OP_GRADIENT) ? (op->flags & 1) : op->step_y;
+			q->text = op->text;
+			if ( (op->type == PATC_OP_RECT) || (op->type == PATC_OP_DOTS) )
+			{
+				//dots keep their phase, so only the far edges are clipped for them
+				if (op->type == PATC_OP_RECT)
+				{
+					q->x0 = max_int(q->x0, 0);
+					q->y0 = max_int(q->y0, 0);
+				}
+				q->x1 = min_int(q->x1, width);
+				q->y1 = min_int(q->y1, height);
+				if ( (q->x0 >= q->x1) || (q->y0 >= q->y1) )
+					continue;
+			}
+			count++;
+		}
+
+		//a quad that a later opaque one covers completely is never seen
+		fprintf(out, "static const patc_quad_t pattern_quads_%s[] = {\n", pattern->name);
+		int kept = 0;
+		for (int i = 0; i < count; i++)
+		{
+			bool hidden = false;
+			for (int j = i + 1; j < count && !hidden; j++)
+				hidden = quad_covers(&quads[j], &quads[i]);
+			if (hidden)
+				continue;
+			patc_quad_t *q = &quads[i];
+			fprintf(out, "\t{ %s, %d, %d, %d, %d, %d, %d, %d, %d, ", types[q->type], q->color, q->color2,
+					q->step_x, q->step_y, q->x0, q->y0, q->x1, q->y1);
+			if (q->type == PATC_OP_TEXT)
+				emit_text(out, q->text);
+			else
+				fprintf(out, "0");
+			fprintf(out, " },\n");
+			kept++;
+		}
+		fprintf(out, "\t{ PATC_QUAD_END },\n};\n");
+		fprintf(out, "// %d of %d operations drawn at %dx%d\n\n", kept, pattern->count, width, height);
+	}
+	free(quads);
+}
+
+//---------------------------------------------- tiles ----------------------------------------------------
+#define TILE_BYTES 32
+
+//planar 4bpp, 8 rows of planes 0/1 then 8 rows of planes 2/3. SNES and PCE share it
+static void tile_encode_planar(const uint8_t *pixels, int pitch, uint8_t *tile)
+{
+	memset(tile, 0x00, TILE_BYTES);
+	for (int y = 0; y < 8; y++)
+		for (int x = 0; x < 8; x++)
+		{
+			int c = pixels[y*pitch + x] & 0xF;
+			int bit = 0x80 >> x;
+			if (c & 1) tile[y*2] |= bit;
+			if (c & 2) tile[y*2 + 1] |= bit;
+			if (c & 4) tile[16 + y*2] |= bit;
+			if (c & 8) tile[16 + y*2 + 1] |= bit;
+		}
+}
+
+//fix layer: column pairs 4-5, 6-7, 0-1, 2-3, 8 rows each, left pixel in the low nibble
+static void tile_encode_neogeo_fix(const uint8_t *pixels, int pitch, uint8_t *tile)
+{
+	static const int pair_x[4] = { 4, 6, 0, 2 };
+	for (int pair = 0; pair < 4; pair++)
+		for (int y = 0; y < 8; y++)
+		{
+			int x = pair_x[pair];
+			tile[pair*8 + y] = (pixels[y*pitch + x] & 0xF) | ((pixels[y*pitch + x + 1] & 0xF) << 4);
+		}
+}
+
+//the palette bits are left at 0, the console code picks the palette
+static uint16_t map_entry(target_t target, int tile)
+{
+	switch (target)
+	{
+		case TARGET_SNES:
+			return tile & 0x3FF;
+		default:
+			return tile & 0xFFF;
+	}
+}
+
+static int emit_tiles(FILE *out, const patc_program_t *program, target_t target, int width, int height, int base)
+{
+	static const char *names[] = { "", "", "", "snes", "pce", "neogeo" };
+	int map_w = (width + 7)/8, map_h = (height + 7)/8;
+	int pitch = map_w*8;
+	uint8_t *pixels = malloc(pitch*map_h*8);
+	uint8_t *tiles = malloc(map_w*map_h*TILE_BYTES);
+	uint16_t *map = malloc(map_w*map_h*sizeof(uint16_t));
+
+	for (int p = 0; p < program->pattern_count; p++)
+	{
+		const patc_pattern_t *pattern = &program->patterns[p];
+		memset(pixels, 0x00, pitch*map_h*8);
+		patc_raster(program, pattern, pixels, pitch, map_h*8);
+
+		int tile_count = 0;
+		for (int ty = 0; ty < map_h; ty++)
+			for (int tx = 0; tx < map_w; tx++)
+			{
+				const uint8_t *src = &pixels[ty*8*pitch + tx*8];
+				uint8_t tile[TILE_BYTES];
+				if (target == TARGET_NEOGEO)
+					tile_encode_neogeo_fix(src, pitch, tile);
+				else
+					tile_encode_planar(src, pitch, tile);
+
+				int index;
+				for (index = 0; index < tile_count; index++)
+					if (memcmp(&tiles[index*TILE_BYTES], tile, TILE_BYTES) == 0)
+						break;
+				if (index == tile_count)
+					memcpy(&tiles[tile_count++*TILE_BYTES], tile, TILE_BYTES);
+				map[ty*map_w + tx] = map_entry(target, base + index);
+			}
+
+		fprintf(out, "// %s, %dx%d: %d unique tiles for %d map entries\n", names[target], width, height,
+				tile_count, map_w*map_h);
+		fprintf(out, "#define PATTERN_MAP_%s_WIDTH %d\n#define PATTERN_MAP_%s_HEIGHT %d\n#define PATTERN_TILES_%s_COUNT %d\n",
+				pattern->name, map_w, pattern->name, map_h, pattern->name, tile_count);
+		fprintf(out, "static const unsigned char pattern_tiles_%s[] = {", pattern->name);
+		for (int i = 0; i < tile_count*TILE_BYTES; i++)
+			fprintf(out, "%s0x%02X,", (i % 16) ? " " : "\n\t", tiles[i]);
+		fprintf(out, "\n};\n");
+		fprintf(out, "static const unsigned short pattern_map_%s[] = {", pattern->name);
+		for (int i = 0; i < map_w*map_h; i++)
+			fprintf(out, "%s0x%04X,", (i % map_w) ? " " : "\n\t", map[i]);
+		fprintf(out, "\n};\n");
+
+		//text is left to the console's own font routines
+		for (int i = 0; i < pattern->count; i++)
+		{
+			const patc_op_t *op = &program->ops[pattern->first + i];
+			if (op->type != PATC_OP_TEXT)
+				continue;
+			fprintf(out, "// text %d,%d color %d: ", patc_coord_eval(&op->x0, width, height),
+					patc_coord_eval(&op->y0, width, height), op->color);
+			emit_text(out, op->text);
+			fprintf(out, "\n");
+		}
+		fprintf(out, "\n");
+	}
+	free(pixels);
+	free(tiles);
+	free(map);
+	return 0;
+}
+
+//---------------------------------------------- preview -------------------------------------------------
+static int write_preview(const patc_program_t *program, const char *name, int width, int height, const char *path)
+{
+	const patc_pattern_t *pattern = NULL;
+	for (int i = 0; i < program->pattern_count; i++)
+		if (strcmp(program->patterns[i].name, name) == 0)
+			pattern = &program->patterns[i];
+	if (!pattern)
+	{
+		fprintf(stderr, "no pattern called %s\n", name);
+		return -1;
+	}
+	uint8_t *pixels = calloc(width, height);
+	patc_raster(program, pattern, pixels, width, height);
+	FILE *f = fopen(path, "wb");
+	if (!f)
+	{
+		fprintf(stderr, "%s: could not write\n", path);
+		free(pixels);
+		return -1;
+	}
+	fprintf(f, "P5\n%d %d\n255\n", width, height);
+	for (int i = 0; i < width*height; i++)
+		fputc((pixels[i]*16) & 0xFF, f);
+	fclose(f);
+	free(pixels);
+	return 0;
+}
+
+//---------------------------------------------- main -----------------------------------------------------
+int main(int argc, char **argv)
+{
+	target_t target = TARGET_NONE;
+	const char *output = NULL, *preview = NULL;
+	int width = 0, height = 0, base = 0;
+	int i;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if ( (strcmp(argv[i], "-t") == 0) && (i + 1 < argc) )
+		{
+			const char *t = argv[++i];
+			target = (strcmp(t, "saturn") == 0) ? TARGET_SATURN : (strcmp(t, "quads") == 0) ? TARGET_QUADS :
+					 (strcmp(t, "snes") == 0) ? TARGET_SNES : (strcmp(t, "pce") == 0) ? TARGET_PCE :
+					 (strcmp(t, "neogeo") == 0) ? TARGET_NEOGEO : TARGET_NONE;
+			if (TARGET_NONE == target)
+			{
+				usage();
+				return 2;
+			}
+		}
+		else if ( (strcmp(argv[i], "-r") == 0) && (i + 1 < argc) )
+		{
+			if ( (sscanf(argv[++i], "%dx%d", &width, &height) != 2) || (width < 1) || (height < 1) || (width > 4096) || (height > 4096) )
+			{
+				usage();
+				return 2;
+			}
+		}
+		else if ( (strcmp(argv[i], "-b") == 0) && (i + 1 < argc) )
+			base = (int)strtol(argv[++i], NULL, 0);
+		else if ( (strcmp(argv[i], "-o") == 0) && (i + 1 < argc) )
+			output = argv[++i];
+		else if ( (strcmp(argv[i], "-p") == 0) && (i + 1 < argc) )
+			preview = argv[++i];
+		else
+		{
+			usage();
+			return 2;
+		}
+	}
+	int first_file = i;
+	bool needs_res = (target != TARGET_SATURN) || preview;
+	if ( (first_file >= argc) || ( (TARGET_NONE == target) && !preview ) || (needs_res && !width) || (preview && !output) )
+	{
+		usage();
+		return 2;
+	}
+
+	//everything but quads and plain previews draws into 4bpp tiles or bitmaps
+	int colors = ( (TARGET_QUADS == target) || (TARGET_NONE == target) ) ? 256 : 16;
+	patc_program_t *program = calloc(1, sizeof(patc_program_t));
+	for (i = first_file; i < argc; i++)
+		if (patc_parse_file(argv[i], colors, program))
+			return 1;
+
+	if (preview)
+		return write_preview(program, preview, width, height, output) ? 1 : 0;
+
+	FILE *out = output ? fopen(output, "w") : stdout;
+	if (!out)
+	{
+		fprintf(stderr, "%s: could not write\n", output);
+		return 1;
+	}
+	emit_header(out, argc, argv, first_file);
+	int result = 0;
+	switch (target)
+	{
+		case TARGET_SATURN:
+			emit_saturn(out, program);
+			break;
+		case TARGET_QUADS:
+			emit_quads(out, program, width, height);
+			break;
+		default:
+			result = emit_tiles(out, program, target, width, height, base);
+			break;
+	}
+	if (output)
+		fclose(out);
+	if (result && output)
+		remove(output);
+	free(program);
+	return result ? 1 : 0;
+}
@@ -0,0 +1,67 @@
+#ifndef PATC_H
+#define PATC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PATC_MAX_OPS 4096
+#define PATC_MAX_PATTERNS 64
+#define PATC_MAX_NAME 32
+#define PATC_MAX_TEXT 64
+
+typedef enum {
+	PATC_OP_END = 0,
+	PATC_OP_RECT,		//fill x0 <= x < x1, y0 <= y < y1
+	PATC_OP_LINE,		//x0,y0 to x1,y1 inclusive
+	PATC_OP_DOTS,		//every step_x/step_y pixel of the rect
+	PATC_OP_GRADIENT,	//color to color2 across the rect, vertical if flags & 1
+	PATC_OP_TEXT		//text at x0,y0
+} patc_op_type_t;
+
+#define PATC_SIZE_NONE 0
+#define PATC_SIZE_W 1
+#define PATC_SIZE_H 2
+
+// A coordinate as the suites write them: size*num/den + add, with the
+// multiplication done first so it truncates like the hand-written C.
+typedef struct {
+	int size;
+	int num;
+	int den;
+	int add;
+} patc_coord_t;
+
+typedef struct {
+	patc_op_type_t type;
+	int color;
+	int color2;
+	int step_x;
+	int step_y;
+	int flags;
+	patc_coord_t x0, y0, x1, y1;
+	char text[PATC_MAX_TEXT];
+} patc_op_t;
+
+typedef struct {
+	char name[PATC_MAX_NAME];
+	int first;			//index into the op array
+	int count;
+} patc_pattern_t;
+
+typedef struct {
+	patc_op_t ops[PATC_MAX_OPS];
+	int op_count;
+	patc_pattern_t patterns[PATC_MAX_PATTERNS];
+	int pattern_count;
+} patc_program_t;
+
+// patc_parse.c. Colors must be below colors. Returns 0, or prints
+// file:line: message and returns -1.
+int patc_parse_file(const char *path, int colors, patc_program_t *program);
+
+// patc_raster.c, 8 bit color indices, one byte per pixel
+int patc_coord_eval(const patc_coord_t *coord, int width, int height);
+int patc_gradient_color(const patc_op_t *op, int position, int length);
+void patc_raster(const patc_program_t *program, const patc_pattern_t *pattern, uint8_t *pixels, int width, int height);
+
+#endif /* !PATC_H */
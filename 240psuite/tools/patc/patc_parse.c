@@ -0,0 +1,458 @@
+/*
+ * 240p Test Suite
+ * Pattern description language, parser
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "patc.h"
+
+#define MAX_LINES 4096
+#define MAX_LINE 256
+#define MAX_TOKENS 16
+#define MAX_VARS 8
+
+typedef struct {
+	char name[PATC_MAX_NAME];
+	int value;
+} var_t;
+
+typedef struct {
+	const char *path;
+	char lines[MAX_LINES][MAX_LINE];
+	int line_count;
+	int colors;
+	var_t vars[MAX_VARS];
+	int var_count;
+	patc_program_t *program;
+	int error_line;
+	char error[128];
+} parser_t;
+
+//---------------------------------------------- expressions ----------------------------------------------
+//C integer semantics, so a pattern written here truncates the way the suites do
+typedef struct {
+	parser_t *parser;
+	const char *p;
+	bool failed;
+} expr_t;
+
+static int expr_ternary(expr_t *e);
+
+static void expr_fail(expr_t *e, const char *message)
+{
+	if (!e->failed)
+		snprintf(e->parser->error, sizeof(e->parser->error), "%s", message);
+	e->failed = true;
+}
+
+static int expr_primary(expr_t *e)
+{
+	if (*e->p == '(')
+	{
+		e->p++;
+		int value = expr_ternary(e);
+		if (*e->p != ')')
+			expr_fail(e, "missing )");
+		else
+			e->p++;
+		return value;
+	}
+	if (*e->p == '-')
+	{
+		e->p++;
+		return -expr_primary(e);
+	}
+	if (isdigit((unsigned char)*e->p))
+		return (int)strtol(e->p, (char **)&e->p, 0);
+	if (isalpha((unsigned char)*e->p) || (*e->p == '_'))
+	{
+		char name[PATC_MAX_NAME];
+		int len = 0;
+		while ( (isalnum((unsigned char)*e->p) || (*e->p == '_')) && (len < PATC_MAX_NAME - 1) )
+			name[len++] = *e->p++;
+		name[len] = 0;
+		for (int i = e->parser->var_count - 1; i >= 0; i--)
+			if (strcmp(e->parser->vars[i].name, name) == 0)
+				return e->parser->vars[i].value;
+		expr_fail(e, "unknown name in expression");
+		return 0;
+	}
+	expr_fail(e, "bad expression");
+	return 0;
+}
+
+static int expr_product(expr_t *e)
+{
+	int value = expr_primary(e);
+	while ( (*e->p == '*') || (*e->p == '/') || (*e->p == '%') )
+	{
+		char op = *e->p++;
+		int rhs = expr_primary(e);
+		if ( (op != '*') && (0 == rhs) )
+		{
+			expr_fail(e, "division by zero");
+			return 0;
+		}
+		value = (op == '*') ? value * rhs : (op == '/') ? value / rhs : value % rhs;
+	}
+	return value;
+}
+
+static int expr_sum(expr_t *e)
+{
+	int value = expr_product(e);
+	while ( (*e->p == '+') || (*e->p == '-') )
+	{
+		char op = *e->p++;
+		int rhs = expr_product(e);
+		value = (op == '+') ? value + rhs : value - rhs;
+	}
+	return value;
+}
+
+static int expr_compare(expr_t *e)
+{
+	int value = expr_sum(e);
+	for (;;)
+	{
+		if (strncmp(e->p, "==", 2) == 0) { e->p += 2; value = (value == expr_sum(e)); }
+		else if (strncmp(e->p, "!=", 2) == 0) { e->p += 2; value = (value != expr_sum(e)); }
+		else if (strncmp(e->p, "<=", 2) == 0) { e->p += 2; value = (value <= expr_sum(e)); }
+		else if (strncmp(e->p, ">=", 2) == 0) { e->p += 2; value = (value >= expr_sum(e)); }
+		else if (*e->p == '<') { e->p++; value = (value < expr_sum(e)); }
+		else if (*e->p == '>') { e->p++; value = (value > expr_sum(e)); }
+		else return value;
+	}
+}
+
+static int expr_ternary(expr_t *e)
+{
+	int value = expr_compare(e);
+	if (*e->p != '?')
+		return value;
+	e->p++;
+	int a = expr_ternary(e);
+	if (*e->p != ':')
+	{
+		expr_fail(e, "missing : in ?:");
+		return 0;
+	}
+	e->p++;
+	int b = expr_ternary(e);
+	return value ? a : b;
+}
+
+static int eval(parser_t *parser, const char *text, bool *ok)
+{
+	expr_t e = { parser, text, false };
+	int value = expr_ternary(&e);
+	if (*e.p)
+		expr_fail(&e, "trailing characters in expression");
+	if (e.failed)
+		*ok = false;
+	return value;
+}
+
+// W*a*b/c+d or H*a/c-d, anything else is a plain pixel expression
+static patc_coord_t eval_coord(parser_t *parser, const char *text, bool *ok)
+{
+	patc_coord_t coord = { PATC_SIZE_NONE, 0, 1, 0 };
+	if ( ( (text[0] == 'W') || (text[0] == 'H') ) && !isalnum((unsigned char)text[1]) && (text[1] != '_') )
+	{
+		expr_t e = { parser, text + 1, false };
+		coord.size = (text[0] == 'W') ? PATC_SIZE_W : PATC_SIZE_H;
+		coord.num = 1;
+		while (*e.p == '*')
+		{
+			e.p++;
+			coord.num *= expr_primary(&e);
+		}
+		if (*e.p == '/')
+		{
+			e.p++;
+			coord.den = expr_primary(&e);
+			if (0 == coord.den)
+				expr_fail(&e, "division by zero");
+		}
+		if (*e.p == '+')
+		{
+			e.p++;
+			coord.add = expr_sum(&e);
+		}
+		else if (*e.p == '-')
+		{
+			//unary minus on the first term, so W-2+1 adds -1
+			coord.add = expr_sum(&e);
+		}
+		if (*e.p)
+			expr_fail(&e, "coordinates are W*a/b+c");
+		if (e.failed)
+			*ok = false;
+		return coord;
+	}
+	coord.add = eval(parser, text, ok);
+	return coord;
+}
+
+//---------------------------------------------- statements -----------------------------------------------
+static int tokenize(char *line, char **tokens)
+{
+	int count = 0;
+	char *p = line;
+	while (*p && (count < MAX_TOKENS))
+	{
+		while (isspace((unsigned char)*p))
+			p++;
+		if (!*p || (*p == '#'))
+			break;
+		if (*p == '"')
+		{
+			tokens[count++] = p;
+			p = strchr(p + 1, '"');
+			if (!p)
+				break;
+			p++;
+		}
+		else
+		{
+			tokens[count++] = p;
+			while (*p && !isspace((unsigned char)*p))
+				p++;
+		}
+		if (*p)
+			*p++ = 0;
+	}
+	return count;
+}
+
+static int find_end(parser_t *parser, int start, int stop)
+{
+	int depth = 0;
+	for (int i = start; i < stop; i++)
+	{
+		char buf[MAX_LINE];
+		char *tokens[MAX_TOKENS];
+		strcpy(buf, parser->lines[i]);
+		int n = tokenize(buf, tokens);
+		if (0 == n)
+			continue;
+		if ( (strcmp(tokens[0], "for") == 0) || (strcmp(tokens[0], "pattern") == 0) )
+			depth++;
+		else if (strcmp(tokens[0], "end") == 0)
+		{
+			if (0 == depth)
+				return i;
+			depth--;
+		}
+	}
+	return -1;
+}
+
+static int fail(parser_t *parser, int line, const char *message)
+{
+	parser->error_line = line;
+	if (message)
+		snprintf(parser->error, sizeof(parser->error), "%s", message);
+	return -1;
+}
+
+static const char *color_range(parser_t *parser)
+{
+	return (parser->colors > 16) ? "colors are 0-255" : "colors are 0-15 on 4bpp targets";
+}
+
+static int add_op(parser_t *parser, int line, patc_op_t *op)
+{
+	patc_program_t *program = parser->program;
+	if (program->op_count >= PATC_MAX_OPS - 1)
+		return fail(parser, line, "too many operations");
+	program->ops[program->op_count++] = *op;
+	return 0;
+}
+
+static int run_block(parser_t *parser, int start, int stop);
+
+static int run_statement(parser_t *parser, int *index, int stop)
+{
+	int line = *index;
+	char buf[MAX_LINE];
+	char *t[MAX_TOKENS];
+	strcpy(buf, parser->lines[line]);
+	int n = tokenize(buf, t);
+	(*index)++;
+	if (0 == n)
+		return 0;
+
+	bool ok = true;
+	patc_op_t op;
+	memset(&op, 0x00, sizeof(op));
+
+	if (strcmp(t[0], "for") == 0)
+	{
+		if (n != 4)
+			return fail(parser, line, "for VAR FROM TO");
+		int end = find_end(parser, line + 1, stop);
+		if (end < 0)
+			return fail(parser, line, "for without end");
+		int from = eval(parser, t[2], &ok);
+		int to = eval(parser, t[3], &ok);
+		if (!ok)
+			return fail(parser, line, NULL);
+		if (parser->var_count >= MAX_VARS)
+			return fail(parser, line, "loops nested too deep");
+		var_t *var = &parser->vars[parser->var_count++];
+		snprintf(var->name, sizeof(var->name), "%s", t[1]);
+		for (var->value = from; var->value < to; var->value++)
+			if (run_block(parser, line + 1, end))
+				return -1;
+		parser->var_count--;
+		*index = end + 1;
+		return 0;
+	}
+	else if ( (strcmp(t[0], "rect") == 0) || (strcmp(t[0], "line") == 0) )
+	{
+		if (n != 6)
+			return fail(parser, line, "rect|line X0 Y0 X1 Y1 COLOR");
+		op.type = (t[0][0] == 'r') ? PATC_OP_RECT : PATC_OP_LINE;
+	}
+	else if (strcmp(t[0], "dots") == 0)
+	{
+		if (n != 8)
+			return fail(parser, line, "dots X0 Y0 X1 Y1 STEPX STEPY COLOR");
+		op.type = PATC_OP_DOTS;
+		op.step_x = eval(parser, t[5], &ok);
+		op.step_y = eval(parser, t[6], &ok);
+		if (ok && ( (op.step_x < 1) || (op.step_y < 1) ) )
+			return fail(parser, line, "dot steps must be at least 1");
+		t[5] = t[7];
+	}
+	else if (strcmp(t[0], "gradient") == 0)
+	{
+		if ( (n != 7) && (n != 8) )
+			return fail(parser, line, "gradient X0 Y0 X1 Y1 COLOR COLOR2 [h|v]");
+		op.type = PATC_OP_GRADIENT;
+		op.color2 = eval(parser, t[6], &ok);
+		if ( (n == 8) && (strcmp(t[7], "v") == 0) )
+			op.flags = 1;
+		else if ( (n == 8) && (strcmp(t[7], "h") != 0) )
+			return fail(parser, line, "gradients are h or v");
+	}
+	else if (strcmp(t[0], "text") == 0)
+	{
+		size_t len = (n == 5) ? strlen(t[4]) : 0;
+		if ( (n != 5) || (len < 2) || (t[4][0] != '"') || (t[4][len-1] != '"') )
+			return fail(parser, line, "text X Y COLOR \"string\"");
+		if (len - 2 >= PATC_MAX_TEXT)
+			return fail(parser, line, "text too long");
+		op.type = PATC_OP_TEXT;
+		op.x0 = eval_coord(parser, t[1], &ok);
+		op.y0 = eval_coord(parser, t[2], &ok);
+		op.color = eval(parser, t[3], &ok);
+		memcpy(op.text, t[4] + 1, len - 2);
+		if (!ok)
+			return fail(parser, line, NULL);
+		if ( (op.color < 0) || (op.color >= parser->colors) )
+			return fail(parser, line, color_range(parser));
+		return add_op(parser, line, &op);
+	}
+	else
+		return fail(parser, line, "unknown statement");
+
+	op.x0 = eval_coord(parser, t[1], &ok);
+	op.y0 = eval_coord(parser, t[2], &ok);
+	op.x1 = eval_coord(parser, t[3], &ok);
+	op.y1 = eval_coord(parser, t[4], &ok);
+	op.color = eval(parser, t[5], &ok);
+	if (!ok)
+		return fail(parser, line, NULL);
+	if ( (op.color < 0) || (op.color >= parser->colors) || (op.color2 < 0) || (op.color2 >= parser->colors) )
+		return fail(parser, line, color_range(parser));
+	return add_op(parser, line, &op);
+}
+
+static int run_block(parser_t *parser, int start, int stop)
+{
+	int index = start;
+	while (index < stop)
+		if (run_statement(parser, &index, stop))
+			return -1;
+	return 0;
+}
+
+static int run_file(parser_t *parser)
+{
+	patc_program_t *program = parser->program;
+	int index = 0;
+	while (index < parser->line_count)
+	{
+		char buf[MAX_LINE];
+		char *t[MAX_TOKENS];
+		strcpy(buf, parser->lines[index]);
+		int n = tokenize(buf, t);
+		if (0 == n)
+		{
+			index++;
+			continue;
+		}
+		if ( (strcmp(t[0], "pattern") != 0) || (n != 2) )
+			return fail(parser, index, "expected pattern NAME");
+		int end = find_end(parser, index + 1, parser->line_count);
+		if (end < 0)
+			return fail(parser, index, "pattern without end");
+		if (program->pattern_count >= PATC_MAX_PATTERNS)
+			return fail(parser, index, "too many patterns");
+		for (int i = 0; i < program->pattern_count; i++)
+			if (strcmp(program->patterns[i].name, t[1]) == 0)
+				return fail(parser, index, "pattern defined twice");
+		patc_pattern_t *pattern = &program->patterns[program->pattern_count++];
+		snprintf(pattern->name, sizeof(pattern->name), "%s", t[1]);
+		pattern->first = program->op_count;
+		if (run_block(parser, index + 1, end))
+			return -1;
+		pattern->count = program->op_count - pattern->first;
+		index = end + 1;
+	}
+	return 0;
+}
+
+int patc_parse_file(const char *path, int colors, patc_program_t *program)
+{
+	FILE *f = fopen(path, "r");
+	if (!f)
+	{
+		fprintf(stderr, "%s: could not open\n", path);
+		return -1;
+	}
+	parser_t *parser = calloc(1, sizeof(parser_t));
+	parser->path = path;
+	parser->program = program;
+	parser->colors = colors;
+	while ( (parser->line_count < MAX_LINES) && fgets(parser->lines[parser->line_count], MAX_LINE, f) )
+		parser->line_count++;
+	fclose(f);
+
+	int result = run_file(parser);
+	if (result)
+		fprintf(stderr, "%s:%d: %s\n", path, parser->error_line + 1, parser->error);
+	free(parser);
+	return result;
+}
@@ -0,0 +1,113 @@
+/*
+ * 240p Test Suite
+ * Pattern description language, reference rasterizer
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * The tile backends are cut from this, and the on-console table walkers
+ * have to produce the same pixels. Text is left to each console's font.
+ */
+
+#include <stdlib.h>
+#include "patc.h"
+
+int patc_coord_eval(const patc_coord_t *coord, int width, int height)
+{
+	switch (coord->size)
+	{
+		case PATC_SIZE_W:
+			return width*coord->num/coord->den + coord->add;
+		case PATC_SIZE_H:
+			return height*coord->num/coord->den + coord->add;
+	}
+	return coord->add;
+}
+
+static void plot(uint8_t *pixels, int width, int height, int x, int y, int color)
+{
+	if ( (x >= 0) && (x < width) && (y >= 0) && (y < height) )
+		pixels[y*width + x] = color;
+}
+
+int patc_gradient_color(const patc_op_t *op, int position, int length)
+{
+	int steps = abs(op->color2 - op->color) + 1;
+	int index = (length > 0) ? position*steps/length : 0;
+	if (index >= steps)
+		index = steps - 1;
+	return (op->color2 >= op->color) ? op->color + index : op->color - index;
+}
+
+void patc_raster(const patc_program_t *program, const patc_pattern_t *pattern, uint8_t *pixels, int width, int height)
+{
+	for (int i = 0; i < pattern->count; i++)
+	{
+		const patc_op_t *op = &program->ops[pattern->first + i];
+		int x0 = patc_coord_eval(&op->x0, width, height);
+		int y0 = patc_coord_eval(&op->y0, width, height);
+		int x1 = patc_coord_eval(&op->x1, width, height);
+		int y1 = patc_coord_eval(&op->y1, width, height);
+
+		switch (op->type)
+		{
+			case PATC_OP_RECT:
+				for (int y = y0; y < y1; y++)
+					for (int x = x0; x < x1; x++)
+						plot(pixels, width, height, x, y, op->color);
+				break;
+			case PATC_OP_DOTS:
+				for (int y = y0; y < y1; y += op->step_y)
+					for (int x = x0; x < x1; x += op->step_x)
+						plot(pixels, width, height, x, y, op->color);
+				break;
+			case PATC_OP_GRADIENT:
+				for (int y = y0; y < y1; y++)
+					for (int x = x0; x < x1; x++)
+						plot(pixels, width, height, x, y, (op->flags & 1) ?
+							 patc_gradient_color(op, y - y0, y1 - y0) : patc_gradient_color(op, x - x0, x1 - x0));
+				break;
+			case PATC_OP_LINE:
+			{
+				int dx = abs(x1 - x0), sx = (x0 < x1) ? 1 : -1;
+				int dy = -abs(y1 - y0), sy = (y0 < y1) ? 1 : -1;
+				int err = dx + dy;
+				for (;;)
+				{
+					plot(pixels, width, height, x0, y0, op->color);
+					if ( (x0 == x1) && (y0 == y1) )
+						break;
+					int e2 = 2*err;
+					if (e2 >= dy)
+					{
+						err += dy;
+						x0 += sx;
+					}
+					if (e2 <= dx)
+					{
+						err += dx;
+						y0 += sy;
+					}
+				}
+				break;
+			}
+			default:
+				break;
+		}
+	}
+}
@@ -0,0 +1,360 @@
+/*
+ * 240p Test Suite
+ * Tile deduplication and tilemap generator
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+/*
+ * Cuts an indexed PNG into tiles for one console, keeps one copy of each
+ * tile and writes the tiles and a tilemap:
+ *
+ *	tilec -t target [-n name] [-b base] [-p palette] [-F] [-o out.h|out.s] [-B prefix] image.png
+ *
+ *	-b  added to every tile number, for tiles loaded after others
+ *	-p  added to every palette number
+ *	-F  no flip matching, even if the target map supports it
+ *	-o  C arrays, or dc.l/dc.w for .s files like Genesis res/
+ *	-B  raw prefix.pic and prefix.map files, as gfx2snes writes them
+ *
+ * The high bits of a color index above the target's depth pick the
+ * palette, all pixels of a tile must agree on it. Index 0 is transparent
+ * and fits any palette.
+ *
+ * Tiles are found again through a hash of their pixels. Where the map can
+ * flip tiles the H, V and HV flipped versions are looked up too, so a
+ * mirrored half of a pattern costs no tiles.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tilec.h"
+
+typedef struct {
+	int tile_count;			//unique tiles
+	uint8_t *pixels;		//tile_size*tile_size per unique tile
+	int *hash_slots;		//-1 or a unique tile
+	uint32_t *hashes;		//per unique tile
+	int hash_size;			//power of two
+	int map_w, map_h;
+	uint16_t *map;			//map_entry() per cell
+	uint16_t *tiles;		//tile number per cell, for maps that keep it in a word of its own
+	int flipped;			//map entries that use a flipped tile
+} tilec_result_t;
+
+static void usage()
+{
+	printf("tilec -t target [-n name] [-b base] [-p palette] [-F] [-o out.h|out.s] [-B prefix] image.png\n");
+	printf("targets:\n");
+	tilec_target_list();
+}
+
+static uint32_t tile_hash(const uint8_t *pixels, int size)
+{
+	uint32_t hash = 2166136261u;
+	for (int i = 0; i < size; i++)
+		hash = (hash ^ pixels[i]) * 16777619u;
+	return hash;
+}
+
+static void tile_flip(const uint8_t *src, uint8_t *dst, int n, int flip)
+{
+	for (int y = 0; y < n; y++)
+		for (int x = 0; x < n; x++)
+		{
+			int sx = (flip & TILEC_FLIP_H) ? n - 1 - x : x;
+			int sy = (flip & TILEC_FLIP_V) ? n - 1 - y : y;
+			dst[y*n + x] = src[sy*n + sx];
+		}
+}
+
+static int tile_find(const tilec_result_t *r, const uint8_t *pixels, int area, uint32_t hash)
+{
+	for (int slot = hash & (r->hash_size - 1); r->hash_slots[slot] >= 0; slot = (slot + 1) & (r->hash_size - 1))
+	{
+		int tile = r->hash_slots[slot];
+		if ( (r->hashes[tile] == hash) && (memcmp(&r->pixels[tile*area], pixels, area) == 0) )
+			return tile;
+	}
+	return -1;
+}
+
+static void tile_insert(tilec_result_t *r, int tile, uint32_t hash)
+{
+	int slot = hash & (r->hash_size - 1);
+	while (r->hash_slots[slot] >= 0)
+		slot = (slot + 1) & (r->hash_size - 1);
+	r->hash_slots[slot] = tile;
+	r->hashes[tile] = hash;
+}
+
+static int build(const tilec_image_t *image, const tilec_target_t *target, int base, int palette_base, int flips,
+				 tilec_result_t *r)
+{
+	int n = target->tile_size, area = n*n;
+	int mask = (1 << target->bpp) - 1;
+	r->map_w = (image->width + n - 1)/n;
+	r->map_h = (image->height + n - 1)/n;
+	int total = r->map_w*r->map_h;
+
+	r->tile_count = 0;
+	r->flipped = 0;
+	r->pixels = malloc((size_t)total*area);
+	r->hashes = malloc(total*sizeof(uint32_t));
+	r->map = malloc(total*sizeof(uint16_t));
+	r->tiles = malloc(total*sizeof(uint16_t));
+	for (r->hash_size = 16; r->hash_size < total*2; r->hash_size *= 2)
+		;
+	r->hash_slots = malloc(r->hash_size*sizeof(int));
+	memset(r->hash_slots, 0xFF, r->hash_size*sizeof(int));
+
+	uint8_t tile[256], flipped[256];
+	for (int ty = 0; ty < r->map_h; ty++)
+		for (int tx = 0; tx < r->map_w; tx++)
+		{
+			//cut the tile, anything past the image edge is color 0
+			int palette = -1;
+			for (int y = 0; y < n; y++)
+				for (int x = 0; x < n; x++)
+				{
+					int px = tx*n + x, py = ty*n + y;
+					int c = ( (px < image->width) && (py < image->height) ) ? image->pixels[py*image->width + px] : 0;
+					if (c)
+					{
+						if (palette < 0)
+							palette = c >> target->bpp;
+						else if ( (c >> target->bpp) != palette )
+						{
+							fprintf(stderr, "tile %d,%d uses colors from palettes %d and %d\n", tx, ty, palette, c >> target->bpp);
+							return -1;
+						}
+					}
+					tile[y*n + x] = c & mask;
+				}
+			if (palette < 0)
+				palette = 0;
+			palette += palette_base;
+			if (palette > target->max_palette)
+			{
+				fprintf(stderr, "tile %d,%d: palette %d, %s has %d\n", tx, ty, palette, target->name, target->max_palette + 1);
+				return -1;
+			}
+
+			int found = -1, flip;
+			for (flip = 0; flip < 4; flip++)
+			{
+				if ( flip & ~flips )
+					continue;
+				//flips undo themselves, the stored tile flipped by flip is this one
+				tile_flip(tile, flipped, n, flip);
+				found = tile_find(r, flipped, area, tile_hash(flipped, area));
+				if (found >= 0)
+					break;
+			}
+			if (found < 0)
+			{
+				flip = 0;
+				found = r->tile_count++;
+				memcpy(&r->pixels[found*area], tile, area);
+				tile_insert(r, found, tile_hash(tile, area));
+			}
+			else if (flip)
+				r->flipped++;
+
+			if (base + found > target->max_tile)
+			{
+				fprintf(stderr, "tile %d,%d: tile number %d, %s maps go to %d\n", tx, ty, base + found, target->name, target->max_tile);
+				return -1;
+			}
+			r->map[ty*r->map_w + tx] = target->map_entry(base + found, palette, flip);
+			r->tiles[ty*r->map_w + tx] = base + found;
+		}
+	return 0;
+}
+
+static uint8_t *encode_tiles(const tilec_target_t *target, const tilec_result_t *r)
+{
+	int area = target->tile_size*target->tile_size;
+	uint8_t *data = malloc((size_t)r->tile_count*target->tile_bytes);
+	for (int i = 0; i < r->tile_count; i++)
+		target->encode(&r->pixels[i*area], &data[i*target->tile_bytes]);
+	return data;
+}
+
+//Neo Geo sprite maps are written a column (one sprite) at a time as tile, attribute pairs
+static uint16_t *map_words(const tilec_target_t *target, const tilec_result_t *r, int *count)
+{
+	int cells = r->map_w*r->map_h;
+	bool pairs = (target->tile_size == 16);
+	uint16_t *words = malloc(cells*2*sizeof(uint16_t));
+	*count = pairs ? cells*2 : cells;
+	if (!pairs)
+	{
+		memcpy(words, r->map, cells*sizeof(uint16_t));
+		return words;
+	}
+	for (int column = 0, i = 0; column < r->map_w; column++)
+		for (int row = 0; row < r->map_h; row++)
+		{
+			words[i++] = r->tiles[row*r->map_w + column];
+			words[i++] = r->map[row*r->map_w + column];
+		}
+	return words;
+}
+
+static int write_c(FILE *out, const char *name, const tilec_target_t *target, const tilec_result_t *r,
+				   const uint8_t *data, const uint16_t *words, int word_count)
+{
+	fprintf(out, "// generated by tilec, %s: %d unique tiles for %d map entries, %d flipped\n\n",
+			target->name, r->tile_count, r->map_w*r->map_h, r->flipped);
+	fprintf(out, "#define %s_TILE_COUNT %d\n#define %s_MAP_WIDTH %d\n#define %s_MAP_HEIGHT %d\n\n",
+			name, r->tile_count, name, r->map_w, name, r->map_h);
+	fprintf(out, "const unsigned char %s_tiles[%d] = {", name, r->tile_count*target->tile_bytes);
+	for (int i = 0; i < r->tile_count*target->tile_bytes; i++)
+		fprintf(out, "%s0x%02X,", (i % 16) ? " " : "\n\t", data[i]);
+	fprintf(out, "\n};\n\nconst unsigned short %s_map[%d] = {", name, word_count);
+	for (int i = 0; i < word_count; i++)
+		fprintf(out, "%s0x%04X,", (i % 8) ? " " : "\n\t", words[i]);
+	fprintf(out, "\n};\n");
+	return 0;
+}
+
+static int write_asm(FILE *out, const char *name, const tilec_target_t *target, const tilec_result_t *r,
+					 const uint8_t *data, const uint16_t *words, int word_count)
+{
+	int size = r->tile_count*target->tile_bytes;
+	fprintf(out, "* ---------------------------\n.global %s_tiles\n%s_tiles:\n* ---------------------------\n", name, name);
+	fprintf(out, "* size:%d bytes, %d unique tiles, %d flipped\n\n", size, r->tile_count, r->flipped);
+	for (int i = 0; i < size; i += 4)
+	{
+		if ((i % target->tile_bytes) == 0)
+			fprintf(out, "\n* ---------------------------\n");
+		fprintf(out, "\tdc.l 0x%02x%02x%02x%02x\n", data[i], data[i + 1], data[i + 2], data[i + 3]);
+	}
+	fprintf(out, "\n* ---------------------------\n.global %s_map\n%s_map:\n* ---------------------------\n", name, name);
+	fprintf(out, "* size:%d bytes\n\n", word_count*2);
+	for (int i = 0; i < word_count; i++)
+		fprintf(out, "\tdc.w 0x%04x\n", words[i]);
+	return 0;
+}
+
+static int write_binary(const char *prefix, const tilec_target_t *target, const tilec_result_t *r,
+						const uint8_t *data, const uint16_t *words, int word_count)
+{
+	char path[1024];
+	snprintf(path, sizeof(path), "%s.pic", prefix);
+	FILE *f = fopen(path, "wb");
+	if (!f)
+	{
+		fprintf(stderr, "%s: could not write\n", path);
+		return -1;
+	}
+	fwrite(data, target->tile_bytes, r->tile_count, f);
+	fclose(f);
+
+	//maps are little endian for the SNES and PCE, big endian for the 68000 consoles
+	bool big_endian = (strcmp(target->name, "genesis") == 0) || (strncmp(target->name, "neogeo", 6) == 0);
+	snprintf(path, sizeof(path), "%s.map", prefix);
+	f = fopen(path, "wb");
+	if (!f)
+	{
+		fprintf(stderr, "%s: could not write\n", path);
+		return -1;
+	}
+	for (int i = 0; i < word_count; i++)
+	{
+		fputc(big_endian ? words[i] >> 8 : words[i] & 0xFF, f);
+		fputc(big_endian ? words[i] & 0xFF : words[i] >> 8, f);
+	}
+	fclose(f);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const tilec_target_t *target = NULL;
+	const char *name = "image", *output = NULL, *binary = NULL;
+	int base = 0, palette_base = 0;
+	bool no_flips = false;
+	int i;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if ( (strcmp(argv[i], "-t") == 0) && (i + 1 < argc) )
+			target = tilec_target_find(argv[++i]);
+		else if ( (strcmp(argv[i], "-n") == 0) && (i + 1 < argc) )
+			name = argv[++i];
+		else if ( (strcmp(argv[i], "-b") == 0) && (i + 1 < argc) )
+			base = (int)strtol(argv[++i], NULL, 0);
+		else if ( (strcmp(argv[i], "-p") == 0) && (i + 1 < argc) )
+			palette_base = (int)strtol(argv[++i], NULL, 0);
+		else if ( (strcmp(argv[i], "-o") == 0) && (i + 1 < argc) )
+			output = argv[++i];
+		else if ( (strcmp(argv[i], "-B") == 0) && (i + 1 < argc) )
+			binary = argv[++i];
+		else if (strcmp(argv[i], "-F") == 0)
+			no_flips = true;
+		else
+		{
+			usage();
+			return 2;
+		}
+	}
+	if ( (i != argc - 1) || !target )
+	{
+		usage();
+		return 2;
+	}
+
+	tilec_image_t image;
+	if (tilec_png_load(argv[i], &image))
+		return 1;
+
+	tilec_result_t result;
+	if (build(&image, target, base, palette_base, no_flips ? 0 : target->flips, &result))
+		return 1;
+
+	uint8_t *data = encode_tiles(target, &result);
+	int word_count;
+	uint16_t *words = map_words(target, &result, &word_count);
+
+	fprintf(stderr, "%s: %d tiles, %d unique, %d matched flipped, %d bytes of tiles\n", argv[i],
+			result.map_w*result.map_h, result.tile_count, result.flipped, result.tile_count*target->tile_bytes);
+
+	int status = 0;
+	if (output)
+	{
+		FILE *out = fopen(output, "w");
+		if (!out)
+		{
+			fprintf(stderr, "%s: could not write\n", output);
+			return 1;
+		}
+		size_t len = strlen(output);
+		if ( (len > 2) && (strcmp(output + len - 2, ".s") == 0) )
+			status = write_asm(out, name, target, &result, data, words, word_count);
+		else
+			status = write_c(out, name, target, &result, data, words, word_count);
+		fclose(out);
+	}
+	if (binary && !status)
+		status = write_binary(binary, target, &result, data, words, word_count);
+	if (!output && !binary)
+		status = write_c(stdout, name, target, &result, data, words, word_count);
+	return status ? 1 : 0;
+}
@@ -0,0 +1,38 @@
+#ifndef TILEC_H
+#define TILEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// An 8 bit indexed image, one byte per pixel
+typedef struct {
+	int width;
+	int height;
+	uint8_t *pixels;
+} tilec_image_t;
+
+// tilec_png.c. Indexed and grayscale PNGs keep their indices, RGB(A)
+// has none and is refused. Returns 0, or prints the reason and returns -1.
+int tilec_png_load(const char *path, tilec_image_t *image);
+
+#define TILEC_FLIP_H 1
+#define TILEC_FLIP_V 2
+
+typedef struct {
+	const char *name;
+	int bpp;
+	int tile_size;		//8, or 16 for Neo Geo sprites
+	int tile_bytes;
+	int flips;			//TILEC_FLIP_H|TILEC_FLIP_V if the map can flip tiles
+	int max_tile;
+	int max_palette;
+	// tile pixels are tile_size*tile_size bytes, already reduced to bpp bits
+	void (*encode)(const uint8_t *pixels, uint8_t *out);
+	uint16_t (*map_entry)(int tile, int palette, int flip);
+} tilec_target_t;
+
+// tilec_format.c
+const tilec_target_t *tilec_target_find(const char *name);
+void tilec_target_list();
+
+#endif /* !TILEC_H */
@@ -0,0 +1,128 @@
+/*
+ * 240p Test Suite
+ * Tile and tilemap formats for the tile based consoles
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "tilec.h"
+
+//---------------------------------------------- tiles ----------------------------------------------------
+//SNES and PCE: bitplane pairs, 8 rows of planes 0/1, then 8 rows of planes 2/3 and so on
+static void encode_planar(const uint8_t *pixels, uint8_t *out, int bpp)
+{
+	memset(out, 0x00, bpp*8);
+	for (int y = 0; y < 8; y++)
+		for (int x = 0; x < 8; x++)
+		{
+			int c = pixels[y*8 + x];
+			for (int plane = 0; plane < bpp; plane++)
+				if (c & (1 << plane))
+					out[(plane/2)*16 + y*2 + (plane & 1)] |= 0x80 >> x;
+		}
+}
+
+static void encode_planar2(const uint8_t *pixels, uint8_t *out) { encode_planar(pixels, out, 2); }
+static void encode_planar4(const uint8_t *pixels, uint8_t *out) { encode_planar(pixels, out, 4); }
+static void encode_planar8(const uint8_t *pixels, uint8_t *out) { encode_planar(pixels, out, 8); }
+
+//Genesis: packed 4bpp, left pixel in the high nibble
+static void encode_genesis(const uint8_t *pixels, uint8_t *out)
+{
+	for (int i = 0; i < 32; i++)
+		out[i] = (pixels[i*2] << 4) | pixels[i*2 + 1];
+}
+
+//Neo Geo fix layer: column pairs 4-5, 6-7, 0-1, 2-3, 8 rows each, left pixel in the low nibble
+static void encode_neogeo_fix(const uint8_t *pixels, uint8_t *out)
+{
+	static const int pair_x[4] = { 4, 6, 0, 2 };
+	for (int pair = 0; pair < 4; pair++)
+		for (int y = 0; y < 8; y++)
+			out[pair*8 + y] = pixels[y*8 + pair_x[pair]] | (pixels[y*8 + pair_x[pair] + 1] << 4);
+}
+
+//Neo Geo sprites: 16x16 as four 8x8 blocks, top right, bottom right, top left,
+//bottom left. Each row is planes 0 to 3 with the left pixel in bit 0. The C1
+//ROM gets bytes 0-1 of every 4, C2 gets bytes 2-3.
+static void encode_neogeo_sprite(const uint8_t *pixels, uint8_t *out)
+{
+	static const int block_x[4] = { 8, 8, 0, 0 };
+	static const int block_y[4] = { 0, 8, 0, 8 };
+	memset(out, 0x00, 128);
+	for (int block = 0; block < 4; block++)
+		for (int y = 0; y < 8; y++)
+			for (int x = 0; x < 8; x++)
+			{
+				int c = pixels[(block_y[block] + y)*16 + block_x[block] + x];
+				for (int plane = 0; plane < 4; plane++)
+					if (c & (1 << plane))
+						out[block*32 + y*4 + plane] |= 1 << x;
+			}
+}
+
+//---------------------------------------------- maps -----------------------------------------------------
+static uint16_t map_snes(int tile, int palette, int flip)
+{
+	return tile | (palette << 10) | ((flip & TILEC_FLIP_H) ? 0x4000 : 0) | ((flip & TILEC_FLIP_V) ? 0x8000 : 0);
+}
+
+static uint16_t map_genesis(int tile, int palette, int flip)
+{
+	return tile | ((flip & TILEC_FLIP_H) ? 0x0800 : 0) | ((flip & TILEC_FLIP_V) ? 0x1000 : 0) | (palette << 13);
+}
+
+//PCE BAT and Neo Geo fix map, no flipping on either
+static uint16_t map_nibble_palette(int tile, int palette, int flip)
+{
+	(void)flip;
+	return tile | (palette << 12);
+}
+
+//Neo Geo sprite maps are tile/attribute word pairs, this is the attribute
+static uint16_t map_neogeo_sprite(int tile, int palette, int flip)
+{
+	(void)tile;
+	return (palette << 8) | ((flip & TILEC_FLIP_V) ? 2 : 0) | ((flip & TILEC_FLIP_H) ? 1 : 0);
+}
+
+static const tilec_target_t targets[] = {
+	{ "snes2",     2,  8, 16,  TILEC_FLIP_H|TILEC_FLIP_V, 1023,  7,   encode_planar2,       map_snes },
+	{ "snes4",     4,  8, 32,  TILEC_FLIP_H|TILEC_FLIP_V, 1023,  7,   encode_planar4,       map_snes },
+	{ "snes8",     8,  8, 64,  TILEC_FLIP_H|TILEC_FLIP_V, 1023,  0,   encode_planar8,       map_snes },
+	{ "pce",       4,  8, 32,  0,                         4095,  15,  encode_planar4,       map_nibble_palette },
+	{ "genesis",   4,  8, 32,  TILEC_FLIP_H|TILEC_FLIP_V, 2047,  3,   encode_genesis,       map_genesis },
+	{ "neogeofix", 4,  8, 32,  0,                         4095,  15,  encode_neogeo_fix,    map_nibble_palette },
+	{ "neogeospr", 4, 16, 128, TILEC_FLIP_H|TILEC_FLIP_V, 65535, 255, encode_neogeo_sprite, map_neogeo_sprite },
+};
+
+const tilec_target_t *tilec_target_find(const char *name)
+{
+	for (unsigned int i = 0; i < sizeof(targets)/sizeof(targets[0]); i++)
+		if (strcmp(targets[i].name, name) == 0)
+			return &targets[i];
+	return NULL;
+}
+
+void tilec_target_list()
+{
+	for (unsigned int i = 0; i < sizeof(targets)/sizeof(targets[0]); i++)
+		printf("  %-10s %dbpp %dx%d tiles, %s\n", targets[i].name, targets[i].bpp, targets[i].tile_size,
+			   targets[i].tile_size, targets[i].flips ? "flipped tiles matched" : "no flips");
+}
@@ -0,0 +1,86 @@
+/*
+ * 240p Test Suite
+ * PNG reader for tilec
+ *
+ * This file is part of the 240p Test Suite
+ *
+ * The 240p Test Suite is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The 240p Test Suite is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 240p Test Suite; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA	02111-1307	USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <png.h>
+#include "tilec.h"
+
+int tilec_png_load(const char *path, tilec_image_t *image)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f)
+	{
+		fprintf(stderr, "Could not open %s\n", path);
+		return -1;
+	}
+	png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	png_infop info = png_create_info_struct(png);
+	png_bytep *rows = NULL;
+	image->pixels = NULL;
+	if (setjmp(png_jmpbuf(png)))
+	{
+		fprintf(stderr, "%s: not a readable PNG\n", path);
+		png_destroy_read_struct(&png, &info, NULL);
+		free(rows);
+		free(image->pixels);
+		fclose(f);
+		return -1;
+	}
+	png_init_io(png, f);
+	png_read_info(png, info);
+
+	//the color index picks the palette, so it has to come from the file
+	int color_type = png_get_color_type(png, info);
+	int depth = png_get_bit_depth(png, info);
+	if ( (color_type != PNG_COLOR_TYPE_PALETTE) && (color_type != PNG_COLOR_TYPE_GRAY) )
+	{
+		fprintf(stderr, "%s: no color indices, save it as an indexed PNG\n", path);
+		png_destroy_read_struct(&png, &info, NULL);
+		fclose(f);
+		return -1;
+	}
+	if (depth > 8)
+	{
+		fprintf(stderr, "%s: 16 bit gray, save it as an indexed PNG\n", path);
+		png_destroy_read_struct(&png, &info, NULL);
+		fclose(f);
+		return -1;
+	}
+	if (depth < 8)
+		png_set_packing(png);
+	png_set_interlace_handling(png);
+	png_read_update_info(png, info);
+
+	image->width = png_get_image_width(png, info);
+	image->height = png_get_image_height(png, info);
+	image->pixels = malloc((size_t)image->width*image->height);
+	rows = malloc(image->height*sizeof(png_bytep));
+	for (int y = 0; y < image->height; y++)
+		rows[y] = &image->pixels[y*image->width];
+	png_read_image(png, rows);
+
+	free(rows);
+	png_destroy_read_struct(&png, &info, NULL);
+	fclose(f);
+	return 0;
+}